@@ -0,0 +1,190 @@
+/*
+ * arena.c – string arena for the repo collection
+ *
+ * A run keeps a few strings per repo: its path, its branch and, after a
+ * failed fetch, an error message. Held in fixed buffers inside Repo they cost
+ * kilobytes per repo whatever their length; here they are bump-allocated from
+ * large chunks instead, at their length plus one. Branch names are interned:
+ * a tree of 100k repos has a few dozen distinct ones ("main", "master",
+ * "develop", ...), so each is stored once and rows share the pointer.
+ *
+ * arena_reset() rewinds the arena without giving its chunks back, so watch
+ * mode reuses the same memory tick after tick. Strings live until then.
+ *
+ * Safe from any thread: Phase 1 workers intern branches and Phase 2 tasks
+ * store error messages concurrently. A short mutex is plenty for that rate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "gitools.h"
+
+#define ARENA_CHUNK (64 * 1024)
+
+typedef struct Chunk {
+    struct Chunk *next;
+    size_t        cap, used;
+    char          data[];
+} Chunk;
+
+struct StrArena {
+    pthread_mutex_t lock;       /* guards everything below */
+    Chunk          *head;       /* being filled; the rest are full or spare */
+    Chunk          *spare;      /* rewound by arena_reset, for reuse */
+    const char    **table;      /* interned strings, open addressing */
+    size_t          tcap, tcount;
+};
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+StrArena *arena_new(void) {
+    StrArena *a = calloc(1, sizeof(*a));
+    if (!a) oom();
+    pthread_mutex_init(&a->lock, NULL);
+    return a;
+}
+
+static void chunks_free(Chunk *c) {
+    while (c) {
+        Chunk *next = c->next;
+        free(c);
+        c = next;
+    }
+}
+
+void arena_free(StrArena *a) {
+    if (!a) return;
+    chunks_free(a->head);
+    chunks_free(a->spare);
+    free(a->table);
+    pthread_mutex_destroy(&a->lock);
+    free(a);
+}
+
+/* Forget every string; keep the chunks (oversized ones excepted) and the
+ * table's size for the next round. */
+void arena_reset(StrArena *a) {
+    if (!a) return;
+    pthread_mutex_lock(&a->lock);
+    while (a->head) {
+        Chunk *c = a->head;
+        a->head = c->next;
+        if (c->cap != ARENA_CHUNK) {
+            free(c);
+            continue;
+        }
+        c->used = 0;
+        c->next = a->spare;
+        a->spare = c;
+    }
+    if (a->table) memset(a->table, 0, a->tcap * sizeof(*a->table));
+    a->tcount = 0;
+    pthread_mutex_unlock(&a->lock);
+}
+
+/* n bytes. Called with a->lock held. */
+static char *arena_alloc(StrArena *a, size_t n) {
+    Chunk *c = a->head;
+    if (c && c->cap - c->used >= n) {
+        char *p = c->data + c->used;
+        c->used += n;
+        return p;
+    }
+    if (n > ARENA_CHUNK / 4) {              /* a big one: its own chunk, behind head */
+        c = malloc(sizeof(*c) + n);
+        if (!c) oom();
+        c->cap = c->used = n;
+        if (a->head) {
+            c->next = a->head->next;
+            a->head->next = c;
+        } else {
+            c->next = NULL;
+            a->head = c;
+        }
+        return c->data;
+    }
+    if (a->spare) {
+        c = a->spare;
+        a->spare = c->next;
+    } else {
+        c = malloc(sizeof(*c) + ARENA_CHUNK);
+        if (!c) oom();
+        c->cap = ARENA_CHUNK;
+    }
+    c->used = n;
+    c->next = a->head;
+    a->head = c;
+    return c->data;
+}
+
+char *arena_strdup(StrArena *a, const char *s) {
+    size_t n = strlen(s) + 1;
+    pthread_mutex_lock(&a->lock);
+    char *p = arena_alloc(a, n);
+    pthread_mutex_unlock(&a->lock);
+    memcpy(p, s, n);
+    return p;
+}
+
+static uint64_t str_hash(const char *s) {
+    uint64_t h = 1469598103934665603ULL;        /* FNV-1a */
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/* Double the table. Called with a->lock held. */
+static void table_grow(StrArena *a) {
+    size_t cap = a->tcap ? a->tcap * 2 : 64;
+    const char **t = calloc(cap, sizeof(*t));
+    if (!t) oom();
+    for (size_t i = 0; i < a->tcap; i++) {
+        if (!a->table[i]) continue;
+        size_t k = str_hash(a->table[i]) & (cap - 1);
+        while (t[k]) k = (k + 1) & (cap - 1);
+        t[k] = a->table[i];
+    }
+    free(a->table);
+    a->table = t;
+    a->tcap  = cap;
+}
+
+/* The one copy of s in this arena, added if new. */
+const char *arena_intern(StrArena *a, const char *s) {
+    uint64_t h = str_hash(s);
+    pthread_mutex_lock(&a->lock);
+    if (2 * (a->tcount + 1) > a->tcap) table_grow(a);
+    size_t k = h & (a->tcap - 1);
+    while (a->table[k] && strcmp(a->table[k], s) != 0)
+        k = (k + 1) & (a->tcap - 1);
+    if (!a->table[k]) {
+        size_t n = strlen(s) + 1;
+        char *p = arena_alloc(a, n);
+        memcpy(p, s, n);
+        a->table[k] = p;
+        a->tcount++;
+    }
+    const char *p = a->table[k];
+    pthread_mutex_unlock(&a->lock);
+    return p;
+}
+
+/* Bytes held: chunks, spare ones included, and the intern table. */
+size_t arena_footprint(StrArena *a) {
+    if (!a) return 0;
+    pthread_mutex_lock(&a->lock);
+    size_t n = sizeof(*a) + a->tcap * sizeof(*a->table);
+    for (const Chunk *c = a->head; c; c = c->next)  n += sizeof(*c) + c->cap;
+    for (const Chunk *c = a->spare; c; c = c->next) n += sizeof(*c) + c->cap;
+    pthread_mutex_unlock(&a->lock);
+    return n;
+}
@@ -0,0 +1,479 @@
+/*
+ * cache.c – persistent per-repo state under the user cache directory
+ *
+ * Lives in $XDG_CACHE_HOME/gitls (default ~/.cache/gitls). Nothing in here is
+ * required for correctness: a missing, unreadable or corrupt cache only costs
+ * the optimisation it feeds.
+ *
+ * timings – how long each repo took in Phase 1 (local status) and Phase 2
+ * (fetch/pull) on previous runs, as an exponential moving average. Used to
+ * start the slowest repos first. One line per repo:
+ *
+ *   <local_ms> <net_ms> <last_seen_unix> <path>
+ *
+ * with -1 for a phase that has never been measured. Entries not seen for
+ * TIMINGS_MAX_AGE are dropped on save.
+ *
+ * hosts – a circuit breaker per remote server. A fetch or probe that could
+ * not reach its host (no DNS answer, connection refused or timed out) counts
+ * one failure; anything that got an answer, even an error, resets the count.
+ * From host_fail_limit consecutive failures on, repos on that host are
+ * skipped as "host down" until host_cooldown has passed since the last
+ * failure; then one repo is let through to try it again, and the others on
+ * that host wait for its verdict. One line per host that has failed:
+ *
+ *   <consecutive_failures> <last_failure_unix> <host>
+ *
+ * widths – the BRANCH, SYNC and WHEN widths the rows of the last --progressive
+ * table of a directory needed, which become the column widths of the next one
+ * before any of its rows are known. One line per scanned directory, dropped
+ * like timings when not seen for TIMINGS_MAX_AGE:
+ *
+ *   <branch> <sync> <when> <last_seen_unix> <dir>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pwd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gitools.h"
+
+#define TIMINGS_MAX_AGE (90L * 24 * 3600)
+
+/* Resolve (and with create, mkdir -p) the cache directory. */
+bool cache_dir(char *out, size_t n, bool create) {
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    int m;
+    if (xdg && xdg[0] == '/') {
+        m = snprintf(out, n, "%s/gitls", xdg);
+    } else {
+        const char *home = getenv("HOME");
+        if (!home || home[0] != '/') {
+            struct passwd *pw = getpwuid(getuid());
+            if (!pw) return false;
+            home = pw->pw_dir;
+        }
+        m = snprintf(out, n, "%s/.cache/gitls", home);
+    }
+    if (m <= 0 || m >= (int)n) return false;
+    if (!create) return true;
+
+    /* mkdir -p, one component at a time */
+    for (char *p = out + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        int rc = mkdir(out, 0700);
+        *p = '/';
+        if (rc != 0 && errno != EEXIST) return false;
+    }
+    return mkdir(out, 0700) == 0 || errno == EEXIST;
+}
+
+/* ── timings ───────────────────────────────────────────────────────────────── */
+typedef struct {
+    char   *path;
+    long    ms[TIMING_PHASES];
+    time_t  seen;
+} TimingEnt;
+
+static TimingEnt *g_tim       = NULL;    /* sorted by path once loaded */
+static size_t     g_tim_count = 0;
+static size_t     g_tim_cap   = 0;
+static size_t     g_tim_sorted = 0;      /* g_tim[0, sorted) is in path order */
+static bool       g_tim_loaded = false;
+static bool       g_tim_dirty  = false;
+
+static int tim_cmp(const void *a, const void *b) {
+    return strcmp(((const TimingEnt *)a)->path, ((const TimingEnt *)b)->path);
+}
+
+static void tim_resort(void);
+
+static TimingEnt *tim_find(const char *path) {
+    if (g_tim_count - g_tim_sorted >= 256) tim_resort();   /* bound the linear tail */
+    TimingEnt key = { .path = (char *)path };
+    TimingEnt *e = g_tim_sorted
+                 ? bsearch(&key, g_tim, g_tim_sorted, sizeof(*g_tim), tim_cmp) : NULL;
+    if (e) return e;
+    for (size_t i = g_tim_sorted; i < g_tim_count; i++)   /* added this run */
+        if (strcmp(g_tim[i].path, path) == 0) return &g_tim[i];
+    return NULL;
+}
+
+static TimingEnt *tim_add(const char *path) {
+    if (g_tim_count >= g_tim_cap) {
+        size_t cap = g_tim_cap ? g_tim_cap * 2 : 64;
+        TimingEnt *tmp = realloc(g_tim, cap * sizeof(*tmp));
+        if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        g_tim = tmp;
+        g_tim_cap = cap;
+    }
+    TimingEnt *e = &g_tim[g_tim_count];
+    e->path = strdup(path);
+    if (!e->path) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    for (int p = 0; p < TIMING_PHASES; p++) e->ms[p] = -1;
+    e->seen = 0;
+    g_tim_count++;
+    return e;
+}
+
+static void tim_resort(void) {
+    qsort(g_tim, g_tim_count, sizeof(*g_tim), tim_cmp);
+    g_tim_sorted = g_tim_count;
+}
+
+static bool timings_file(char *out, size_t n, bool create) {
+    char dir[PATH_MAX];
+    if (!cache_dir(dir, sizeof(dir), create)) return false;
+    int m = snprintf(out, n, "%s/timings", dir);
+    return m > 0 && m < (int)n;
+}
+
+static void timings_load(void) {
+    if (g_tim_loaded) return;
+    g_tim_loaded = true;
+
+    char file[PATH_MAX];
+    if (!timings_file(file, sizeof(file), false)) return;
+    FILE *f = fopen(file, "r");
+    if (!f) return;
+
+    char line[PATH_MAX + 128];
+    while (fgets(line, sizeof(line), f)) {
+        size_t len = strlen(line);
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+            line[--len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+
+        long local, net;
+        long long seen;
+        int off = 0;
+        if (sscanf(line, "%ld %ld %lld %n", &local, &net, &seen, &off) != 3
+                || off == 0 || line[off] != '/')
+            continue;                           /* skip malformed lines */
+        if (tim_find(line + off)) continue;     /* duplicate: first wins */
+        TimingEnt *e = tim_add(line + off);
+        e->ms[TIMING_LOCAL] = local < 0 ? -1 : local;
+        e->ms[TIMING_NET]   = net   < 0 ? -1 : net;
+        e->seen = (time_t)seen;
+    }
+    fclose(f);
+    tim_resort();
+}
+
+long timings_get(const char *path, TimingPhase phase) {
+    timings_load();
+    TimingEnt *e = tim_find(path);
+    return e ? e->ms[phase] : -1;
+}
+
+/* Fold one measurement into the moving average (weight 1/2, so a repo that
+ * has grown is picked up within a couple of runs). */
+void timings_put(const char *path, TimingPhase phase, long ms) {
+    timings_load();
+    if (ms < 0) return;
+    TimingEnt *e = tim_find(path);
+    if (!e) e = tim_add(path);
+    e->ms[phase] = e->ms[phase] < 0 ? ms : (e->ms[phase] + ms) / 2;
+    e->seen = time(NULL);
+    g_tim_dirty = true;
+}
+
+/* Write the table back (atomically, via rename) if anything changed. */
+void timings_save(void) {
+    if (!g_tim_dirty) return;
+    char file[PATH_MAX], tmp[PATH_MAX];
+    if (!timings_file(file, sizeof(file), true)) return;
+    int m = snprintf(tmp, sizeof(tmp), "%s.%ld", file, (long)getpid());
+    if (m <= 0 || m >= (int)sizeof(tmp)) return;
+
+    FILE *f = fopen(tmp, "w");
+    if (!f) return;
+    tim_resort();
+    time_t now = time(NULL);
+    fprintf(f, "# gitls timings: <local_ms> <net_ms> <last_seen> <path>\n");
+    for (size_t i = 0; i < g_tim_count; i++) {
+        const TimingEnt *e = &g_tim[i];
+        if (now - e->seen > TIMINGS_MAX_AGE) continue;
+        fprintf(f, "%ld %ld %lld %s\n", e->ms[TIMING_LOCAL], e->ms[TIMING_NET],
+                (long long)e->seen, e->path);
+    }
+    if (fclose(f) != 0 || rename(tmp, file) != 0) {
+        unlink(tmp);
+        return;
+    }
+    g_tim_dirty = false;
+}
+
+void timings_free(void) {
+    for (size_t i = 0; i < g_tim_count; i++) free(g_tim[i].path);
+    free(g_tim);
+    g_tim = NULL;
+    g_tim_count = g_tim_cap = g_tim_sorted = 0;
+    g_tim_loaded = g_tim_dirty = false;
+}
+
+/* ── hosts ─────────────────────────────────────────────────────────────────── */
+typedef struct {
+    void (*resume)(void *);
+    void  *arg;
+} HostWaiter;
+
+typedef struct {
+    char       *host;
+    int         fails;      /* consecutive, 0 = reached last time */
+    time_t      last;       /* of the latest failure */
+    bool        trial;      /* a repo is trying the host again this run */
+    HostWaiter *waiters;    /* parked behind the trial */
+    size_t      nwait, capwait;
+} HostEnt;
+
+/* Queried and updated from the Phase 2 pool threads, hence the lock. */
+static pthread_mutex_t g_host_lock = PTHREAD_MUTEX_INITIALIZER;
+static HostEnt *g_hosts       = NULL;
+static size_t   g_host_count  = 0;
+static size_t   g_host_cap    = 0;
+static bool     g_host_loaded = false;
+static bool     g_host_dirty  = false;
+
+static HostEnt *host_find(const char *host) {
+    for (size_t i = 0; i < g_host_count; i++)
+        if (strcmp(g_hosts[i].host, host) == 0) return &g_hosts[i];
+    return NULL;
+}
+
+static HostEnt *host_add(const char *host) {
+    if (g_host_count >= g_host_cap) {
+        size_t cap = g_host_cap ? g_host_cap * 2 : 16;
+        HostEnt *tmp = realloc(g_hosts, cap * sizeof(*tmp));
+        if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        g_hosts = tmp;
+        g_host_cap = cap;
+    }
+    HostEnt *e = &g_hosts[g_host_count++];
+    e->host = strdup(host);
+    if (!e->host) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    e->fails   = 0;
+    e->last    = 0;
+    e->trial   = false;
+    e->waiters = NULL;
+    e->nwait   = e->capwait = 0;
+    return e;
+}
+
+static bool hosts_file(char *out, size_t n, bool create) {
+    char dir[PATH_MAX];
+    if (!cache_dir(dir, sizeof(dir), create)) return false;
+    int m = snprintf(out, n, "%s/hosts", dir);
+    return m > 0 && m < (int)n;
+}
+
+/* Called with g_host_lock held. */
+static void hosts_load(void) {
+    if (g_host_loaded) return;
+    g_host_loaded = true;
+
+    char file[PATH_MAX];
+    if (!hosts_file(file, sizeof(file), false)) return;
+    FILE *f = fopen(file, "r");
+    if (!f) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), f)) {
+        size_t len = strlen(line);
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+            line[--len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+
+        int fails;
+        long long last;
+        int off = 0;
+        if (sscanf(line, "%d %lld %n", &fails, &last, &off) != 2
+                || off == 0 || line[off] == '\0' || fails <= 0)
+            continue;                           /* skip malformed lines */
+        if (host_find(line + off)) continue;    /* duplicate: first wins */
+        HostEnt *e = host_add(line + off);
+        e->fails = fails;
+        e->last  = (time_t)last;
+    }
+    fclose(f);
+}
+
+/*
+ * May a fetch or probe go to host? HOST_SKIP while its breaker is open.
+ * After the cool-down the first caller gets through as the trial; callers
+ * after it get HOST_WAIT and resume(arg) is called once the trial has been
+ * reported, to ask again. As with objcache_acquire, the caller must not touch
+ * arg's state after a HOST_WAIT. "" (local) always goes.
+ */
+HostAdmit host_admit(const char *host, void (*resume)(void *), void *arg) {
+    if (!host[0] || opt_host_fail_limit <= 0) return HOST_GO;
+    pthread_mutex_lock(&g_host_lock);
+    hosts_load();
+    HostEnt *e = host_find(host);
+    HostAdmit a = HOST_GO;
+    if (e && e->fails >= opt_host_fail_limit) {
+        if (e->trial) {
+            if (e->nwait == e->capwait) {
+                size_t cap = e->capwait ? e->capwait * 2 : 8;
+                HostWaiter *tmp = realloc(e->waiters, cap * sizeof(*tmp));
+                if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+                e->waiters = tmp;
+                e->capwait = cap;
+            }
+            e->waiters[e->nwait++] = (HostWaiter){ resume, arg };
+            a = HOST_WAIT;
+        } else if (time(NULL) - e->last < opt_host_cooldown) {
+            a = HOST_SKIP;
+        } else {
+            e->trial = true;
+        }
+    }
+    pthread_mutex_unlock(&g_host_lock);
+    return a;
+}
+
+/* Record how an admitted fetch or probe fared against host, and wake
+ * whoever waited for the trial. */
+void host_report(const char *host, HostOutcome outcome) {
+    if (!host[0] || opt_host_fail_limit <= 0) return;
+    pthread_mutex_lock(&g_host_lock);
+    hosts_load();
+    HostEnt *e = host_find(host);
+    HostWaiter *w = NULL;
+    size_t      n = 0;
+    if (outcome == HOST_UNREACHABLE) {
+        if (!e) e = host_add(host);
+        e->fails++;
+        e->last  = time(NULL);
+        e->trial = false;
+        g_host_dirty = true;
+    } else if (e) {
+        if (outcome == HOST_REACHED && e->fails > 0) {
+            e->fails = 0;
+            g_host_dirty = true;
+        }
+        e->trial = false;                       /* untried: the next one may */
+    }
+    if (e && !e->trial) {
+        w = e->waiters;
+        n = e->nwait;
+        e->waiters = NULL;
+        e->nwait = e->capwait = 0;
+    }
+    pthread_mutex_unlock(&g_host_lock);
+    for (size_t i = 0; i < n; i++) w[i].resume(w[i].arg);
+    free(w);
+}
+
+/* Write the failing hosts back (atomically, via rename) if anything changed. */
+void hosts_save(void) {
+    if (!g_host_dirty) return;
+    char file[PATH_MAX], tmp[PATH_MAX];
+    if (!hosts_file(file, sizeof(file), true)) return;
+    int m = snprintf(tmp, sizeof(tmp), "%s.%ld", file, (long)getpid());
+    if (m <= 0 || m >= (int)sizeof(tmp)) return;
+
+    FILE *f = fopen(tmp, "w");
+    if (!f) return;
+    fprintf(f, "# gitls hosts: <consecutive_failures> <last_failure> <host>\n");
+    for (size_t i = 0; i < g_host_count; i++) {
+        const HostEnt *e = &g_hosts[i];
+        if (e->fails > 0)
+            fprintf(f, "%d %lld %s\n", e->fails, (long long)e->last, e->host);
+    }
+    if (fclose(f) != 0 || rename(tmp, file) != 0) {
+        unlink(tmp);
+        return;
+    }
+    g_host_dirty = false;
+}
+
+void hosts_free(void) {
+    for (size_t i = 0; i < g_host_count; i++) {
+        free(g_hosts[i].host);
+        free(g_hosts[i].waiters);
+    }
+    free(g_hosts);
+    g_hosts = NULL;
+    g_host_count = g_host_cap = 0;
+    g_host_loaded = g_host_dirty = false;
+}
+
+/* ── widths ────────────────────────────────────────────────────────────────── */
+static bool widths_file(char *out, size_t n, bool create) {
+    char dir[PATH_MAX];
+    if (!cache_dir(dir, sizeof(dir), create)) return false;
+    int m = snprintf(out, n, "%s/widths", dir);
+    return m > 0 && m < (int)n;
+}
+
+/* One line of the file; false if it is malformed. *off is where dir starts. */
+static bool widths_parse(const char *line, ColWidths *w, long long *seen, int *off) {
+    *off = 0;
+    return sscanf(line, "%d %d %d %lld %n", &w->branch, &w->sync, &w->time, seen, off) == 4
+        && *off > 0 && line[*off] == '/'
+        && w->branch > 0 && w->sync > 0 && w->time > 0;
+}
+
+/* The BRANCH, SYNC and WHEN widths last saved for dir; false if none are. */
+bool widths_get(const char *dir, ColWidths *w) {
+    char file[PATH_MAX];
+    if (!widths_file(file, sizeof(file), false)) return false;
+    FILE *f = fopen(file, "r");
+    if (!f) return false;
+
+    char line[PATH_MAX + 128];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        ColWidths e;
+        long long seen;
+        int off;
+        if (line[0] == '#' || !widths_parse(line, &e, &seen, &off)) continue;
+        if (strcmp(line + off, dir) != 0) continue;
+        w->branch = e.branch;
+        w->sync   = e.sync;
+        w->time   = e.time;
+        found = true;
+    }
+    fclose(f);
+    return found;
+}
+
+/* Record w's BRANCH, SYNC and WHEN widths for dir (atomically, via rename). */
+void widths_put(const char *dir, const ColWidths *w) {
+    char file[PATH_MAX], tmp[PATH_MAX];
+    if (!widths_file(file, sizeof(file), true)) return;
+    int m = snprintf(tmp, sizeof(tmp), "%s.%ld", file, (long)getpid());
+    if (m <= 0 || m >= (int)sizeof(tmp)) return;
+
+    FILE *out = fopen(tmp, "w");
+    if (!out) return;
+    time_t now = time(NULL);
+    fprintf(out, "# gitls widths: <branch> <sync> <when> <last_seen> <dir>\n");
+    fprintf(out, "%d %d %d %lld %s\n", w->branch, w->sync, w->time, (long long)now, dir);
+
+    FILE *in = fopen(file, "r");          /* keep every other directory's line */
+    if (in) {
+        char line[PATH_MAX + 128];
+        while (fgets(line, sizeof(line), in)) {
+            line[strcspn(line, "\r\n")] = '\0';
+            ColWidths e;
+            long long seen;
+            int off;
+            if (line[0] == '#' || !widths_parse(line, &e, &seen, &off)) continue;
+            if (strcmp(line + off, dir) == 0 || now - (time_t)seen > TIMINGS_MAX_AGE) continue;
+            fprintf(out, "%s\n", line);
+        }
+        fclose(in);
+    }
+    if (fclose(out) != 0 || rename(tmp, file) != 0)
+        unlink(tmp);
+}
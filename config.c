@@ -6,6 +6,20 @@
  *   default_dir=~/projects
  *   max_depth=3
  *   skip_dirs=build,dist,tmp
+ *   status_timeout=10
+ *   prefetch_depth=16
+ *   job_order=longest
+ *   jobs=4
+ *   net_jobs=32
+ *   host_jobs=4
+ *   max_age=10m
+ *   net_timeout=2m
+ *   net_retries=2
+ *   host_fail_limit=3
+ *   host_cooldown=10m
+ *   native_fetch=false
+ *   shared_cache=true
+ *   narrow_fetch=true
  *   no_color=true
  *
  * Set GITLS_CONFIG=/path/to/file to override the default ~/.gitlsrc path.
@@ -21,6 +35,27 @@
 
 #include "gitools.h"
 
+/* "90", "90s", "10m", "2h" or "1d" into seconds; false (out untouched) if
+ * malformed, negative or out of range. */
+bool parse_duration(const char *s, long *out) {
+    char *end;
+    errno = 0;
+    long v = strtol(s, &end, 10);
+    if (end == s || errno == ERANGE || v < 0) return false;
+    long unit = 1;
+    switch (*end) {
+        case '\0': case 's': break;
+        case 'm': unit = 60;    break;
+        case 'h': unit = 3600;  break;
+        case 'd': unit = 86400; break;
+        default:  return false;
+    }
+    if (*end != '\0' && end[1] != '\0') return false;
+    if (v > LONG_MAX / unit) return false;
+    *out = v * unit;
+    return true;
+}
+
 void load_config(void) {
     char path[PATH_MAX];
 
@@ -118,6 +153,71 @@ void load_config(void) {
             if (strcmp(val, "true") == 0 || strcmp(val, "1") == 0)
                 opt_dirty_only = true;
 
+        } else if (strcmp(key, "status_timeout") == 0) {
+            char *end;
+            errno = 0;
+            long st = strtol(val, &end, 10);
+            if (*end == '\0' && errno != ERANGE && st >= 0 && st <= INT_MAX)
+                opt_status_timeout = (int)st;
+
+        } else if (strcmp(key, "prefetch_depth") == 0) {
+            char *end;
+            errno = 0;
+            long pd = strtol(val, &end, 10);
+            if (*end == '\0' && errno != ERANGE && pd >= 0 && pd <= INT_MAX)
+                opt_prefetch_depth = (int)pd;
+
+        } else if (strcmp(key, "jobs") == 0 || strcmp(key, "net_jobs") == 0
+                || strcmp(key, "host_jobs") == 0) {
+            char *end;
+            errno = 0;
+            long j = strtol(val, &end, 10);
+            if (*end == '\0' && errno != ERANGE && j >= 0 && j <= MAX_JOBS) {
+                if      (key[0] == 'j') opt_jobs      = (int)j;
+                else if (key[0] == 'n') opt_net_jobs  = (int)j;
+                else                    opt_host_jobs = (int)j;
+            }
+
+        } else if (strcmp(key, "max_age") == 0) {
+            parse_duration(val, &opt_max_age);   /* invalid: keep the default */
+
+        } else if (strcmp(key, "net_timeout") == 0) {
+            parse_duration(val, &opt_net_timeout);
+
+        } else if (strcmp(key, "net_retries") == 0) {
+            char *end;
+            errno = 0;
+            long n = strtol(val, &end, 10);
+            if (*end == '\0' && errno != ERANGE && n >= 0 && n <= 10)
+                opt_net_retries = (int)n;
+
+        } else if (strcmp(key, "host_fail_limit") == 0) {
+            char *end;
+            errno = 0;
+            long n = strtol(val, &end, 10);
+            if (*end == '\0' && errno != ERANGE && n >= 0 && n <= 1000)
+                opt_host_fail_limit = (int)n;
+
+        } else if (strcmp(key, "host_cooldown") == 0) {
+            parse_duration(val, &opt_host_cooldown);
+
+        } else if (strcmp(key, "native_fetch") == 0) {
+            if      (strcmp(val, "false") == 0 || strcmp(val, "0") == 0) opt_native_fetch = false;
+            else if (strcmp(val, "true")  == 0 || strcmp(val, "1") == 0) opt_native_fetch = true;
+
+        } else if (strcmp(key, "shared_cache") == 0) {
+            if      (strcmp(val, "false") == 0 || strcmp(val, "0") == 0) opt_shared_cache = false;
+            else if (strcmp(val, "true")  == 0 || strcmp(val, "1") == 0) opt_shared_cache = true;
+
+        } else if (strcmp(key, "narrow_fetch") == 0) {
+            if      (strcmp(val, "false") == 0 || strcmp(val, "0") == 0) opt_narrow = false;
+            else if (strcmp(val, "true")  == 0 || strcmp(val, "1") == 0) opt_narrow = true;
+
+        } else if (strcmp(key, "job_order") == 0) {
+            if      (strcmp(val, "longest") == 0) opt_job_order = ORDER_LONGEST;
+            else if (strcmp(val, "scan")    == 0) opt_job_order = ORDER_SCAN;
+            else if (strcmp(val, "disk")    == 0) opt_job_order = ORDER_DISK;
+
         } else if (strcmp(key, "no_color") == 0) {
             if (strcmp(val, "true") == 0 || strcmp(val, "1") == 0)
                 opt_no_color = true;
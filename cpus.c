@@ -0,0 +1,91 @@
+/*
+ * cpus.c – how many CPUs this process may actually use
+ *
+ * _SC_NPROCESSORS_ONLN counts the host's CPUs, which overstates what a
+ * container or a taskset-pinned process gets. On Linux the answer is the
+ * smaller of the affinity mask and the cgroup v2 CPU quota (cpu.max, checked
+ * at every level of our cgroup up to the root). Elsewhere it falls back to
+ * sysconf.
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE           /* sched_getaffinity, CPU_COUNT */
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "gitools.h"
+
+#if defined(__linux__)
+/* CPUs granted by one cgroup's cpu.max ("max 100000" or "<quota> <period>"),
+ * rounded up; 0 when unlimited or unreadable. */
+static int cgroup_quota_at(const char *dir) {
+    char file[PATH_MAX];
+    int m = snprintf(file, sizeof(file), "/sys/fs/cgroup%s/cpu.max", dir);
+    if (m <= 0 || m >= (int)sizeof(file)) return 0;
+    FILE *f = fopen(file, "r");
+    if (!f) return 0;
+    char quota[32];
+    long period = 0;
+    int n = fscanf(f, "%31s %ld", quota, &period);
+    fclose(f);
+    if (n != 2 || period <= 0 || strcmp(quota, "max") == 0) return 0;
+    char *end;
+    long q = strtol(quota, &end, 10);
+    if (*end != '\0' || q <= 0) return 0;
+    long cpus = (q + period - 1) / period;
+    return cpus > INT_MAX ? INT_MAX : (int)cpus;
+}
+
+/* Tightest cpu.max along our cgroup v2 path; 0 if none applies. */
+static int cgroup_cpu_limit(void) {
+    FILE *f = fopen("/proc/self/cgroup", "r");
+    if (!f) return 0;
+    char line[PATH_MAX];
+    char path[PATH_MAX] = "";
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "0::", 3) != 0) continue;      /* v2 unified entry */
+        snprintf(path, sizeof(path), "%s", line + 3);
+        path[strcspn(path, "\n")] = '\0';
+        break;
+    }
+    fclose(f);
+    if (path[0] != '/') return 0;
+
+    int limit = 0;
+    for (;;) {
+        int q = cgroup_quota_at(strcmp(path, "/") == 0 ? "" : path);
+        if (q > 0 && (limit == 0 || q < limit)) limit = q;
+        char *slash = strrchr(path, '/');
+        if (!slash || slash == path) {
+            if (strcmp(path, "/") == 0) break;
+            path[1] = '\0';                              /* then the root */
+        } else {
+            *slash = '\0';
+        }
+    }
+    return limit;
+}
+#endif
+
+int available_cpus(void) {
+    int n = 0;
+#if defined(_SC_NPROCESSORS_ONLN)
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online > 0) n = online > INT_MAX ? INT_MAX : (int)online;
+#endif
+#if defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        int a = CPU_COUNT(&set);
+        if (a > 0 && (n == 0 || a < n)) n = a;
+    }
+    int q = cgroup_cpu_limit();
+    if (q > 0 && (n == 0 || q < n)) n = q;
+#endif
+    return n > 0 ? n : 4;
+}
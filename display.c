@@ -29,24 +29,15 @@ int term_width(void) {
 
 /* Truncate s to at most max_w display columns. For paths the tail is the most
  * useful part, so the front is dropped and replaced with a leading ellipsis.
- * Returns a pointer to a rotating static buffer. */
-const char *ellipsize(const char *s, int max_w) {
-    static char buf[PATH_MAX + 8];
+ * Written to buf (n bytes), which is returned. */
+const char *ellipsize(const char *s, int max_w, char *buf, size_t n) {
     int w = utf8_width(s);
     if (max_w < 2 || w <= max_w) {
-        snprintf(buf, sizeof(buf), "%s", s);
+        snprintf(buf, n, "%s", s);
         return buf;
     }
-    int drop = w - (max_w - 1);          /* reserve 1 column for the ellipsis */
-    const unsigned char *p = (const unsigned char *)s;
-    int skipped = 0;
-    while (*p && skipped < drop) {
-        int seqlen = *p < 0x80 ? 1 : *p < 0xE0 ? 2 : *p < 0xF0 ? 3 : 4;
-        for (int j = 1; j < seqlen; j++) if (p[j] == '\0') { seqlen = j; break; }
-        p += seqlen;
-        skipped++;
-    }
-    snprintf(buf, sizeof(buf), "\xe2\x80\xa6%s", (const char *)p);   /* … + tail */
+    const char *p = s + utf8_skip_width(s, w - (max_w - 1));   /* 1 column for … */
+    snprintf(buf, n, "\xe2\x80\xa6%s", p);                   /* … + tail */
     return buf;
 }
 
@@ -64,71 +55,36 @@ const char *EOL(void) {
 }
 
 /* ── Relative time ─────────────────────────────────────────────────────────── */
-const char *relative_time(git_time_t t) {
-    static char buf[64];
-    if (t == 0) { snprintf(buf, sizeof(buf), "no commits"); return buf; }
+/* "3 hours ago" for t, written to buf (n bytes; 32 is plenty) and returned. */
+const char *relative_time(git_time_t t, char *buf, size_t n) {
+    if (t == 0) { snprintf(buf, n, "no commits"); return buf; }
 
     int64_t diff = (int64_t)time(NULL) - (int64_t)t;
     if (diff < 0) diff = 0;
 
-    if (diff < 60)             snprintf(buf, sizeof(buf), "just now");
-    else if (diff < 3600)      snprintf(buf, sizeof(buf), "%lld min ago",    (long long)(diff/60));
-    else if (diff < 86400)     snprintf(buf, sizeof(buf), "%lld hour%s ago", (long long)(diff/3600),   diff/3600==1?  "":"s");
-    else if (diff < 2592000)   snprintf(buf, sizeof(buf), "%lld day%s ago",  (long long)(diff/86400),  diff/86400==1? "":"s");
-    else if (diff < 31536000)  snprintf(buf, sizeof(buf), "%lld mo%s ago",   (long long)(diff/2592000), diff/2592000==1?"":"s");
-    else                       snprintf(buf, sizeof(buf), "%lld yr ago",     (long long)(diff/31536000));
+    if (diff < 60)             snprintf(buf, n, "just now");
+    else if (diff < 3600)      snprintf(buf, n, "%lld min ago",    (long long)(diff/60));
+    else if (diff < 86400)     snprintf(buf, n, "%lld hour%s ago", (long long)(diff/3600),   diff/3600==1?  "":"s");
+    else if (diff < 2592000)   snprintf(buf, n, "%lld day%s ago",  (long long)(diff/86400),  diff/86400==1? "":"s");
+    else if (diff < 31536000)  snprintf(buf, n, "%lld mo%s ago",   (long long)(diff/2592000), diff/2592000==1?"":"s");
+    else                       snprintf(buf, n, "%lld yr ago",     (long long)(diff/31536000));
     return buf;
 }
 
-/* ── UTF-8 display width ───────────────────────────────────────────────────── */
-int utf8_width(const char *s) {
-    int w = 0;
-    const unsigned char *p = (const unsigned char *)s;
-    while (*p) {
-        int seqlen;
-        if      (*p < 0x80) seqlen = 1;
-        else if (*p < 0xE0) seqlen = 2;
-        else if (*p < 0xF0) seqlen = 3;
-        else                seqlen = 4;
-        /* guard against truncated sequences at end of string */
-        for (int j = 1; j < seqlen; j++)
-            if (p[j] == '\0') goto done;
-        p += seqlen;
-        w++;
-    }
-done:
-    return w;
-}
-
-/* Returns the byte length of the longest prefix of s with display width <= max_w. */
-static size_t utf8_byte_len_for_width(const char *s, int max_w) {
-    const unsigned char *p = (const unsigned char *)s;
-    int w = 0;
-    while (*p && w < max_w) {
-        int seqlen;
-        if      (*p < 0x80) seqlen = 1;
-        else if (*p < 0xE0) seqlen = 2;
-        else if (*p < 0xF0) seqlen = 3;
-        else                seqlen = 4;
-        for (int j = 1; j < seqlen; j++)
-            if (p[j] == '\0') goto done;
-        p += seqlen;
-        w++;
-    }
-done:
-    return (size_t)(p - (const unsigned char *)s);
-}
-
 /* ── Column printer ────────────────────────────────────────────────────────── */
-void write_col(const char *s, int width) {
-    int dw = utf8_width(s);
-    if (dw <= width) {
-        printf("%s", s);
-        printf("%-*s", width - dw, "");
+void write_col(Frame *f, const char *s, int width) {
+    int dw;
+    size_t fit = utf8_byte_len_for_width(s, width, &dw);
+    if (s[fit] == '\0') {
+        frame_write(f, s, fit);
+        frame_pad(f, width - dw);
     } else {
-        /* truncate at a character boundary, not a byte boundary */
-        size_t bytes = utf8_byte_len_for_width(s, width - 1);
-        printf("%.*s~", (int)bytes, s);
+        /* truncate at a character boundary, not a byte boundary; a wide
+         * character that would straddle the cut is padded instead */
+        fit = utf8_byte_len_for_width(s, width - 1, &dw);
+        frame_write(f, s, fit);
+        frame_puts(f, "~");
+        frame_pad(f, width - 1 - dw);
     }
 }
 
@@ -153,71 +109,90 @@ static void build_sync_str(const Repo *r, char *buf, size_t n, const char **colo
 }
 
 /* ── Sync indicator ────────────────────────────────────────────────────────── */
-static void write_sync(const Repo *r, int width) {
+static void write_sync(Frame *f, const Repo *r, int width) {
     char plain[32];
     const char *color;
     build_sync_str(r, plain, sizeof(plain), &color);
     int dw = utf8_width(plain);
-    printf("%s%s%s%-*s", C(color), plain, C(COL_RESET), width - dw, "");
+    frame_printf(f, "%s%s%s%-*s", C(color), plain, C(COL_RESET), width - dw, "");
 }
 
-/* ── Dynamic column widths ──────────────────────────────────────────────────── */
-ColWidths compute_col_widths(void) {
-    ColWidths w = {
-        .name   = (int)strlen("NAME"),
-        .branch = (int)strlen("BRANCH"),
-        .sync   = (int)strlen("SYNC"),
-        .time   = (int)strlen("WHEN"),
-    };
-    for (size_t i = 0; i < g_repo_count; i++) {
-        const Repo *r = &g_repos[i];
+/* ── Name column ───────────────────────────────────────────────────────────── */
+/*
+ * Directory name of the repo; a linked worktree is suffixed with the name of
+ * its main worktree ("feature ↳api-server") so worktrees of one clone can be
+ * told apart and matched up in the table.
+ */
+static const char *display_name(const Repo *r, char *buf, size_t n) {
+    const char *name = strrchr(r->path, '/');
+    name = name ? name + 1 : r->path;
+    if (!r->wt_linked || !r->wt_main) return name;
+    snprintf(buf, n, "%s \xe2\x86\xb3%s", name, r->wt_main);
+    return buf;
+}
 
-        const char *name = strrchr(r->path, '/');
-        name = name ? name + 1 : r->path;
-        w.name = MAX(w.name, utf8_width(name));
+/* WHEN text; blank for a timed-out repo with no cached values to show. */
+static const char *when_str(const Repo *r, char *buf, size_t n) {
+    if (r->timed_out && !r->branch[0]) return "";
+    return relative_time(r->last_commit, buf, n);
+}
 
-        w.branch = MAX(w.branch, utf8_width(r->branch));
+/* ── Dynamic column widths ──────────────────────────────────────────────────── */
+/* Widen w to fit r's row. */
+void col_widths_add(ColWidths *w, const Repo *r) {
+    char name_buf[PATH_MAX + 264];
+    w->name = MAX(w->name, utf8_width(display_name(r, name_buf, sizeof(name_buf))));
 
-        char sync_buf[32];
-        const char *dummy;
-        build_sync_str(r, sync_buf, sizeof(sync_buf), &dummy);
-        w.sync = MAX(w.sync, utf8_width(sync_buf));
+    w->branch = MAX(w->branch, utf8_width(r->branch));
 
-        w.time = MAX(w.time, utf8_width(relative_time(r->last_commit)));
-    }
+    char sync_buf[32];
+    const char *dummy;
+    build_sync_str(r, sync_buf, sizeof(sync_buf), &dummy);
+    w->sync = MAX(w->sync, utf8_width(sync_buf));
 
-    /* Cap the variable NAME / BRANCH columns so a single row never exceeds the
-     * terminal width and wraps (which would corrupt the table, and the in-place
-     * redraw in watch mode). write_col() truncates over-long content with '~'.
-     * The layout is: 2(lead) + name +2 + branch +2 + sync +2 + time +2 + STATUS. */
+    char when_buf[32];
+    w->time = MAX(w->time, utf8_width(when_str(r, when_buf, sizeof(when_buf))));
+}
+
+/* Cap the variable NAME / BRANCH columns so a single row never exceeds the
+ * terminal width and wraps (which would corrupt the table, and the in-place
+ * redraw in watch mode). write_col() truncates over-long content with '~'.
+ * The layout is: 2(lead) + name +2 + branch +2 + sync +2 + time +2 + STATUS. */
+void col_widths_fit(ColWidths *w) {
     int tw = term_width();
-    if (tw > 0) {
-        const int status_reserve = 14;   /* room for e.g. ●9 ✗9 ?9 */
-        int other = 2 + 2 + 2 + 2 + 2 + w.sync + w.time + status_reserve;
-        int avail = tw - other;          /* budget shared by NAME + BRANCH */
-        if (avail < 10) avail = 10;
-        while (w.name + w.branch > avail) {
-            if (w.branch > 6 && w.branch >= w.name) w.branch--;
-            else if (w.name > 4)                    w.name--;
-            else if (w.branch > 6)                  w.branch--;
-            else break;                  /* at minimums (NAME 4 / BRANCH 6) */
-        }
+    if (tw <= 0) return;
+    const int status_reserve = 14;       /* room for e.g. ●9 ✗9 ?9 */
+    int other = 2 + 2 + 2 + 2 + 2 + w->sync + w->time + status_reserve;
+    int avail = tw - other;              /* budget shared by NAME + BRANCH */
+    if (avail < 10) avail = 10;
+    while (w->name + w->branch > avail) {
+        if (w->branch > 6 && w->branch >= w->name) w->branch--;
+        else if (w->name > 4)                      w->name--;
+        else if (w->branch > 6)                    w->branch--;
+        else break;                      /* at minimums (NAME 4 / BRANCH 6) */
     }
+}
+
+ColWidths compute_col_widths(void) {
+    ColWidths w = COL_WIDTHS_MIN;
+    for (size_t i = 0; i < g_repo_count; i++)
+        col_widths_add(&w, &g_repos[i]);
+    col_widths_fit(&w);
     return w;
 }
 
 /* ── Separator ──────────────────────────────────────────────────────────────── */
-void print_separator(const ColWidths *w) {
+void print_separator(Frame *f, const ColWidths *w) {
     int total = w->name + 2 + w->branch + 2 + w->sync + 2 + w->time + 2
                 + (int)strlen("STATUS");
-    printf("  %s", C(COL_DIM));
-    for (int i = 0; i < total; i++) printf("─");
-    printf("%s%s\n", C(COL_RESET), EOL());
+    frame_printf(f, "  %s", C(COL_DIM));
+    for (int i = 0; i < total; i++) frame_puts(f, "─");
+    frame_printf(f, "%s%s\n", C(COL_RESET), EOL());
 }
 
 /* ── Table header ──────────────────────────────────────────────────────────── */
-void print_header(const ColWidths *w) {
-    printf("  %s%-*s  %-*s  %-*s  %-*s  %s%s%s\n",
+void print_header(Frame *f, const ColWidths *w) {
+    frame_printf(f, "  %s%-*s  %-*s  %-*s  %-*s  %s%s%s\n",
         C(COL_DIM),
         w->name,   "NAME",
         w->branch, "BRANCH",
@@ -225,48 +200,56 @@ void print_header(const ColWidths *w) {
         w->time,   "WHEN",
         "STATUS",
         C(COL_RESET), EOL());
-    print_separator(w);
+    print_separator(f, w);
 }
 
 /* ── Single repo row ───────────────────────────────────────────────────────── */
-void print_repo(const Repo *r, const ColWidths *w) {
+void print_repo(Frame *f, const Repo *r, const ColWidths *w) {
     int is_dirty = (r->staged || r->modified || r->untracked);
 
-    const char *name = strrchr(r->path, '/');
-    name = name ? name + 1 : r->path;
+    char name_buf[PATH_MAX + 264], when_buf[32];
+    const char *name = display_name(r, name_buf, sizeof(name_buf));
+
+    frame_printf(f, "  %s", C(COL_CYAN));
+    write_col(f, name, w->name);
+    frame_printf(f, "%s  ", C(COL_RESET));
 
-    printf("  %s", C(COL_CYAN));
-    write_col(name, w->name);
-    printf("%s  ", C(COL_RESET));
+    bool known = !r->timed_out || r->branch[0];   /* false: nothing to show yet */
 
-    printf("%s", C(is_dirty ? COL_YELLOW : COL_GREEN));
-    write_col(r->branch, w->branch);
-    printf("%s  ", C(COL_RESET));
+    frame_puts(f, C(!known ? COL_DIM : is_dirty ? COL_YELLOW : COL_GREEN));
+    write_col(f, known ? r->branch : "?", w->branch);
+    frame_printf(f, "%s  ", C(COL_RESET));
 
-    write_sync(r, w->sync);
-    printf("  ");
+    write_sync(f, r, w->sync);
+    frame_puts(f, "  ");
 
-    printf("%s", C(COL_DIM));
-    write_col(relative_time(r->last_commit), w->time);
-    printf("%s  ", C(COL_RESET));
+    frame_puts(f, C(COL_DIM));
+    write_col(f, when_str(r, when_buf, sizeof(when_buf)), w->time);
+    frame_printf(f, "%s  ", C(COL_RESET));
 
-    if (!is_dirty) {
-        printf("%s✓%s", C(COL_GREEN), C(COL_RESET));
+    if (!known) {
+        frame_printf(f, "%stimed out%s", C(COL_YELLOW), C(COL_RESET));
+    } else if (!is_dirty) {
+        frame_printf(f, "%s✓%s", C(COL_GREEN), C(COL_RESET));
     } else {
-        if (r->staged)    printf("%s●%d%s ", C(COL_GREEN),   r->staged,    C(COL_RESET));
-        if (r->modified)  printf("%s✗%d%s ", C(COL_RED),     r->modified,  C(COL_RESET));
-        if (r->untracked) printf("%s?%d%s",  C(COL_MAGENTA), r->untracked, C(COL_RESET));
+        if (r->staged)    frame_printf(f, "%s●%d%s ", C(COL_GREEN),   r->staged,    C(COL_RESET));
+        if (r->modified)  frame_printf(f, "%s✗%d%s ", C(COL_RED),     r->modified,  C(COL_RESET));
+        if (r->untracked) frame_printf(f, "%s?%d%s",  C(COL_MAGENTA), r->untracked, C(COL_RESET));
     }
-    printf("%s\n", EOL());
+    if (known && r->timed_out)
+        frame_printf(f, " %s(timed out)%s", C(COL_DIM), C(COL_RESET));
+    frame_printf(f, "%s\n", EOL());
 }
 
 /* ── Dirty filter ──────────────────────────────────────────────────────────── */
 /*
  * A repo is "dirty" (worth showing under --dirty) when it is not both clean
  * and in sync: any staged/modified/untracked files, any ahead/behind commits,
- * or a detached / unborn HEAD (branch rendered as "(...)").
+ * or a detached / unborn HEAD (branch rendered as "(...)"). A repo that hit
+ * the status deadline is shown too: its current state is unknown.
  */
 bool repo_is_dirty(const Repo *r) {
+    if (r->timed_out)                             return true;
     if (r->staged || r->modified || r->untracked) return true;
     if (r->ahead || r->behind)                    return true;
     if (r->branch[0] == '(')                      return true;
@@ -274,46 +257,109 @@ bool repo_is_dirty(const Repo *r) {
 }
 
 /* ── Status table ──────────────────────────────────────────────────────────── */
+/*
+ * Rows of a big table are formatted on the pool, ROWS_PER_TASK to a task, each
+ * into a frame of its own; the frames are then joined in scan order. That goes
+ * in waves of one task per pool thread, each joined (and, into a pipe,
+ * spilled) before the next is rendered, so that no more than a wave of rows
+ * is held at once.
+ */
+#define ROWS_PER_TASK 4096
+
+typedef struct {
+    const ColWidths *w;
+    size_t           lo, hi;
+    bool             dirty_only;
+    Frame            out;
+} RowChunk;
+
+static void print_rows(Frame *f, const ColWidths *w, size_t lo, size_t hi, bool dirty_only) {
+    for (size_t i = lo; i < hi; i++) {
+        const Repo *r = &g_repos[i];
+        if (dirty_only && !repo_is_dirty(r)) continue;
+        print_repo(f, r, w);
+    }
+}
+
+static void row_chunk_task(void *arg) {
+    RowChunk *c = arg;
+    frame_init(&c->out, 0);
+    print_rows(&c->out, c->w, c->lo, c->hi, c->dirty_only);
+}
+
 /*
  * Print the header, one row per repo and the trailing summary line.
  * When dirty_only is set, clean+in-sync repos are hidden from the listing but
  * still counted in the summary, which appends "(N hidden)".
  */
-void print_status_table(const ColWidths *w, bool dirty_only) {
-    print_header(w);
+void print_status_table(Frame *f, const ColWidths *w, bool dirty_only) {
+    print_header(f, w);
+
+    size_t nchunks = (g_repo_count + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    size_t wave    = (size_t)pool_size();
+    RowChunk *chunks = nchunks > 1 && wave > 1 ? calloc(wave, sizeof(*chunks)) : NULL;
+    if (chunks) {
+        for (size_t k0 = 0; k0 < nchunks; k0 += wave) {
+            size_t n = nchunks - k0 < wave ? nchunks - k0 : wave;
+            TaskGroup g = { 0 };
+            for (size_t k = 0; k < n; k++) {
+                size_t lo = (k0 + k) * ROWS_PER_TASK, hi = lo + ROWS_PER_TASK;
+                chunks[k] = (RowChunk){ .w = w, .lo = lo,
+                                        .hi = hi < g_repo_count ? hi : g_repo_count,
+                                        .dirty_only = dirty_only };
+                pool_submit(&g, row_chunk_task, &chunks[k]);
+            }
+            pool_wait(&g);
+            for (size_t k = 0; k < n; k++) {
+                frame_append(f, &chunks[k].out);
+                frame_free(&chunks[k].out);
+            }
+        }
+        free(chunks);
+    } else {
+        print_rows(f, w, 0, g_repo_count, dirty_only);
+    }
 
-    int total = 0, clean = 0, dirty = 0, behind = 0, hidden = 0;
+    print_table_footer(f, w, dirty_only);
+}
+
+/* The separator under the rows and the summary line. */
+void print_table_footer(Frame *f, const ColWidths *w, bool dirty_only) {
+    int total = 0, clean = 0, dirty = 0, behind = 0, hidden = 0, timed_out = 0;
     for (size_t i = 0; i < g_repo_count; i++) {
         const Repo *r = &g_repos[i];
         total++;
-        if (r->staged || r->modified || r->untracked) dirty++; else clean++;
+        if (r->timed_out) timed_out++;
+        if (!r->timed_out || r->branch[0]) {   /* unknown state counts as neither */
+            if (r->staged || r->modified || r->untracked) dirty++; else clean++;
+        }
         if (r->behind > 0) behind++;
-
-        if (dirty_only && !repo_is_dirty(r)) { hidden++; continue; }
-        print_repo(r, w);
+        if (dirty_only && !repo_is_dirty(r)) hidden++;
     }
 
-    print_separator(w);
+    print_separator(f, w);
     if (total == 0) {
-        printf("  No git repositories found.%s\n", EOL());
+        frame_printf(f, "  No git repositories found.%s\n", EOL());
     } else {
-        printf("  %s%d repo%s%s · %s%d clean%s · %s%d dirty%s",
+        frame_printf(f, "  %s%d repo%s%s · %s%d clean%s · %s%d dirty%s",
             C(COL_BOLD), total, total == 1 ? "" : "s", C(COL_RESET),
             C(COL_GREEN), clean,  C(COL_RESET),
             C(COL_RED),   dirty,  C(COL_RESET));
         if (behind > 0)
-            printf(" · %s%d behind%s", C(COL_YELLOW), behind, C(COL_RESET));
+            frame_printf(f, " · %s%d behind%s", C(COL_YELLOW), behind, C(COL_RESET));
+        if (timed_out > 0)
+            frame_printf(f, " · %s%d timed out%s", C(COL_YELLOW), timed_out, C(COL_RESET));
         if (hidden > 0)
-            printf(" %s(%d hidden)%s", C(COL_DIM), hidden, C(COL_RESET));
-        printf("%s\n", EOL());
+            frame_printf(f, " %s(%d hidden)%s", C(COL_DIM), hidden, C(COL_RESET));
+        frame_printf(f, "%s\n", EOL());
     }
 }
 
 /* ── Switch summary ────────────────────────────────────────────────────────── */
-void print_switch_summary(const ColWidths *w) {
+void print_switch_summary(Frame *f, const ColWidths *w) {
     int switched = 0, created = 0, already = 0, not_found = 0, skipped = 0;
 
-    printf("%sSwitched to branch:%s %s%s%s\n\n",
+    frame_printf(f, "%sSwitched to branch:%s %s%s%s\n\n",
         C(COL_BOLD), C(COL_RESET),
         C(COL_YELLOW), opt_switch_branch, C(COL_RESET));
 
@@ -333,62 +379,186 @@ void print_switch_summary(const ColWidths *w) {
             default: break;
         }
 
-        /* skip uninteresting rows unless -v */
+        /* skip uninteresting rows unless -v; never-attempted ones always */
+        if (r->switch_result == SR_NA) continue;
         if (!opt_verbose &&
             (r->switch_result == SR_ALREADY || r->switch_result == SR_NOT_FOUND))
             continue;
 
-        printf("  %s", C(COL_CYAN));
-        write_col(name, w->name);
-        printf("%s  ", C(COL_RESET));
+        frame_printf(f, "  %s", C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  ", C(COL_RESET));
 
         switch (r->switch_result) {
             case SR_SWITCHED:
-                printf("%s✓ switched%s\n", C(COL_GREEN), C(COL_RESET));
+                frame_printf(f, "%s✓ switched%s\n", C(COL_GREEN), C(COL_RESET));
                 break;
             case SR_CREATED:
-                printf("%s✓ created & switched%s\n", C(COL_GREEN), C(COL_RESET));
+                frame_printf(f, "%s✓ created & switched%s\n", C(COL_GREEN), C(COL_RESET));
                 break;
             case SR_ALREADY:
-                printf("%s· already on branch%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· already on branch%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case SR_DIRTY:
-                printf("%s✗ skipped%s  %s", C(COL_RED), C(COL_RESET), C(COL_DIM));
-                if (r->staged)   printf("%d staged", r->staged);
-                if (r->staged && r->modified) printf(", ");
-                if (r->modified) printf("%d modified", r->modified);
-                printf("%s\n", C(COL_RESET));
+                frame_printf(f, "%s✗ skipped%s  %s", C(COL_RED), C(COL_RESET), C(COL_DIM));
+                if (r->staged)   frame_printf(f, "%d staged", r->staged);
+                if (r->staged && r->modified) frame_puts(f, ", ");
+                if (r->modified) frame_printf(f, "%d modified", r->modified);
+                frame_printf(f, "%s\n", C(COL_RESET));
                 break;
             case SR_NOT_FOUND:
-                printf("%s· branch not found%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· branch not found%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case SR_ERROR:
-                printf("%s✗ error (checkout failed)%s\n", C(COL_RED), C(COL_RESET));
+                frame_printf(f, "%s✗ error (checkout failed)%s\n", C(COL_RED), C(COL_RESET));
                 break;
             default:
                 break;
         }
     }
 
-    printf("\n");
-    print_separator(w);
-    printf("  switched %s%d%s · already %s%d%s",
+    frame_puts(f, "\n");
+    print_separator(f, w);
+    frame_printf(f, "  switched %s%d%s · already %s%d%s",
         C(COL_GREEN), switched,  C(COL_RESET),
         C(COL_DIM),   already,   C(COL_RESET));
     if (created)
-        printf(" · created %s%d%s", C(COL_CYAN), created, C(COL_RESET));
+        frame_printf(f, " · created %s%d%s", C(COL_CYAN), created, C(COL_RESET));
     if (not_found)
-        printf(" · not found %s%d%s", C(COL_DIM), not_found, C(COL_RESET));
+        frame_printf(f, " · not found %s%d%s", C(COL_DIM), not_found, C(COL_RESET));
     if (skipped)
-        printf(" · skipped %s%d dirty%s", C(COL_RED), skipped, C(COL_RESET));
-    printf("\n\n");
+        frame_printf(f, " · skipped %s%d dirty%s", C(COL_RED), skipped, C(COL_RESET));
+    frame_puts(f, "\n\n");
+}
+
+/* ── Transfer accounting ────────────────────────────────────────────────────── */
+/* 3153920 -> "3.0 MiB"; under 1 KiB in bytes. */
+static const char *human_bytes(uint64_t b, char *buf, size_t n) {
+    static const char *const units[] = { "KiB", "MiB", "GiB", "TiB" };
+    if (b < 1024) {
+        snprintf(buf, n, "%llu B", (unsigned long long)b);
+        return buf;
+    }
+    double v = (double)b / 1024;
+    size_t u = 0;
+    while (v >= 1024 && u + 1 < sizeof(units) / sizeof(units[0])) {
+        v /= 1024;
+        u++;
+    }
+    snprintf(buf, n, "%.1f %s", v, units[u]);
+    return buf;
+}
+
+/* 850 -> "850ms", 2140 -> "2.1s", 65000 -> "1m05s" */
+static const char *human_ms(long ms, char *buf, size_t n) {
+    if (ms < 1000)       snprintf(buf, n, "%ldms", ms);
+    else if (ms < 60000) snprintf(buf, n, "%.1fs", (double)ms / 1000);
+    else                 snprintf(buf, n, "%ldm%02lds", ms / 60000, ms / 1000 % 60);
+    return buf;
+}
+
+/* bytes over ms as "1.2 MiB/s" */
+static const char *human_rate(uint64_t b, long ms, char *buf, size_t n) {
+    char tmp[32];
+    uint64_t per_s = ms > 0 ? (uint64_t)((double)b * 1000 / (double)ms) : b;
+    snprintf(buf, n, "%s/s", human_bytes(per_s, tmp, sizeof(tmp)));
+    return buf;
+}
+
+/* " · 3.1 MiB in 2.1s" after a row, for a repo whose fetch received bytes */
+static void print_row_transfer(Frame *f, const Repo *r) {
+    char b[32], t[32];
+    if (r->net_bytes == 0) return;
+    frame_printf(f, "%s · %s in %s%s", C(COL_DIM), human_bytes(r->net_bytes, b, sizeof(b)),
+                    human_ms(r->net_ms, t, sizeof(t)), C(COL_RESET));
+}
+
+/* Under the fetch / pull counts: what came in, over the phase's wall time,
+ * then per network host (the top five unless -v). */
+static void print_transfer_totals(Frame *f) {
+    uint64_t bytes = 0;
+    size_t objects = 0;
+    for (size_t i = 0; i < g_repo_count; i++) {
+        bytes   += g_repos[i].net_bytes;
+        objects += g_repos[i].net_objects;
+    }
+    if (bytes == 0 && objects == 0 && g_net_host_count == 0) return;
+
+    char b[32], t[32], rt[32];
+    frame_printf(f, "  received %s, %zu object%s in %s",
+                    human_bytes(bytes, b, sizeof(b)), objects, objects == 1 ? "" : "s",
+                    human_ms(g_net_wall_ms, t, sizeof(t)));
+    if (bytes > 0 && g_net_wall_ms > 0)
+        frame_printf(f, " · %s", human_rate(bytes, g_net_wall_ms, rt, sizeof(rt)));
+    frame_puts(f, "\n");
+
+    size_t shown = opt_verbose || g_net_host_count <= 5 ? g_net_host_count : 5;
+    int hw = 4;
+    for (size_t i = 0; i < shown; i++)
+        hw = MAX(hw, utf8_width(g_net_hosts[i].host));
+    if (hw > 32) hw = 32;
+    for (size_t i = 0; i < shown; i++) {
+        const NetHostStat *h = &g_net_hosts[i];
+        frame_printf(f, "    %s", C(COL_CYAN));
+        write_col(f, h->host, hw);
+        frame_printf(f, "%s  %10s  %7zu obj  %3d fetch%s  %8s",
+                        C(COL_RESET), human_bytes(h->bytes, b, sizeof(b)), h->objects,
+                        h->fetches, h->fetches == 1 ? "  " : "es",
+                        human_ms(h->ms, t, sizeof(t)));
+        if (h->bytes > 0 && h->ms > 0)
+            frame_printf(f, "  %s%s%s", C(COL_DIM), human_rate(h->bytes, h->ms, rt, sizeof(rt)),
+                            C(COL_RESET));
+        frame_puts(f, "\n");
+    }
+    if (shown < g_net_host_count)
+        frame_printf(f, "    %s… %zu more host%s (-v)%s\n", C(COL_DIM), g_net_host_count - shown,
+                        g_net_host_count - shown == 1 ? "" : "s", C(COL_RESET));
+}
+
+static int net_rank_cmp(const void *a, const void *b) {
+    const Repo *x = &g_repos[*(const size_t *)a], *y = &g_repos[*(const size_t *)b];
+    if (x->net_ms != y->net_ms) return x->net_ms < y->net_ms ? 1 : -1;
+    if (x->net_bytes != y->net_bytes) return x->net_bytes < y->net_bytes ? 1 : -1;
+    return *(const size_t *)a < *(const size_t *)b ? -1 : 1;
+}
+
+/* --net-stats: every repo that went to the network, slowest first. */
+void print_net_stats(Frame *f, const ColWidths *w) {
+    frame_printf(f, "%sNetwork time:%s\n\n", C(COL_BOLD), C(COL_RESET));
+
+    size_t *idx = malloc((g_repo_count ? g_repo_count : 1) * sizeof(*idx));
+    if (!idx) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    size_t n = 0;
+    for (size_t i = 0; i < g_repo_count; i++)
+        if (g_repos[i].net_ms > 0) idx[n++] = i;
+    qsort(idx, n, sizeof(*idx), net_rank_cmp);
+
+    for (size_t k = 0; k < n; k++) {
+        const Repo *r = &g_repos[idx[k]];
+        const char *name = strrchr(r->path, '/');
+        name = name ? name + 1 : r->path;
+        char b[32], t[32], rt[32];
+        frame_printf(f, "  %3zu  %s", k + 1, C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  %8s  %10s  %7zu obj", C(COL_RESET), human_ms(r->net_ms, t, sizeof(t)),
+                        human_bytes(r->net_bytes, b, sizeof(b)), r->net_objects);
+        if (r->net_bytes > 0)
+            frame_printf(f, "  %s%s%s", C(COL_DIM), human_rate(r->net_bytes, r->net_ms, rt, sizeof(rt)),
+                            C(COL_RESET));
+        frame_puts(f, "\n");
+    }
+    if (n == 0)
+        frame_printf(f, "  %snothing went to the network%s\n", C(COL_DIM), C(COL_RESET));
+    frame_puts(f, "\n");
+    free(idx);
 }
 
 /* ── Fetch summary ──────────────────────────────────────────────────────────── */
-void print_fetch_summary(const ColWidths *w) {
-    int fetched = 0, up_to_date = 0, no_remote = 0, errors = 0;
+void print_fetch_summary(Frame *f, const ColWidths *w) {
+    int fetched = 0, up_to_date = 0, no_remote = 0, errors = 0, cancelled = 0;
+    int fresh = 0, down = 0;
 
-    printf("%sFetch results:%s\n\n", C(COL_BOLD), C(COL_RESET));
+    frame_printf(f, "%sFetch results:%s\n\n", C(COL_BOLD), C(COL_RESET));
 
     for (size_t i = 0; i < g_repo_count; i++) {
         const Repo *r = &g_repos[i];
@@ -401,57 +571,165 @@ void print_fetch_summary(const ColWidths *w) {
             case FR_UP_TO_DATE:   up_to_date++; break;
             case FR_NO_REMOTE:    no_remote++;  break;
             case FR_ERROR:        errors++;     break;
+            case FR_CANCELLED:    cancelled++;  break;
+            case FR_FRESH:        fresh++;      break;
+            case FR_HOST_DOWN:    down++;       break;
             default: break;
         }
 
-        /* skip uninteresting rows unless -v */
+        /* skip uninteresting rows unless -v; never-attempted ones always */
+        if (r->fetch_result == FR_NA) continue;
         if (!opt_verbose &&
-            (r->fetch_result == FR_UP_TO_DATE || r->fetch_result == FR_NO_REMOTE))
+            (r->fetch_result == FR_UP_TO_DATE || r->fetch_result == FR_NO_REMOTE
+             || r->fetch_result == FR_FRESH))
             continue;
 
-        printf("  %s", C(COL_CYAN));
-        write_col(name, w->name);
-        printf("%s  ", C(COL_RESET));
+        frame_printf(f, "  %s", C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  ", C(COL_RESET));
 
         switch (r->fetch_result) {
             case FR_FETCHED:
-                printf("%s✓ fetched%s\n", C(COL_GREEN), C(COL_RESET));
+                frame_printf(f, "%s✓ fetched%s", C(COL_GREEN), C(COL_RESET));
+                if (r->fetch_refs > 0) {
+                    frame_printf(f, "  %s%d ref%s updated", C(COL_DIM), r->fetch_refs,
+                                    r->fetch_refs == 1 ? "" : "s");
+                    if (r->fetch_new > 0)
+                        frame_printf(f, ", %zu new commit%s on upstream", r->fetch_new,
+                                        r->fetch_new == 1 ? "" : "s");
+                    frame_puts(f, C(COL_RESET));
+                }
+                print_row_transfer(f, r);
+                frame_puts(f, "\n");
                 break;
             case FR_UP_TO_DATE:
-                printf("%s· up to date%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· up to date%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case FR_NO_REMOTE:
-                printf("%s· no remote%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· no remote%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case FR_ERROR:
-                printf("%s✗ error%s", C(COL_RED), C(COL_RESET));
+                frame_printf(f, "%s✗ error%s", C(COL_RED), C(COL_RESET));
                 if (r->net_error[0])
-                    printf("  %s%s%s", C(COL_DIM), r->net_error, C(COL_RESET));
-                printf("\n");
+                    frame_printf(f, "  %s%s%s", C(COL_DIM), r->net_error, C(COL_RESET));
+                frame_puts(f, "\n");
+                break;
+            case FR_CANCELLED:
+                frame_printf(f, "%s· cancelled%s\n", C(COL_YELLOW), C(COL_RESET));
+                break;
+            case FR_FRESH:
+                frame_printf(f, "%s· fresh%s\n", C(COL_DIM), C(COL_RESET));
+                break;
+            case FR_HOST_DOWN:
+                frame_printf(f, "%s· host down, skipped%s\n", C(COL_YELLOW), C(COL_RESET));
                 break;
             default:
                 break;
         }
     }
 
-    printf("\n");
-    print_separator(w);
-    printf("  fetched %s%d%s",
+    frame_puts(f, "\n");
+    print_separator(f, w);
+    frame_printf(f, "  fetched %s%d%s",
         C(COL_GREEN), fetched, C(COL_RESET));
     if (up_to_date)
-        printf(" · up to date %s%d%s", C(COL_DIM), up_to_date, C(COL_RESET));
+        frame_printf(f, " · up to date %s%d%s", C(COL_DIM), up_to_date, C(COL_RESET));
+    if (fresh)
+        frame_printf(f, " · fresh %s%d%s", C(COL_DIM), fresh, C(COL_RESET));
+    if (no_remote)
+        frame_printf(f, " · no remote %s%d%s", C(COL_DIM), no_remote, C(COL_RESET));
+    if (errors)
+        frame_printf(f, " · errors %s%d%s", C(COL_RED), errors, C(COL_RESET));
+    if (down)
+        frame_printf(f, " · host down %s%d%s", C(COL_YELLOW), down, C(COL_RESET));
+    if (cancelled)
+        frame_printf(f, " · cancelled %s%d%s", C(COL_YELLOW), cancelled, C(COL_RESET));
+    frame_puts(f, "\n");
+    print_transfer_totals(f);
+    frame_puts(f, "\n");
+}
+
+/* ── Probe summary ──────────────────────────────────────────────────────────── */
+void print_probe_summary(Frame *f, const ColWidths *w) {
+    int changed = 0, same = 0, no_remote = 0, errors = 0, cancelled = 0, down = 0;
+
+    frame_printf(f, "%sProbe results:%s\n\n", C(COL_BOLD), C(COL_RESET));
+
+    for (size_t i = 0; i < g_repo_count; i++) {
+        const Repo *r = &g_repos[i];
+        const char *name = strrchr(r->path, '/');
+        name = name ? name + 1 : r->path;
+
+        /* accumulate counts regardless of verbosity */
+        switch (r->probe_result) {
+            case PB_CHANGED:     changed++;   break;
+            case PB_SAME:        same++;      break;
+            case PB_NO_REMOTE:   no_remote++; break;
+            case PB_ERROR:       errors++;    break;
+            case PB_CANCELLED:   cancelled++; break;
+            case PB_HOST_DOWN:   down++;      break;
+            default: break;
+        }
+
+        /* skip uninteresting rows unless -v; never-attempted ones always */
+        if (r->probe_result == PB_NA) continue;
+        if (!opt_verbose &&
+            (r->probe_result == PB_SAME || r->probe_result == PB_NO_REMOTE))
+            continue;
+
+        frame_printf(f, "  %s", C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  ", C(COL_RESET));
+
+        switch (r->probe_result) {
+            case PB_CHANGED:
+                frame_printf(f, "%s↻ changed%s\n", C(COL_YELLOW), C(COL_RESET));
+                break;
+            case PB_SAME:
+                frame_printf(f, "%s· in sync%s\n", C(COL_DIM), C(COL_RESET));
+                break;
+            case PB_NO_REMOTE:
+                frame_printf(f, "%s· no remote%s\n", C(COL_DIM), C(COL_RESET));
+                break;
+            case PB_ERROR:
+                frame_printf(f, "%s✗ error%s", C(COL_RED), C(COL_RESET));
+                if (r->net_error[0])
+                    frame_printf(f, "  %s%s%s", C(COL_DIM), r->net_error, C(COL_RESET));
+                frame_puts(f, "\n");
+                break;
+            case PB_CANCELLED:
+                frame_printf(f, "%s· cancelled%s\n", C(COL_YELLOW), C(COL_RESET));
+                break;
+            case PB_HOST_DOWN:
+                frame_printf(f, "%s· host down, skipped%s\n", C(COL_YELLOW), C(COL_RESET));
+                break;
+            default:
+                break;
+        }
+    }
+
+    frame_puts(f, "\n");
+    print_separator(f, w);
+    frame_printf(f, "  changed %s%d%s", C(COL_YELLOW), changed, C(COL_RESET));
+    if (same)
+        frame_printf(f, " · in sync %s%d%s", C(COL_DIM), same, C(COL_RESET));
     if (no_remote)
-        printf(" · no remote %s%d%s", C(COL_DIM), no_remote, C(COL_RESET));
+        frame_printf(f, " · no remote %s%d%s", C(COL_DIM), no_remote, C(COL_RESET));
     if (errors)
-        printf(" · errors %s%d%s", C(COL_RED), errors, C(COL_RESET));
-    printf("\n\n");
+        frame_printf(f, " · errors %s%d%s", C(COL_RED), errors, C(COL_RESET));
+    if (down)
+        frame_printf(f, " · host down %s%d%s", C(COL_YELLOW), down, C(COL_RESET));
+    if (cancelled)
+        frame_printf(f, " · cancelled %s%d%s", C(COL_YELLOW), cancelled, C(COL_RESET));
+    frame_puts(f, "\n\n");
 }
 
 /* ── Pull summary ───────────────────────────────────────────────────────────── */
-void print_pull_summary(const ColWidths *w) {
+void print_pull_summary(Frame *f, const ColWidths *w) {
     int pulled = 0, up_to_date = 0, dirty = 0, not_ff = 0, no_remote = 0, errors = 0;
+    int cancelled = 0, down = 0;
 
-    printf("%sPull results:%s\n\n", C(COL_BOLD), C(COL_RESET));
+    frame_printf(f, "%sPull results:%s\n\n", C(COL_BOLD), C(COL_RESET));
 
     for (size_t i = 0; i < g_repo_count; i++) {
         const Repo *r = &g_repos[i];
@@ -466,58 +744,166 @@ void print_pull_summary(const ColWidths *w) {
             case PR_NOT_FF:      not_ff++;     break;
             case PR_NO_REMOTE:   no_remote++;  break;
             case PR_ERROR:       errors++;     break;
+            case PR_CANCELLED:   cancelled++;  break;
+            case PR_HOST_DOWN:   down++;       break;
             default: break;
         }
 
-        /* skip uninteresting rows unless -v */
+        /* skip uninteresting rows unless -v; never-attempted ones always */
+        if (r->pull_result == PR_NA) continue;
         if (!opt_verbose &&
             (r->pull_result == PR_UP_TO_DATE || r->pull_result == PR_NO_REMOTE))
             continue;
 
-        printf("  %s", C(COL_CYAN));
-        write_col(name, w->name);
-        printf("%s  ", C(COL_RESET));
+        frame_printf(f, "  %s", C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  ", C(COL_RESET));
 
         switch (r->pull_result) {
             case PR_PULLED:
-                printf("%s✓ pulled%s\n", C(COL_GREEN), C(COL_RESET));
+                frame_printf(f, "%s✓ pulled%s", C(COL_GREEN), C(COL_RESET));
+                print_row_transfer(f, r);
+                frame_puts(f, "\n");
                 break;
             case PR_UP_TO_DATE:
-                printf("%s· up to date%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· up to date%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case PR_DIRTY:
-                printf("%s✗ skipped%s  %s(dirty)%s\n",
+                frame_printf(f, "%s✗ skipped%s  %s(dirty)%s\n",
                     C(COL_RED), C(COL_RESET), C(COL_DIM), C(COL_RESET));
                 break;
             case PR_NOT_FF:
-                printf("%s· not fast-forward%s\n", C(COL_YELLOW), C(COL_RESET));
+                frame_printf(f, "%s· not fast-forward%s\n", C(COL_YELLOW), C(COL_RESET));
                 break;
             case PR_NO_REMOTE:
-                printf("%s· no remote%s\n", C(COL_DIM), C(COL_RESET));
+                frame_printf(f, "%s· no remote%s\n", C(COL_DIM), C(COL_RESET));
                 break;
             case PR_ERROR:
-                printf("%s✗ error%s\n", C(COL_RED), C(COL_RESET));
+                frame_printf(f, "%s✗ error%s\n", C(COL_RED), C(COL_RESET));
+                break;
+            case PR_CANCELLED:
+                frame_printf(f, "%s· cancelled%s\n", C(COL_YELLOW), C(COL_RESET));
+                break;
+            case PR_HOST_DOWN:
+                frame_printf(f, "%s· host down, skipped%s\n", C(COL_YELLOW), C(COL_RESET));
                 break;
             default:
                 break;
         }
     }
 
-    printf("\n");
-    print_separator(w);
-    printf("  pulled %s%d%s",
+    frame_puts(f, "\n");
+    print_separator(f, w);
+    frame_printf(f, "  pulled %s%d%s",
         C(COL_GREEN), pulled, C(COL_RESET));
     if (up_to_date)
-        printf(" · up to date %s%d%s", C(COL_DIM), up_to_date, C(COL_RESET));
+        frame_printf(f, " · up to date %s%d%s", C(COL_DIM), up_to_date, C(COL_RESET));
     if (dirty)
-        printf(" · skipped %s%d dirty%s", C(COL_RED), dirty, C(COL_RESET));
+        frame_printf(f, " · skipped %s%d dirty%s", C(COL_RED), dirty, C(COL_RESET));
     if (not_ff)
-        printf(" · not fast-forward %s%d%s", C(COL_YELLOW), not_ff, C(COL_RESET));
+        frame_printf(f, " · not fast-forward %s%d%s", C(COL_YELLOW), not_ff, C(COL_RESET));
     if (no_remote)
-        printf(" · no remote %s%d%s", C(COL_DIM), no_remote, C(COL_RESET));
+        frame_printf(f, " · no remote %s%d%s", C(COL_DIM), no_remote, C(COL_RESET));
     if (errors)
-        printf(" · errors %s%d%s", C(COL_RED), errors, C(COL_RESET));
-    printf("\n\n");
+        frame_printf(f, " · errors %s%d%s", C(COL_RED), errors, C(COL_RESET));
+    if (down)
+        frame_printf(f, " · host down %s%d%s", C(COL_YELLOW), down, C(COL_RESET));
+    if (cancelled)
+        frame_printf(f, " · cancelled %s%d%s", C(COL_YELLOW), cancelled, C(COL_RESET));
+    frame_puts(f, "\n");
+    print_transfer_totals(f);
+    frame_puts(f, "\n");
+}
+
+/* ── Exec summary ───────────────────────────────────────────────────────────── */
+/*
+ * First each repo's captured output, in scan order and indented under its
+ * name, then one row per repo in the style of the pull summary: failures
+ * always, successes with -v.
+ */
+void print_exec_summary(Frame *f, const ColWidths *w) {
+    int ok = 0, failed = 0, cancelled = 0, left_out = 0;
+    char t[32], b[32];
+
+    bool any_out = false;
+    for (size_t i = 0; i < g_repo_count; i++) {
+        const Repo *r = &g_repos[i];
+        if (!r->exec_out) continue;
+        if (!any_out)
+            frame_printf(f, "%sOutput:%s\n\n", C(COL_BOLD), C(COL_RESET));
+        any_out = true;
+        const char *name = strrchr(r->path, '/');
+        name = name ? name + 1 : r->path;
+        frame_printf(f, "  %s%s%s\n", C(COL_CYAN), name, C(COL_RESET));
+        for (const char *p = r->exec_out; *p;) {
+            const char *nl = strchr(p, '\n');
+            int len = nl ? (int)(nl - p) : (int)strlen(p);
+            frame_printf(f, "    %.*s\n", len, p);
+            p += len + (nl ? 1 : 0);
+        }
+        if (r->exec_cut)
+            frame_printf(f, "    %s… output cut at %s%s\n", C(COL_DIM),
+                            human_bytes(EXEC_OUT_CAP, b, sizeof(b)), C(COL_RESET));
+        frame_puts(f, "\n");
+    }
+
+    frame_printf(f, "%sExec results:%s", C(COL_BOLD), C(COL_RESET));
+    for (char **a = opt_exec_argv; a && *a; a++)   /* quoted roughly as typed */
+        frame_printf(f, strpbrk(*a, " \t\"$;&|<>*?") || !**a ? " '%s'" : " %s", *a);
+    frame_puts(f, "\n\n");
+
+    for (size_t i = 0; i < g_repo_count; i++) {
+        const Repo *r = &g_repos[i];
+        const char *name = strrchr(r->path, '/');
+        name = name ? name + 1 : r->path;
+
+        /* accumulate counts regardless of verbosity */
+        switch (r->exec_result) {
+            case ER_NA:          left_out++;  break;
+            case ER_OK:          ok++;        break;
+            case ER_FAILED:      failed++;    break;
+            case ER_CANCELLED:   cancelled++; break;
+        }
+
+        /* skip uninteresting rows unless -v; never-run ones always */
+        if (r->exec_result == ER_NA) continue;
+        if (!opt_verbose && r->exec_result == ER_OK) continue;
+
+        frame_printf(f, "  %s", C(COL_CYAN));
+        write_col(f, name, w->name);
+        frame_printf(f, "%s  ", C(COL_RESET));
+
+        switch (r->exec_result) {
+            case ER_OK:
+                frame_printf(f, "%s✓ ok%s", C(COL_GREEN), C(COL_RESET));
+                break;
+            case ER_FAILED:
+                if (r->exec_status < 0)
+                    frame_printf(f, "%s✗ killed%s", C(COL_RED), C(COL_RESET));
+                else
+                    frame_printf(f, "%s✗ exit %d%s", C(COL_RED), r->exec_status, C(COL_RESET));
+                break;
+            case ER_CANCELLED:
+                frame_printf(f, "%s· cancelled%s", C(COL_YELLOW), C(COL_RESET));
+                break;
+            default:
+                break;
+        }
+        if (r->exec_ms > 0)
+            frame_printf(f, "%s · %s%s", C(COL_DIM), human_ms(r->exec_ms, t, sizeof(t)), C(COL_RESET));
+        frame_puts(f, "\n");
+    }
+
+    frame_puts(f, "\n");
+    print_separator(f, w);
+    frame_printf(f, "  ok %s%d%s", C(COL_GREEN), ok, C(COL_RESET));
+    if (failed)
+        frame_printf(f, " · failed %s%d%s", C(COL_RED), failed, C(COL_RESET));
+    if (left_out)
+        frame_printf(f, " · not matched %s%d%s", C(COL_DIM), left_out, C(COL_RESET));
+    if (cancelled)
+        frame_printf(f, " · cancelled %s%d%s", C(COL_YELLOW), cancelled, C(COL_RESET));
+    frame_puts(f, "\n\n");
 }
 
 /* ── Spinner ────────────────────────────────────────────────────────────────── */
@@ -547,7 +933,7 @@ static void *spinner_run(void *arg) {
 }
 
 void spinner_start(const char *msg) {
-    if (!isatty(STDOUT_FILENO) || opt_no_color) return;
+    if (!isatty(STDOUT_FILENO) || opt_no_color || opt_format == FMT_NDJSON) return;
     atomic_store(&spinner_active, 1);
     if (pthread_create(&spinner_tid, NULL, spinner_run, (void *)msg) != 0) {
         atomic_store(&spinner_active, 0);
@@ -0,0 +1,217 @@
+/*
+ * exec.c – `gitls exec`: run one command in every repo
+ *
+ * `gitls exec [--where COND] -- CMD ARGS...` replaces the serial shell loop
+ * that cds into each repo in turn to run `make lint`. Phase 1 runs as usual,
+ * so --where can select repos by the same state the table shows; the command
+ * then runs in each selected repo on the Phase 2 executor: posix_spawn'd
+ * children multiplexed by one poll() loop, at most -j of them at a time.
+ *
+ * Each child is `/bin/sh -c 'cd "$1" && shift && exec "$@"'` with the
+ * repo and the command as positional parameters, so nothing the user typed
+ * is ever parsed by a shell, and its stdin is /dev/null so concurrent
+ * commands cannot fight over the terminal. stdout and stderr share one pipe
+ * per child; the first EXEC_OUT_CAP bytes are kept as written and printed per
+ * repo once all are done, never interleaved, with a note where they were cut.
+ *
+ * --where takes a comma-separated list of conditions that must all hold, and
+ * may be given more than once: dirty (what --dirty lists), clean, modified
+ * (staged or unstaged changes), untracked, ahead, behind, upstream (has one),
+ * branch=NAME. A leading '!' negates one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include "gitools.h"
+
+typedef enum {
+    W_DIRTY = 0,
+    W_CLEAN,
+    W_MODIFIED,
+    W_UNTRACKED,
+    W_AHEAD,
+    W_BEHIND,
+    W_UPSTREAM,
+    W_BRANCH,
+} WhereKind;
+
+typedef struct {
+    WhereKind kind;
+    bool      neg;
+    char      branch[256];      /* W_BRANCH */
+} WhereTerm;
+
+static WhereTerm *g_where = NULL;
+static size_t     g_where_n = 0, g_where_cap = 0;
+
+static const struct {
+    const char *name;
+    WhereKind   kind;
+} WHERE_NAMES[] = {
+    { "dirty",     W_DIRTY     },
+    { "clean",     W_CLEAN     },
+    { "modified",  W_MODIFIED  },
+    { "untracked", W_UNTRACKED },
+    { "ahead",     W_AHEAD     },
+    { "behind",    W_BEHIND    },
+    { "upstream",  W_UPSTREAM  },
+};
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+/* One condition, [!]name or [!]branch=NAME, of len bytes at s. */
+static bool where_term(const char *s, size_t len) {
+    WhereTerm t = { 0 };
+    if (len > 0 && *s == '!') {
+        t.neg = true;
+        s++;
+        len--;
+    }
+    bool known = false;
+    if (len > 7 && strncmp(s, "branch=", 7) == 0 && len - 7 < sizeof(t.branch)) {
+        t.kind = W_BRANCH;
+        memcpy(t.branch, s + 7, len - 7);
+        known = true;
+    }
+    for (size_t k = 0; !known && k < sizeof(WHERE_NAMES) / sizeof(*WHERE_NAMES); k++) {
+        if (strlen(WHERE_NAMES[k].name) == len && strncmp(s, WHERE_NAMES[k].name, len) == 0) {
+            t.kind = WHERE_NAMES[k].kind;
+            known = true;
+        }
+    }
+    if (!known) {
+        fprintf(stderr, "Error: unknown --where condition '%.*s' (dirty, clean, "
+                "modified, untracked, ahead, behind, upstream, branch=NAME; "
+                "'!' negates)\n", (int)len, s);
+        return false;
+    }
+    if (g_where_n == g_where_cap) {
+        size_t cap = g_where_cap ? g_where_cap * 2 : 4;
+        WhereTerm *tmp = realloc(g_where, cap * sizeof(*tmp));
+        if (!tmp) oom();
+        g_where = tmp;
+        g_where_cap = cap;
+    }
+    g_where[g_where_n++] = t;
+    return true;
+}
+
+/* Add the conditions of one --where value; false (with a message) if any is
+ * not understood. */
+bool exec_where_add(const char *spec) {
+    if (!spec || !*spec) {
+        fprintf(stderr, "Error: --where requires a condition\n");
+        return false;
+    }
+    for (const char *p = spec;;) {
+        const char *comma = strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : strlen(p);
+        if (len > 0 && !where_term(p, len)) return false;
+        if (!comma) return true;
+        p = comma + 1;
+    }
+}
+
+/* Does r meet every --where condition? A repo whose status query timed out
+ * meets none, as its state is unknown; without --where every repo does. */
+bool exec_where_match(const Repo *r) {
+    if (g_where_n > 0 && r->timed_out) return false;
+    for (size_t k = 0; k < g_where_n; k++) {
+        const WhereTerm *t = &g_where[k];
+        bool v = false;
+        switch (t->kind) {
+            case W_DIRTY:     v = repo_is_dirty(r);                              break;
+            case W_CLEAN:     v = !r->staged && !r->modified && !r->untracked;  break;
+            case W_MODIFIED:  v = r->staged || r->modified;                      break;
+            case W_UNTRACKED: v = r->untracked > 0;                              break;
+            case W_AHEAD:     v = r->ahead > 0;                                  break;
+            case W_BEHIND:    v = r->behind > 0;                                 break;
+            case W_UPSTREAM:  v = r->has_remote != 0;                            break;
+            case W_BRANCH:    v = strcmp(r->branch, t->branch) == 0;             break;
+        }
+        if (v == t->neg) return false;
+    }
+    return true;
+}
+
+void exec_where_free(void) {
+    free(g_where);
+    g_where = NULL;
+    g_where_n = g_where_cap = 0;
+}
+
+/* NetExec completion, on the loop thread: each child writes only its repo. */
+static void exec_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    Repo *r = ctx;
+    r->exec_status = status;
+    r->exec_ms     = ms;
+    r->exec_cut    = cut;
+    r->exec_result = status == 0                 ? ER_OK
+                   : status == NETEXEC_CANCELLED ? ER_CANCELLED : ER_FAILED;
+    if (out[0] && !(r->exec_out = strdup(out))) oom();
+    if (opt_format == FMT_NDJSON) {         /* written now, not kept for the report */
+        ndjson_repo(r);
+        free(r->exec_out);
+        r->exec_out = NULL;
+    }
+}
+
+/* Phase 2 of `gitls exec`, after process_all_repos() has filled g_repos. */
+void run_exec(const char *dir) {
+    if (g_repo_count == 0) return;
+
+    spinner_stop();
+    if (opt_format == FMT_TABLE) {
+        printf("  Found %zu repo%s\n", g_repo_count, g_repo_count == 1 ? "" : "s");
+        fflush(stdout);
+    }
+    char label[PATH_MAX + 64];
+    snprintf(label, sizeof(label), "%sRunning:%s %s", C(COL_BOLD), C(COL_RESET), dir);
+    spinner_start(label);
+
+    /* local work, mostly CPU bound: as many at once as status queries */
+    NetExec *ex = netexec_new("/bin/sh", status_jobs(), 0);
+    if (!ex) {
+        fprintf(stderr, "Error: could not set up subprocesses\n");
+        exit(1);
+    }
+    size_t argc = 0;
+    while (opt_exec_argv[argc]) argc++;
+    const char **argv = calloc(argc + 6, sizeof(*argv));
+    if (!argv) oom();
+    argv[0] = "sh";
+    argv[1] = "-c";
+    argv[2] = "cd \"$1\" && shift && exec \"$@\" </dev/null";
+    argv[3] = "gitls";
+    for (size_t k = 0; k < argc; k++) argv[5 + k] = opt_exec_argv[k];
+
+    for (size_t i = 0; i < g_repo_count; i++) {
+        Repo *r = &g_repos[i];
+        if (!exec_where_match(r)) {
+            ndjson_repo(r);
+            continue;
+        }
+        argv[4] = r->path;
+        netexec_spawn(ex, "", argv, EXEC_OUT_CAP, false, exec_done, r);
+    }
+    free(argv);
+
+    struct sigaction sa = { 0 }, old_int, old_term;
+    sa.sa_handler = netexec_on_signal;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+    netexec_run(ex);
+    sigaction(SIGINT,  &old_int,  NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    netexec_free(ex);
+
+    spinner_stop();
+}
@@ -0,0 +1,119 @@
+/*
+ * frame.c – output buffer: render a whole frame, write it once
+ *
+ * The table and the summaries are formatted into a Frame instead of being
+ * printf'd a few bytes at a time. A watch refresh then reaches the terminal
+ * in one write(): it is never seen half drawn, and over ssh it is one round
+ * of packets rather than hundreds. The buffer is kept from frame to frame.
+ *
+ * A one-shot table into a pipe can run to 100k rows; a Frame given a spill
+ * size writes out what it holds whenever it passes that size rather than
+ * growing to fit everything.
+ *
+ * A Frame belongs to one thread at a time. Rows can be rendered in parallel
+ * into frames of their own and joined in order with frame_append(); the table
+ * does that a wave of frames at a time, so the spill still bounds it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "gitools.h"
+
+#define FRAME_INITIAL (64 * 1024)
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+/* spill: bytes after which the frame is written out early; 0 = never. */
+void frame_init(Frame *f, size_t spill) {
+    f->buf = malloc(FRAME_INITIAL);
+    if (!f->buf) oom();
+    f->len   = 0;
+    f->cap   = FRAME_INITIAL;
+    f->spill = spill;
+}
+
+void frame_free(Frame *f) {
+    free(f->buf);
+    *f = (Frame){ 0 };
+}
+
+/* Room for n more bytes. */
+static void frame_reserve(Frame *f, size_t n) {
+    if (f->cap - f->len >= n) return;
+    size_t cap = f->cap ? f->cap : FRAME_INITIAL;
+    while (cap - f->len < n) cap *= 2;
+    char *tmp = realloc(f->buf, cap);
+    if (!tmp) oom();
+    f->buf = tmp;
+    f->cap = cap;
+}
+
+static void frame_spill(Frame *f) {
+    if (f->spill && f->len >= f->spill) frame_flush(f);
+}
+
+void frame_write(Frame *f, const char *s, size_t n) {
+    frame_reserve(f, n);
+    memcpy(f->buf + f->len, s, n);
+    f->len += n;
+    frame_spill(f);
+}
+
+void frame_puts(Frame *f, const char *s) {
+    frame_write(f, s, strlen(s));
+}
+
+void frame_printf(Frame *f, const char *fmt, ...) {
+    va_list ap;
+    frame_reserve(f, 1);
+    va_start(ap, fmt);
+    int n = vsnprintf(f->buf + f->len, f->cap - f->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n >= f->cap - f->len) {         /* did not fit: grow, format again */
+        frame_reserve(f, (size_t)n + 1);
+        va_start(ap, fmt);
+        vsnprintf(f->buf + f->len, f->cap - f->len, fmt, ap);
+        va_end(ap);
+    }
+    f->len += (size_t)n;
+    frame_spill(f);
+}
+
+/* n spaces (none if n <= 0). */
+void frame_pad(Frame *f, int n) {
+    if (n <= 0) return;
+    frame_reserve(f, (size_t)n);
+    memset(f->buf + f->len, ' ', (size_t)n);
+    f->len += (size_t)n;
+}
+
+void frame_append(Frame *f, const Frame *src) {
+    frame_write(f, src->buf, src->len);
+}
+
+/* Write the frame to stdout and empty it. Whatever stdio still buffers goes
+ * first, so the two never reorder. False if the write failed. */
+bool frame_flush(Frame *f) {
+    fflush(stdout);
+    size_t off = 0;
+    while (off < f->len) {
+        ssize_t n = write(STDOUT_FILENO, f->buf + off, f->len - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            f->len = 0;
+            return false;
+        }
+        off += (size_t)n;
+    }
+    f->len = 0;
+    return true;
+}
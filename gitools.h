@@ -6,6 +6,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <git2.h>
 
 /* ── ANSI colours ──────────────────────────────────────────────────────────── */
@@ -23,6 +24,12 @@
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
+/* ── Concurrency ───────────────────────────────────────────────────────────── */
+#define DEFAULT_NET_JOBS 16
+#define MAX_JOBS         1024
+#define FETCH_OUT_CAP    4096   /* output kept of a `git fetch --progress` */
+#define EXEC_OUT_CAP     65536  /* output kept of each `gitls exec` command */
+
 /* ── Dynamic column widths ─────────────────────────────────────────────────── */
 typedef struct {
     int name;
@@ -31,6 +38,17 @@ typedef struct {
     int time;
 } ColWidths;
 
+/* the header labels: no column is narrower */
+#define COL_WIDTHS_MIN ((ColWidths){ .name = 4, .branch = 6, .sync = 4, .time = 4 })
+
+/* ── Output frame (frame.c) ───────────────────────────────────────────────── */
+#define FRAME_PIPE_SPILL (1024 * 1024)  /* one-shot output to a pipe: written per MiB */
+typedef struct {
+    char  *buf;
+    size_t len, cap;
+    size_t spill;       /* write out early past this many bytes; 0 = never */
+} Frame;
+
 /* ── Switch result ─────────────────────────────────────────────────────────── */
 typedef enum {
     SR_NA = 0,
@@ -49,6 +67,9 @@ typedef enum {
     FR_UP_TO_DATE,
     FR_NO_REMOTE,
     FR_ERROR,
+    FR_CANCELLED,   /* interrupted, or never started, after a cancel */
+    FR_FRESH,       /* skipped: fetched less than --max-age ago */
+    FR_HOST_DOWN,   /* skipped: its host failed host_fail_limit times running */
 } FetchResult;
 
 /* ── Pull result ───────────────────────────────────────────────────────────── */
@@ -60,23 +81,129 @@ typedef enum {
     PR_DIRTY,       /* skipped: staged or modified */
     PR_NO_REMOTE,
     PR_ERROR,
+    PR_CANCELLED,   /* interrupted, or never started, after a cancel */
+    PR_HOST_DOWN,   /* fetch skipped by the host breaker */
 } PullResult;
 
+/* ── Probe result ──────────────────────────────────────────────────────────── */
+typedef enum {
+    PB_NA = 0,
+    PB_CHANGED,     /* upstream tip differs from the remote-tracking ref */
+    PB_SAME,
+    PB_NO_REMOTE,   /* no origin, or not on a branch */
+    PB_ERROR,
+    PB_CANCELLED,
+    PB_HOST_DOWN,   /* skipped by the host breaker */
+} ProbeResult;
+
+/* ── Exec result ───────────────────────────────────────────────────────────── */
+typedef enum {
+    ER_NA = 0,      /* not run: left out by --where */
+    ER_OK,          /* exited 0 */
+    ER_FAILED,      /* non-zero exit, killed, or could not be started */
+    ER_CANCELLED,   /* interrupted, or never started, after a cancel */
+} ExecResult;
+
+/* ── Thread pool task group (pool.c) ───────────────────────────────────────── */
+typedef struct {
+    _Atomic size_t pending;   /* submitted, not yet finished */
+} TaskGroup;
+
+/* ── Phase 1 / Phase 2 job order ───────────────────────────────────────────── */
+typedef enum {
+    ORDER_LONGEST = 0,  /* slowest first, from the timings cache */
+    ORDER_SCAN,
+    ORDER_DISK,         /* (device, inode) order, for rotational disks */
+} JobOrder;
+
+/* ── Output format ─────────────────────────────────────────────────────────── */
+typedef enum {
+    FMT_TABLE = 0,      /* the status table and summaries, once all is done */
+    FMT_NDJSON,         /* one JSON object per repo as it finishes (ndjson.c) */
+} OutputFormat;
+
+/* ── Progressive table (progressive.c) ─────────────────────────────────────── */
+typedef enum {
+    PROG_OFF = 0,       /* the table once every repo is done */
+    PROG_SCAN,          /* rows as repos finish, held back into scan order */
+    PROG_DONE,          /* rows as repos finish, in that order */
+} Progressive;
+
+/* ── Display width kernels (width.c) ───────────────────────────────────────── */
+typedef enum {
+    WIDTH_AUTO = 0,     /* the best the CPU has */
+    WIDTH_SWAR,         /* 8 bytes at a time in a word, any CPU */
+    WIDTH_SSE2,
+    WIDTH_AVX2,
+} WidthKernel;
+
+/* ── Timing history phases (cache.c) ───────────────────────────────────────── */
+typedef enum {
+    TIMING_LOCAL = 0,   /* Phase 1: libgit2 status */
+    TIMING_NET,         /* Phase 2: fetch / pull */
+    TIMING_PHASES,
+} TimingPhase;
+
+/* ── Host breaker (cache.c) ────────────────────────────────────────────────── */
+typedef enum {
+    HOST_GO = 0,        /* go ahead */
+    HOST_SKIP,          /* host is down: fail fast */
+    HOST_WAIT,          /* parked behind the trial; resumed once it reports */
+} HostAdmit;
+
+/* What a network op said about its server */
+typedef enum {
+    HOST_REACHED = 0,   /* got an answer, even an error */
+    HOST_UNREACHABLE,   /* no DNS answer, refused, or timed out */
+    HOST_UNTRIED,       /* cancelled, or went to the local mirror instead */
+} HostOutcome;
+
+/* ── Per-host transfer totals of one run (repo.c) ──────────────────────────── */
+typedef struct {
+    char        *host;
+    int          fetches;          /* repos fetched from it, plus shared mirrors */
+    uint64_t     bytes;
+    size_t       objects;
+    long         ms;               /* summed over its fetches */
+} NetHostStat;
+
 /* ── Repo ──────────────────────────────────────────────────────────────────── */
+/*
+ * One row. Strings live in the run's string arena (arena.c), never in the
+ * struct, and the fields every table, width and filter pass reads come first,
+ * so a row is 160 bytes on 64-bit, the first 72 hot, where it was ~4.7 KB.
+ */
 typedef struct {
-    char         path[PATH_MAX];
-    char         branch[256];
+    const char  *path;             /* g_paths[i] */
+    const char  *branch;           /* interned; "" until known */
+    size_t       ahead;
+    size_t       behind;
+    git_time_t   last_commit;
     int          staged;
     int          modified;
     int          untracked;
-    size_t       ahead;
-    size_t       behind;
     int          has_remote;
-    git_time_t   last_commit;
+    int          wt_group;         /* linked-worktree group (index + 1), 0 = standalone */
+    bool         wt_linked;        /* a linked worktree (.git is a file), not the main one */
+    bool         timed_out;        /* status_timeout hit; fields hold cached values, if any */
+    const char  *wt_main;          /* name of the main worktree; owned by the group table */
+
+    /* what the subcommands did */
     SwitchResult switch_result;
     FetchResult  fetch_result;
     PullResult   pull_result;
-    char         net_error[256];   /* libgit2 error message on fetch/pull failure */
+    ProbeResult  probe_result;
+    ExecResult   exec_result;
+    int          exec_status;      /* exit code, -1 if killed by a signal */
+    char        *exec_out;         /* its captured output, owned; NULL if none */
+    bool         exec_cut;         /* ... of which only the first EXEC_OUT_CAP-1 bytes */
+    long         exec_ms;
+    int          fetch_refs;       /* remote-tracking refs and tags the fetch changed */
+    size_t       fetch_new;        /* commits it added to the branch's upstream */
+    const char  *net_error;        /* fetch/pull/probe failure message, "" if none */
+    uint64_t     net_bytes;        /* received by its fetch, as git or libgit2 counts it */
+    size_t       net_objects;
+    long         net_ms;           /* wall time of its fetch children, retries included */
 } Repo;
 
 /* ── Global options (defined in main.c) ───────────────────────────────────── */
@@ -88,9 +215,29 @@ extern bool   opt_switch;
 extern char   opt_switch_branch[256];
 extern bool   opt_fetch;
 extern bool   opt_pull;
+extern bool   opt_probe;
 extern bool   opt_watch;
 extern int    opt_watch_interval;
 extern bool   opt_dirty_only;
+extern int    opt_status_timeout;
+extern int    opt_prefetch_depth;
+extern JobOrder opt_job_order;
+extern int    opt_jobs;           /* Phase 1 threads, 0 = one per usable CPU (max 8) */
+extern int    opt_net_jobs;       /* Phase 2 git children, 0 = DEFAULT_NET_JOBS */
+extern int    opt_host_jobs;      /* Phase 2 children per remote host, 0 = no cap */
+extern bool   opt_native_fetch;   /* fetch in-process via libgit2 where it can */
+extern long   opt_max_age;        /* seconds; skip fetches newer than this, 0 = off */
+extern bool   opt_shared_cache;   /* fetch shared upstreams once, into a local mirror */
+extern bool   opt_narrow;         /* fetch only the upstream (and the -s target) */
+extern long   opt_net_timeout;    /* seconds per fetch/pull/probe child, 0 = none */
+extern int    opt_net_retries;    /* extra fetch attempts after a transient failure */
+extern int    opt_host_fail_limit;/* failures in a row that mark a host down, 0 = never */
+extern long   opt_host_cooldown;  /* seconds before a down host is tried again */
+extern bool   opt_net_stats;      /* --net-stats: rank repos by network time */
+extern bool   opt_exec;           /* `gitls exec`: run opt_exec_argv in every repo */
+extern char **opt_exec_argv;      /* NULL-terminated, points into main's argv */
+extern OutputFormat opt_format;   /* --format */
+extern Progressive opt_progressive; /* --progressive */
 extern char   opt_default_dir[PATH_MAX];
 extern char **opt_extra_skip;
 extern size_t opt_extra_skip_count;
@@ -102,38 +249,178 @@ extern char **g_paths;
 extern size_t g_path_count;
 extern char **g_recent_branches;
 extern size_t g_recent_branch_count;
+extern NetHostStat *g_net_hosts;   /* network hosts fetched from, by bytes, descending */
+extern size_t g_net_host_count;
+extern long   g_net_wall_ms;       /* Phase 2 wall time */
 
 /* ── Function prototypes ───────────────────────────────────────────────────── */
 
 /* config.c */
 void load_config(void);
+bool parse_duration(const char *s, long *out);
+
+/* arena.c */
+typedef struct StrArena StrArena;
+StrArena   *arena_new(void);
+void        arena_free(StrArena *a);
+void        arena_reset(StrArena *a);
+char       *arena_strdup(StrArena *a, const char *s);
+const char *arena_intern(StrArena *a, const char *s);
+size_t      arena_footprint(StrArena *a);
+
+/* frame.c */
+void frame_init(Frame *f, size_t spill);
+void frame_free(Frame *f);
+void frame_write(Frame *f, const char *s, size_t n);
+void frame_puts(Frame *f, const char *s);
+void frame_printf(Frame *f, const char *fmt, ...);
+void frame_pad(Frame *f, int n);
+void frame_append(Frame *f, const Frame *src);
+bool frame_flush(Frame *f);
+
+/* width.c */
+int         utf8_width(const char *s);
+size_t      utf8_byte_len_for_width(const char *s, int max_w, int *width);
+size_t      utf8_skip_width(const char *s, int cols);
+bool        width_kernel_set(WidthKernel k);
+WidthKernel width_kernel(void);
+
+/* cpus.c */
+int  available_cpus(void);
+
+/* pool.c */
+void pool_start(int nthreads);
+void pool_stop(void);
+int  pool_size(void);
+void pool_submit(TaskGroup *g, void (*fn)(void *), void *arg);
+void pool_wait(TaskGroup *g);
+void pool_compensate(void);
+void pool_release(void);
+
+/* cache.c */
+bool cache_dir(char *out, size_t n, bool create);
+long timings_get(const char *path, TimingPhase phase);
+void timings_put(const char *path, TimingPhase phase, long ms);
+void timings_save(void);
+void timings_free(void);
+HostAdmit host_admit(const char *host, void (*resume)(void *), void *arg);
+void host_report(const char *host, HostOutcome outcome);
+void hosts_save(void);
+void hosts_free(void);
+bool widths_get(const char *dir, ColWidths *w);
+void widths_put(const char *dir, const ColWidths *w);
 
 /* repo.c */
 void resolve_git_path(void);
 int  git_available(void);
 void collect_path(const char *path);
 void process_all_repos(const char *dir);
+int  status_jobs(void);
+int  net_jobs(void);
 void free_repo_collection(void);
+void free_repo_strings(void);
+void drop_status_cache(void);
+bool workers_outstanding(void);
+bool resolve_git_dirs(const char *path, char *gitdir, char *commondir, size_t n,
+                      bool *linked);
 void collect_recent_branches(void);
 void free_recent_branches(void);
+void net_account(const char *host, uint64_t bytes, size_t objects, long ms);
+
+/* net.c */
+typedef struct NetExec NetExec;
+/* Called on the loop thread when a child exits: exit code (127 if it could
+ * not be started, -1 if killed, NETEXEC_CANCELLED after netexec_cancel,
+ * NETEXEC_TIMEDOUT past the timeout), its combined output without trailing
+ * newlines, whether some of that output did not fit, and its wall time. */
+typedef void (*NetDoneFn)(void *ctx, int status, const char *out, bool cut, long ms);
+#define NETEXEC_CANCELLED (-2)
+#define NETEXEC_TIMEDOUT  (-3)
+/* An in-process job: runs on its own thread, writes a message into out and
+ * returns a status in the same terms. */
+typedef int (*NetCallFn)(void *arg, char *out, size_t outcap);
+NetExec *netexec_new(const char *prog, int max_children, int host_max);
+void     netexec_free(NetExec *ex);
+void     netexec_hold(NetExec *ex);
+void     netexec_release(NetExec *ex);
+void     netexec_spawn(NetExec *ex, const char *host, const char *const *argv,
+                       size_t outcap, bool progress, NetDoneFn done, void *ctx);
+void     netexec_spawn_within(NetExec *ex, const char *host, const char *const *argv,
+                              size_t outcap, bool progress, long ms,
+                              NetDoneFn done, void *ctx);
+void     netexec_call(NetExec *ex, const char *host, NetCallFn fn, void *arg,
+                      size_t outcap, NetDoneFn done, void *ctx);
+void     netexec_delay(NetExec *ex, long ms, NetDoneFn done, void *ctx);
+void     netexec_set_timeout(NetExec *ex, long ms);
+void     netexec_run(NetExec *ex);
+void     netexec_cancel(void);
+bool     netexec_cancelled(void);
+bool     netexec_stopping(void);
+void     netexec_cancel_reset(void);
+void     netexec_on_signal(int sig);
+bool     remote_host(const char *url, char *out, size_t n);
+bool     git_transfer_stats(const char *out, uint64_t *bytes, size_t *objects);
+
+/* exec.c */
+bool exec_where_add(const char *spec);
+bool exec_where_match(const Repo *r);
+void exec_where_free(void);
+void run_exec(const char *dir);
+
+/* ndjson.c */
+int  utf8_seq(const unsigned char *s);
+void ndjson_repo(const Repo *r);
+void ndjson_summary(void);
+
+/* progressive.c */
+void progressive_start(const char *dir);
+void progressive_repo(size_t i);
+bool progressive_end(Frame *f, ColWidths *w);
+
+/* objcache.c */
+typedef struct ObjCache ObjCache;
+typedef enum {
+    OBJCACHE_DIRECT = 0,    /* fetch from origin as usual */
+    OBJCACHE_READY,         /* fetch from the up-to-date mirror */
+    OBJCACHE_PARKED,        /* the mirror is being fetched; resumed when done */
+} ObjCacheState;
+ObjCache     *objcache_new(void);
+void          objcache_free(ObjCache *oc);
+void          objcache_count(ObjCache *oc, const char *url, const char *path);
+ObjCacheState objcache_acquire(ObjCache *oc, NetExec *ex, const char *url,
+                               void (*resume)(void *), void *arg,
+                               char *path, size_t n);
+
+/* prefetch.c */
+typedef struct Prefetcher Prefetcher;
+Prefetcher *prefetch_start(char **paths, const size_t *order, size_t n,
+                           _Atomic size_t *cursor, int depth);
+void        prefetch_kick(Prefetcher *pf);
+void        prefetch_stop(Prefetcher *pf);
+void        sort_by_location(char **paths, size_t *order, size_t n);
 
 /* display.c */
 const char *C(const char *color);
 const char *EOL(void);
 int         term_width(void);
-const char *ellipsize(const char *s, int max_w);
-int         utf8_width(const char *s);
-const char *relative_time(git_time_t t);
-void        write_col(const char *s, int width);
+const char *ellipsize(const char *s, int max_w, char *buf, size_t n);
+const char *relative_time(git_time_t t, char *buf, size_t n);
+void        write_col(Frame *f, const char *s, int width);
+void        col_widths_add(ColWidths *w, const Repo *r);
+void        col_widths_fit(ColWidths *w);
 ColWidths   compute_col_widths(void);
-void        print_separator(const ColWidths *w);
-void        print_header(const ColWidths *w);
-void        print_repo(const Repo *r, const ColWidths *w);
+void        print_separator(Frame *f, const ColWidths *w);
+void        print_header(Frame *f, const ColWidths *w);
+void        print_repo(Frame *f, const Repo *r, const ColWidths *w);
 bool        repo_is_dirty(const Repo *r);
-void        print_status_table(const ColWidths *w, bool dirty_only);
-void        print_switch_summary(const ColWidths *w);
-void        print_fetch_summary(const ColWidths *w);
-void        print_pull_summary(const ColWidths *w);
+void        print_status_table(Frame *f, const ColWidths *w, bool dirty_only);
+void        print_table_footer(Frame *f, const ColWidths *w, bool dirty_only);
+void        print_switch_summary(Frame *f, const ColWidths *w);
+void        print_fetch_summary(Frame *f, const ColWidths *w);
+void        print_pull_summary(Frame *f, const ColWidths *w);
+void        print_probe_summary(Frame *f, const ColWidths *w);
+void        print_net_stats(Frame *f, const ColWidths *w);
+void        print_exec_summary(Frame *f, const ColWidths *w);
 void        spinner_start(const char *msg);
 void        spinner_stop(void);
 
@@ -22,9 +22,29 @@ bool   opt_switch             = false;
 char   opt_switch_branch[256] = "";
 bool   opt_fetch              = false;
 bool   opt_pull               = false;
+bool   opt_probe              = false;
 bool   opt_watch              = false;
 int    opt_watch_interval     = 3;
 bool   opt_dirty_only         = false;
+int    opt_status_timeout     = 0;
+int    opt_prefetch_depth     = 16;
+JobOrder opt_job_order        = ORDER_LONGEST;
+int    opt_jobs               = 0;
+int    opt_net_jobs           = 0;
+int    opt_host_jobs          = 0;
+bool   opt_native_fetch       = true;
+long   opt_max_age            = 0;
+bool   opt_shared_cache       = false;
+bool   opt_narrow             = false;
+long   opt_net_timeout        = 0;
+int    opt_net_retries        = 2;
+int    opt_host_fail_limit    = 3;
+long   opt_host_cooldown      = 600;
+bool   opt_net_stats          = false;
+bool   opt_exec               = false;
+char **opt_exec_argv          = NULL;
+OutputFormat opt_format    = FMT_TABLE;
+Progressive opt_progressive = PROG_OFF;
 char   opt_default_dir[PATH_MAX] = "";
 char **opt_extra_skip         = NULL;
 size_t opt_extra_skip_count   = 0;
@@ -47,10 +67,30 @@ static bool is_all_digits(const char *s) {
     return true;
 }
 
+/* Parse the value of -j / --net-jobs into *out; false (with a message) if it
+ * is missing or not in 1..MAX_JOBS. */
+static bool parse_jobs(int argc, char **argv, int *i, int *out) {
+    const char *flag = argv[*i];
+    if (*i + 1 >= argc) {
+        fprintf(stderr, "Error: %s requires a number\n", flag);
+        return false;
+    }
+    char *end;
+    errno = 0;
+    long n = strtol(argv[++*i], &end, 10);
+    if (*end != '\0' || errno == ERANGE || n < 1 || n > MAX_JOBS) {
+        fprintf(stderr, "Error: %s requires a number between 1 and %d\n", flag, MAX_JOBS);
+        return false;
+    }
+    *out = (int)n;
+    return true;
+}
+
 /* ── Usage ─────────────────────────────────────────────────────────────────── */
 static void usage(const char *prog) {
     fprintf(stderr,
-        "Usage: %s [fetch|pull] [OPTIONS] [DIRECTORY]\n"
+        "Usage: %s [fetch|pull|probe] [OPTIONS] [DIRECTORY]\n"
+        "       %s exec [--where <cond>] [OPTIONS] [DIRECTORY] -- COMMAND [ARGS...]\n"
         "\n"
         "Recursively scan DIRECTORY (default: .) for git repositories\n"
         "and display their status.\n"
@@ -58,10 +98,23 @@ static void usage(const char *prog) {
         "Subcommands:\n"
         "  fetch        Fetch all repos from their remote\n"
         "  pull         Fast-forward pull all clean repos\n"
+        "  probe        Ask each remote whose upstream changed, without fetching\n"
+        "  exec         Run COMMAND in every repo, -j at a time, and collect the results\n"
         "\n"
         "Options:\n"
         "  -s <branch>  Switch all clean repos to <branch> if it exists\n"
         "  -d <n>       Max search depth (default: 5)\n"
+        "  -j, --jobs <n>  Threads for local status queries (default: usable CPUs, max 8)\n"
+        "  --net-jobs <n>  Concurrent fetch/pull operations (default: 16)\n"
+        "  --max-age <t>   Skip fetching repos fetched less than t ago (30s, 10m, 2h, 1d)\n"
+        "  --narrow     Fetch only each repo's upstream branch (and the -s branch), no tags\n"
+        "  --net-stats  After fetch/pull, rank repos by network time and bytes received\n"
+        "  --format <f> table (default), or ndjson: one JSON object per repo as it\n"
+        "               finishes, then a summary object\n"
+        "  --progressive[=scan|done]  Print each row as its repo finishes, in scan\n"
+        "               order (default) or in the order they finish\n"
+        "  --where <c>  exec: only in repos meeting c (dirty, clean, modified, untracked,\n"
+        "               ahead, behind, upstream, branch=NAME; '!' negates, ',' joins)\n"
         "  -w, --watch [n]  Watch mode: refresh the table every n seconds (default: 3)\n"
         "  --dirty      Only list repos that are not both clean and in sync\n"
         "  --no-dirty   Show all repos (overrides dirty_only from the config)\n"
@@ -77,42 +130,69 @@ static void usage(const char *prog) {
         "  skip_dirs=build,dist,tmp\n"
         "  watch_interval=5\n"
         "  dirty_only=true\n"
+        "  status_timeout=10\n"
+        "  jobs=4\n"
+        "  net_jobs=32\n"
+        "  max_age=10m\n"
+        "  net_timeout=2m\n"
+        "  host_fail_limit=3\n"
+        "  narrow_fetch=true\n"
         "  no_color=true\n",
-        prog);
+        prog, prog);
 }
 
 /* ── main ──────────────────────────────────────────────────────────────────── */
 int main(int argc, char **argv) {
-    /* Force English git output for string matching in do_pull/do_fetch.
-     * Set here in the parent before any threads start so the child in
-     * run_git_capture only needs dup2+execvp (no libc locks between fork/exec). */
-    setenv("LC_ALL", "C", 1);
-
     /* 1. load config – CLI flags parsed next will override these */
     load_config();
 
     /* 2. subcommand detection – may appear before or after global flags.
-     *    Skip option flags and their argument values (-s <branch>, -d <n>)
-     *    so that e.g. "gitls -s fetch" does not misidentify "fetch" as a
-     *    subcommand when it is the branch name for -s. */
+     *    Skip option flags and their argument values (-s <branch>, -d <n>,
+     *    -j <n>, --net-jobs <n>) so that e.g. "gitls -s fetch" does not
+     *    misidentify "fetch" as a subcommand when it is the branch name for -s.
+     *    Nothing after "--" is ours: it is the command for exec. */
     int subcommand_idx = -1;
     for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) break;
         if (argv[i][0] == '-') {
-            if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-d") == 0) && i + 1 < argc)
+            if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "-d") == 0
+                    || strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0
+                    || strcmp(argv[i], "--net-jobs") == 0
+                    || strcmp(argv[i], "--max-age") == 0
+                    || strcmp(argv[i], "--where") == 0
+                    || strcmp(argv[i], "--format") == 0) && i + 1 < argc)
                 i++; /* skip the option's value token */
             continue;
         }
         if (strcmp(argv[i], "fetch") == 0) { opt_fetch = true;  subcommand_idx = i; break; }
         if (strcmp(argv[i], "pull")  == 0) { opt_pull  = true;  subcommand_idx = i; break; }
+        if (strcmp(argv[i], "probe") == 0) { opt_probe = true;  subcommand_idx = i; break; }
+        if (strcmp(argv[i], "exec")  == 0) { opt_exec  = true;  subcommand_idx = i; break; }
     }
 
+    /* Force English git output: fetch_retryable, host_outcome,
+     * narrow_target_missing and git_transfer_stats match git's messages.
+     * The git children net.c posix_spawns inherit it from environ; set here,
+     * before any thread starts, since setenv is not thread-safe.
+     * exec runs the user's own command, in the user's own locale. */
+    if (!opt_exec)
+        setenv("LC_ALL", "C", 1);
+
     /* 3. option parsing – skip the subcommand token */
     const char *scan_dir = ".";
     bool user_gave_dir = false;
+    bool where_given = false;
 
     for (int i = 1; i < argc; i++) {
         if (i == subcommand_idx) continue;
-        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+        if (strcmp(argv[i], "--") == 0) {
+            if (!opt_exec) {
+                fprintf(stderr, "Error: a command after '--' is only run by 'exec'\n");
+                return 1;
+            }
+            opt_exec_argv = &argv[i + 1];   /* argv[argc] is NULL */
+            break;
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             usage(argv[0]);
             return 0;
         } else if (strcmp(argv[i], "--version") == 0) {
@@ -134,6 +214,45 @@ int main(int argc, char **argv) {
                 return 1;
             }
             opt_max_depth = (int)depth;
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+            if (!parse_jobs(argc, argv, &i, &opt_jobs)) return 1;
+        } else if (strcmp(argv[i], "--net-jobs") == 0) {
+            if (!parse_jobs(argc, argv, &i, &opt_net_jobs)) return 1;
+        } else if (strcmp(argv[i], "--max-age") == 0 || strncmp(argv[i], "--max-age=", 10) == 0) {
+            const char *v = argv[i][9] == '=' ? argv[i] + 10
+                          : i + 1 < argc      ? argv[++i] : NULL;
+            if (!v || !parse_duration(v, &opt_max_age)) {
+                fprintf(stderr, "Error: --max-age requires a duration such as 90s, 10m, 2h or 1d\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--narrow") == 0) {
+            opt_narrow = true;
+        } else if (strcmp(argv[i], "--net-stats") == 0) {
+            opt_net_stats = true;
+        } else if (strcmp(argv[i], "--format") == 0 || strncmp(argv[i], "--format=", 9) == 0) {
+            const char *v = argv[i][8] == '=' ? argv[i] + 9
+                          : i + 1 < argc      ? argv[++i] : NULL;
+            if (v && strcmp(v, "table") == 0) {
+                opt_format = FMT_TABLE;
+            } else if (v && strcmp(v, "ndjson") == 0) {
+                opt_format = FMT_NDJSON;
+            } else {
+                fprintf(stderr, "Error: --format requires 'table' or 'ndjson'\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--progressive") == 0
+                   || strcmp(argv[i], "--progressive=scan") == 0) {
+            opt_progressive = PROG_SCAN;
+        } else if (strcmp(argv[i], "--progressive=done") == 0) {
+            opt_progressive = PROG_DONE;
+        } else if (strncmp(argv[i], "--progressive=", 14) == 0) {
+            fprintf(stderr, "Error: --progressive takes 'scan' or 'done'\n");
+            return 1;
+        } else if (strcmp(argv[i], "--where") == 0 || strncmp(argv[i], "--where=", 8) == 0) {
+            const char *v = argv[i][7] == '=' ? argv[i] + 8
+                          : i + 1 < argc      ? argv[++i] : NULL;
+            if (!exec_where_add(v)) return 1;
+            where_given = true;
         } else if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--watch") == 0) {
             opt_watch = true;
             /* optional numeric interval immediately following -w */
@@ -167,12 +286,36 @@ int main(int argc, char **argv) {
     }
 
     /* 4. validate subcommand/flag combinations */
+    if (opt_exec && (!opt_exec_argv || !opt_exec_argv[0])) {
+        fprintf(stderr, "Error: 'exec' requires a command after '--'\n");
+        return 1;
+    }
+    if (where_given && !opt_exec) {
+        fprintf(stderr, "Error: --where only applies to 'exec'\n");
+        return 1;
+    }
+    if (opt_exec && opt_switch) {
+        fprintf(stderr, "Error: 'exec' and '-s' cannot be combined\n");
+        return 1;
+    }
     if (opt_pull && opt_switch) {
         fprintf(stderr, "Error: 'pull' and '-s' cannot be combined\n");
         return 1;
     }
-    if (opt_watch && (opt_fetch || opt_pull || opt_switch)) {
-        fprintf(stderr, "Error: -w cannot be combined with fetch/pull/-s\n");
+    if (opt_probe && opt_switch) {
+        fprintf(stderr, "Error: 'probe' and '-s' cannot be combined\n");
+        return 1;
+    }
+    if (opt_watch && (opt_fetch || opt_pull || opt_probe || opt_exec || opt_switch)) {
+        fprintf(stderr, "Error: -w cannot be combined with fetch/pull/probe/exec/-s\n");
+        return 1;
+    }
+    if (opt_watch && opt_format == FMT_NDJSON) {
+        fprintf(stderr, "Error: -w cannot be combined with --format=ndjson\n");
+        return 1;
+    }
+    if (opt_progressive && (opt_watch || opt_exec || opt_format == FMT_NDJSON)) {
+        fprintf(stderr, "Error: --progressive cannot be combined with -w, exec or --format=ndjson\n");
         return 1;
     }
     if (opt_watch && (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))) {
@@ -209,12 +352,12 @@ int main(int argc, char **argv) {
     /* 6. require git binary for fetch/pull subcommands; resolve its absolute
      *    path here (single-threaded) so run_git_capture can use execve instead
      *    of execvp — execve is async-signal-safe, execvp is not. */
-    if ((opt_fetch || opt_pull) && !git_installed()) {
+    if ((opt_fetch || opt_pull || opt_probe) && !git_installed()) {
         fprintf(stderr, "Error: 'git' is not installed or not in PATH\n");
         git_libgit2_shutdown();
         return 1;
     }
-    if (opt_fetch || opt_pull)
+    if (opt_fetch || opt_pull || opt_probe)
         resolve_git_path();
 
     /* 7. watch mode runs its own render loop (alternate screen, no spinner)
@@ -223,17 +366,35 @@ int main(int argc, char **argv) {
     if (opt_watch) {
         if (git_installed())
             resolve_git_path();
+        /* one pool for every refresh; git children need no pool threads */
+        pool_start(status_jobs());
         run_watch(abs_dir);
+        pool_stop();
+        timings_save();
+        timings_free();
+        hosts_save();
+        hosts_free();
         if (opt_extra_skip) {
             for (size_t i = 0; i < opt_extra_skip_count; i++)
                 free(opt_extra_skip[i]);
             free(opt_extra_skip);
         }
-        git_libgit2_shutdown();
+        if (!workers_outstanding()) {
+            free_repo_strings();
+            git_libgit2_shutdown();
+        }
         return 0;
     }
 
-    /* 8. spinner — Phase 1 always shows "Scanning:" (local queries only).
+    /* rows held back for their turn are printed when it comes: take them in
+     * turn, not slowest first */
+    if (opt_progressive == PROG_SCAN)
+        opt_job_order = ORDER_SCAN;
+
+    /* 8. the worker pool shared by the scan and both phases */
+    pool_start(status_jobs());
+
+    /* 9. spinner — Phase 1 always shows "Scanning:" (local queries only).
      *    fetch/pull get a second spinner in process_all_repos() once repos
      *    are found.  Switch-only uses "Switching:" since that happens in Phase 1. */
     const char *verb = (opt_switch && !opt_fetch && !opt_pull) ? "Switching:"
@@ -245,31 +406,72 @@ int main(int argc, char **argv) {
     spinner_start(spin_label);
     find_repos(abs_dir, 0);
     process_all_repos(abs_dir);
+    if (opt_exec) run_exec(abs_dir);
     spinner_stop();
 
-    ColWidths w = compute_col_widths();
+    int failed = 0;     /* exec commands that did not exit 0 */
+    for (size_t i = 0; i < g_repo_count; i++)
+        if (g_repos[i].exec_result == ER_FAILED) failed++;
 
-    /* ── status table header ── */
-    int tw = term_width();
-    printf("%sScanned:%s %s\n\n", C(COL_BOLD), C(COL_RESET),
-           tw > 0 ? ellipsize(abs_dir, tw - 10) : abs_dir);
+    /* ndjson has written every repo already: close the stream */
+    if (opt_format == FMT_NDJSON) {
+        ndjson_summary();
+        goto cleanup;
+    }
 
-    if (opt_fetch) print_fetch_summary(&w);
-    if (opt_pull)  print_pull_summary(&w);
-    if (opt_switch) print_switch_summary(&w);
+    /* everything below goes out in one write (per MiB into a pipe) */
+    Frame out;
+    frame_init(&out, isatty(STDOUT_FILENO) ? 0 : FRAME_PIPE_SPILL);
 
-    print_status_table(&w, opt_dirty_only);
+    /* --progressive has printed the header and the rows: the footer and the
+     * summaries follow them */
+    ColWidths w;
+    bool streamed = progressive_end(&out, &w);
+    if (streamed) {
+        if (opt_fetch || opt_pull || opt_probe || opt_switch) frame_puts(&out, "\n");
+    } else {
+        w = compute_col_widths();
+
+        /* ── status table header ── */
+        int tw = term_width();
+        char dir_buf[PATH_MAX + 8];
+        frame_printf(&out, "%sScanned:%s %s\n\n", C(COL_BOLD), C(COL_RESET),
+                     tw > 0 ? ellipsize(abs_dir, tw - 10, dir_buf, sizeof(dir_buf)) : abs_dir);
+    }
 
-    /* cleanup */
-    for (size_t i = 0; i < g_path_count; i++)
-        free(g_paths[i]);
-    free(g_paths);
-    free(g_repos);
+    if (opt_fetch) print_fetch_summary(&out, &w);
+    if (opt_pull)  print_pull_summary(&out, &w);
+    if (opt_probe) print_probe_summary(&out, &w);
+    if (opt_net_stats && (opt_fetch || opt_pull)) print_net_stats(&out, &w);
+    if (opt_switch) print_switch_summary(&out, &w);
+
+    /* exec reports on its command, not on the repos' state */
+    if (opt_exec)
+        print_exec_summary(&out, &w);
+    else if (!streamed)
+        print_status_table(&out, &w, opt_dirty_only);
+    frame_flush(&out);
+    frame_free(&out);
+
+cleanup:
+    pool_stop();
+    free_repo_collection();
+    timings_save();
+    timings_free();
+    hosts_save();
+    hosts_free();
+    exec_where_free();
     if (opt_extra_skip) {
         for (size_t i = 0; i < opt_extra_skip_count; i++)
             free(opt_extra_skip[i]);
         free(opt_extra_skip);
     }
-    git_libgit2_shutdown();
-    return 0;
+    /* a worker abandoned by status_timeout may still be inside libgit2;
+     * leave it alone and let process exit tear it down */
+    if (!workers_outstanding()) {
+        free_repo_strings();
+        git_libgit2_shutdown();
+    }
+    if (netexec_cancelled()) return 130;   /* 128 + SIGINT, like the shell */
+    return failed ? 1 : 0;
 }
@@ -0,0 +1,229 @@
+/*
+ * ndjson.c – --format=ndjson: one JSON object per repo, as it finishes
+ *
+ * For pipelines. A repo's object is written the moment its last phase is
+ * done -- Phase 1 when no subcommand follows, else its fetch, pull, probe or
+ * exec -- and one summary object ends the stream. Nothing waits for the
+ * sweep: no column widths, no table, and exec output is written and dropped
+ * as each command exits rather than kept for a report. What stays per repo
+ * is its row in g_repos; the summary is running counts.
+ *
+ *   {"type":"repo","path":"/src/api","name":"api","branch":"main",...,
+ *    "fetch":{"result":"fetched","refs":2,"new_commits":5,...}}
+ *   {"type":"summary","repos":312,"dirty":4,...,"fetch":{"fetched":9,...}}
+ *
+ * An object is only present for a subcommand that ran; "error" only when
+ * there is one. Results are snake_case names. Strings are UTF-8: a byte that
+ * is not (a path, a command's output) is written as U+FFFD.
+ *
+ * Objects go out whole under one lock and stdout is flushed after each, so a
+ * reader sees every repo as soon as it is known and never half a line.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "gitools.h"
+
+static const char *const SWITCH_NAMES[] = {
+    [SR_SWITCHED] = "switched", [SR_CREATED] = "created", [SR_ALREADY] = "already",
+    [SR_DIRTY] = "dirty", [SR_NOT_FOUND] = "not_found", [SR_ERROR] = "error",
+};
+static const char *const FETCH_NAMES[] = {
+    [FR_FETCHED] = "fetched", [FR_UP_TO_DATE] = "up_to_date", [FR_NO_REMOTE] = "no_remote",
+    [FR_ERROR] = "error", [FR_CANCELLED] = "cancelled", [FR_FRESH] = "fresh",
+    [FR_HOST_DOWN] = "host_down",
+};
+static const char *const PULL_NAMES[] = {
+    [PR_PULLED] = "pulled", [PR_UP_TO_DATE] = "up_to_date", [PR_NOT_FF] = "not_ff",
+    [PR_DIRTY] = "dirty", [PR_NO_REMOTE] = "no_remote", [PR_ERROR] = "error",
+    [PR_CANCELLED] = "cancelled", [PR_HOST_DOWN] = "host_down",
+};
+static const char *const PROBE_NAMES[] = {
+    [PB_CHANGED] = "changed", [PB_SAME] = "same", [PB_NO_REMOTE] = "no_remote",
+    [PB_ERROR] = "error", [PB_CANCELLED] = "cancelled", [PB_HOST_DOWN] = "host_down",
+};
+static const char *const EXEC_NAMES[] = {
+    [ER_NA] = "not_matched", [ER_OK] = "ok", [ER_FAILED] = "failed",
+    [ER_CANCELLED] = "cancelled",
+};
+
+#define NAMES(a) (sizeof(a) / sizeof(*(a)))
+
+/* running totals for the summary; guarded by g_lock */
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t   g_seen, g_dirty, g_timed_out;
+static size_t   g_switch[NAMES(SWITCH_NAMES)], g_fetch[NAMES(FETCH_NAMES)],
+                g_pull[NAMES(PULL_NAMES)], g_probe[NAMES(PROBE_NAMES)],
+                g_exec[NAMES(EXEC_NAMES)];
+static uint64_t g_bytes;
+
+/* Length of the valid UTF-8 sequence at s, 0 if there is none. As RFC 3629
+ * has it: no overlong forms (E0 80-9F, F0 80-8F), no UTF-16 surrogates
+ * (ED A0-BF) and nothing past U+10FFFF (F4 90-BF). */
+int utf8_seq(const unsigned char *s) {
+    int n = s[0] < 0x80 ? 1
+          : s[0] >= 0xC2 && s[0] <= 0xDF ? 2
+          : s[0] >= 0xE0 && s[0] <= 0xEF ? 3
+          : s[0] >= 0xF0 && s[0] <= 0xF4 ? 4 : 0;
+    unsigned char lo = 0x80, hi = 0xBF;         /* the second byte's range */
+    switch (s[0]) {
+        case 0xE0: lo = 0xA0; break;
+        case 0xED: hi = 0x9F; break;
+        case 0xF0: lo = 0x90; break;
+        case 0xF4: hi = 0x8F; break;
+    }
+    if (n > 1 && (s[1] < lo || s[1] > hi)) return 0;
+    for (int k = 2; k < n; k++)
+        if ((s[k] & 0xC0) != 0x80) return 0;
+    return n;
+}
+
+/* s as a JSON string, quotes included. */
+static void put_str(const char *s) {
+    const unsigned char *p = (const unsigned char *)s;
+    putchar('"');
+    while (*p) {
+        int n = utf8_seq(p);
+        if (n == 0) {
+            fputs("\\ufffd", stdout);
+            p++;
+        } else if (n > 1) {
+            fwrite(p, 1, (size_t)n, stdout);
+            p += n;
+        } else {
+            switch (*p) {
+                case '"':  fputs("\\\"", stdout); break;
+                case '\\': fputs("\\\\", stdout); break;
+                case '\n': fputs("\\n", stdout);  break;
+                case '\r': fputs("\\r", stdout);  break;
+                case '\t': fputs("\\t", stdout);  break;
+                default:
+                    if (*p < 0x20) printf("\\u%04x", *p);
+                    else           putchar(*p);
+            }
+            p++;
+        }
+    }
+    putchar('"');
+}
+
+static void put_key_str(const char *key, const char *s) {
+    printf(",\"%s\":", key);
+    put_str(s);
+}
+
+/* Per-result counts of one subcommand, as "key":{"name":n,...}. */
+static void put_counts(const char *key, const char *const *names, const size_t *counts,
+                       size_t n) {
+    printf(",\"%s\":{", key);
+    bool first = true;
+    for (size_t k = 0; k < n; k++) {
+        if (!names[k]) continue;
+        printf("%s\"%s\":%zu", first ? "" : ",", names[k], counts[k]);
+        first = false;
+    }
+    putchar('}');
+}
+
+/* Write r's object, unless --dirty leaves it out, and count it. Thread safe. */
+void ndjson_repo(const Repo *r) {
+    if (opt_format != FMT_NDJSON) return;
+    bool subcommand = opt_fetch || opt_pull || opt_probe || opt_exec || opt_switch;
+    bool dirty = repo_is_dirty(r);
+
+    pthread_mutex_lock(&g_lock);
+    g_seen++;
+    if (dirty) g_dirty++;
+    if (r->timed_out) g_timed_out++;
+    if (opt_switch) g_switch[r->switch_result]++;
+    if (opt_fetch)  g_fetch[r->fetch_result]++;
+    if (opt_pull)   g_pull[r->pull_result]++;
+    if (opt_probe)  g_probe[r->probe_result]++;
+    if (opt_exec)   g_exec[r->exec_result]++;
+    g_bytes += r->net_bytes;
+
+    /* --dirty narrows a plain listing; a subcommand reports on every repo */
+    if (opt_dirty_only && !subcommand && !dirty) {
+        pthread_mutex_unlock(&g_lock);
+        return;
+    }
+
+    const char *name = strrchr(r->path, '/');
+    fputs("{\"type\":\"repo\"", stdout);
+    put_key_str("path", r->path);
+    put_key_str("name", name ? name + 1 : r->path);
+    if (r->wt_linked && r->wt_main) put_key_str("worktree_of", r->wt_main);
+    if (r->branch[0]) put_key_str("branch", r->branch);
+    else              fputs(",\"branch\":null", stdout);     /* could not be read */
+    printf(",\"staged\":%d,\"modified\":%d,\"untracked\":%d,\"ahead\":%zu,\"behind\":%zu"
+           ",\"upstream\":%s,\"last_commit\":%lld,\"dirty\":%s,\"timed_out\":%s",
+           r->staged, r->modified, r->untracked, r->ahead, r->behind,
+           r->has_remote ? "true" : "false", (long long)r->last_commit,
+           dirty ? "true" : "false", r->timed_out ? "true" : "false");
+
+    if (opt_switch && r->switch_result != SR_NA)
+        printf(",\"switch\":{\"result\":\"%s\"}", SWITCH_NAMES[r->switch_result]);
+    if (opt_fetch && r->fetch_result != FR_NA) {
+        printf(",\"fetch\":{\"result\":\"%s\",\"refs\":%d,\"new_commits\":%zu"
+               ",\"bytes\":%llu,\"objects\":%zu,\"ms\":%ld",
+               FETCH_NAMES[r->fetch_result], r->fetch_refs, r->fetch_new,
+               (unsigned long long)r->net_bytes, r->net_objects, r->net_ms);
+        if (r->net_error[0]) put_key_str("error", r->net_error);
+        putchar('}');
+    }
+    if (opt_pull && r->pull_result != PR_NA) {
+        printf(",\"pull\":{\"result\":\"%s\",\"bytes\":%llu,\"objects\":%zu,\"ms\":%ld",
+               PULL_NAMES[r->pull_result], (unsigned long long)r->net_bytes,
+               r->net_objects, r->net_ms);
+        if (r->net_error[0]) put_key_str("error", r->net_error);
+        putchar('}');
+    }
+    if (opt_probe && r->probe_result != PB_NA) {
+        printf(",\"probe\":{\"result\":\"%s\"", PROBE_NAMES[r->probe_result]);
+        if (r->net_error[0]) put_key_str("error", r->net_error);
+        putchar('}');
+    }
+    if (opt_exec) {
+        printf(",\"exec\":{\"result\":\"%s\"", EXEC_NAMES[r->exec_result]);
+        if (r->exec_result == ER_OK || r->exec_result == ER_FAILED)
+            printf(",\"status\":%d,\"ms\":%ld", r->exec_status, r->exec_ms);
+        if (r->exec_out) {
+            put_key_str("output", r->exec_out);
+            if (r->exec_cut)
+                fputs(",\"output_cut\":true", stdout);
+        }
+        putchar('}');
+    }
+    fputs("}\n", stdout);
+    fflush(stdout);
+    pthread_mutex_unlock(&g_lock);
+}
+
+/* The closing summary object, once every repo has been written. */
+void ndjson_summary(void) {
+    pthread_mutex_lock(&g_lock);
+    printf("{\"type\":\"summary\",\"repos\":%zu,\"dirty\":%zu,\"timed_out\":%zu",
+           g_seen, g_dirty, g_timed_out);
+    if (opt_switch) put_counts("switch", SWITCH_NAMES, g_switch, NAMES(SWITCH_NAMES));
+    if (opt_fetch)  put_counts("fetch",  FETCH_NAMES,  g_fetch,  NAMES(FETCH_NAMES));
+    if (opt_pull)   put_counts("pull",   PULL_NAMES,   g_pull,   NAMES(PULL_NAMES));
+    if (opt_probe)  put_counts("probe",  PROBE_NAMES,  g_probe,  NAMES(PROBE_NAMES));
+    if (opt_exec)   put_counts("exec",   EXEC_NAMES,   g_exec,   NAMES(EXEC_NAMES));
+    if (opt_fetch || opt_pull) {
+        printf(",\"net\":{\"bytes\":%llu,\"wall_ms\":%ld,\"hosts\":[",
+               (unsigned long long)g_bytes, g_net_wall_ms);
+        for (size_t k = 0; k < g_net_host_count; k++) {
+            const NetHostStat *h = &g_net_hosts[k];
+            printf("%s{\"host\":", k ? "," : "");
+            put_str(h->host);
+            printf(",\"fetches\":%d,\"bytes\":%llu,\"objects\":%zu,\"ms\":%ld}",
+                   h->fetches, (unsigned long long)h->bytes, h->objects, h->ms);
+        }
+        fputs("]}", stdout);
+    }
+    printf(",\"cancelled\":%s}\n", netexec_cancelled() ? "true" : "false");
+    fflush(stdout);
+    pthread_mutex_unlock(&g_lock);
+}
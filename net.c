@@ -0,0 +1,842 @@
+/*
+ * net.c – event-loop executor for git child processes
+ *
+ * Phase 2 used to park one thread per concurrent `git fetch` / `git pull`,
+ * each blocked in fork() + read(). Here a single loop, run by the
+ * coordinating thread, launches the children with posix_spawn (vfork-style:
+ * no page-table copy of a large parent), multiplexes their output pipes with
+ * poll() and reaps them through a pidfd where the kernel has one (Linux 5.3+);
+ * elsewhere it polls waitpid(WNOHANG) on a short timeout. Concurrency is
+ * then just a number (--net-jobs): hundreds of children cost no threads.
+ *
+ * Completion is tied to the child's exit, not to EOF on its pipe: a
+ * grandchild such as an ssh ControlMaster can hold stderr open long after git
+ * is done. Output still buffered when the child exits is drained first.
+ *
+ * Every command carries the host it talks to. At most host_jobs children per
+ * host run at once, and free slots are handed to hosts round-robin, so 800
+ * repos on one server cannot starve the 100 elsewhere, nor trip that server's
+ * rate limits. Commands within one host start in the order they were queued.
+ *
+ * netexec_cancel() -- async-signal-safe, so callable from a SIGINT handler --
+ * stops the loop from starting anything more: queued commands complete at once
+ * with NETEXEC_CANCELLED, running children get SIGTERM (SIGKILL if they are
+ * still there NETEXEC_KILL_MS later) and are reaped as usual, reporting
+ * NETEXEC_CANCELLED unless they had already succeeded. The request stays in
+ * force, for this and any later executor, until netexec_cancel_reset().
+ *
+ * netexec_call() queues an in-process job instead (a native libgit2 fetch):
+ * it shares the slots, host caps and fairness of the children, but runs on a
+ * short-lived thread of its own. It cannot be killed; it is expected to poll
+ * netexec_stopping() and return NETEXEC_CANCELLED.
+ *
+ * With netexec_set_timeout(), a child still running after that long gets
+ * SIGTERM (SIGKILL NETEXEC_KILL_MS later) and a job sees netexec_stopping();
+ * either completes with NETEXEC_TIMEDOUT and "timed out after Ns" as its
+ * output. netexec_spawn_within() gives one child less than that: what is
+ * left of a budget it shares with earlier attempts. netexec_delay() queues
+ * nothing but a timer: its completion runs once the delay is over, taking no
+ * slot (retry backoff).
+ *
+ * A child's output is kept as written, its first outcap-1 bytes. Spawned with
+ * progress set (`git fetch --progress`), it is kept the way a terminal would
+ * show it instead: a '\r' takes the line back to its start, so there is one
+ * final line per counter rather than a buffer full of percentages; and past
+ * outcap, whole lines are dropped -- git's per-ref lines first -- so that the
+ * last one, the "fatal:" that says why, is always there. Either way the
+ * completion is told whether anything was cut.
+ *
+ * netexec_spawn() may be called from any thread; completions run on the loop
+ * thread and should only hand the result on (e.g. submit a pool task).
+ * netexec_run() returns once no child is queued or running and every
+ * netexec_hold() has been released.
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE           /* syscall() */
+#include <sys/syscall.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <spawn.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "gitools.h"
+
+extern char **environ;
+
+#define NETEXEC_KILL_MS 2000    /* grace period between SIGTERM and SIGKILL */
+
+typedef struct NetChild {
+    char            **argv;     /* owned, NULL-terminated */
+    size_t            outcap;
+    bool              progress; /* git --progress output: see child_put */
+    NetDoneFn         done;
+    void             *ctx;
+    size_t            host;     /* index into NetExec.hosts */
+    struct NetChild  *next;     /* queue link */
+
+    NetCallFn         call;     /* in-process job instead of argv */
+    void             *call_arg;
+    _Atomic bool      call_done;
+    struct NetExec   *ex;
+
+    bool              started;
+    bool              killed;   /* sent SIGTERM by a cancel */
+    bool              timed_out;/* ran past the executor's timeout */
+    long              limit_ms; /* a shorter one for this child, 0 = none */
+    _Atomic bool      expired;  /* ... as seen by a job's thread */
+    struct timespec   due;      /* netexec_delay: when to complete */
+    pid_t             pid;
+    int               out_fd;   /* -1 once closed */
+    int               pid_fd;   /* -1 without pidfd support */
+    char             *out;
+    size_t            len;
+    size_t            line;     /* where the current output line starts */
+    bool              cr;       /* saw '\r'; the next byte decides */
+    bool              cut;      /* some output did not fit */
+    bool              exited;
+    int               status;
+    struct timespec   start;
+} NetChild;
+
+typedef struct {
+    char             *name;     /* "" = local or unknown: no per-host cap */
+    NetChild         *qhead, *qtail;
+    int               running;
+} NetHost;
+
+struct NetExec {
+    pthread_mutex_t   lock;     /* hosts, their queues, queued and holds */
+    NetHost          *hosts;
+    size_t            nhosts, hosts_cap;
+    size_t            rr;       /* next host to offer a free slot */
+    size_t            queued;
+    int               holds;
+    int               wake[2];  /* self-pipe: spawn / release from other threads */
+    int               max;
+    int               host_max; /* 0 = unlimited */
+    char              prog[PATH_MAX]; /* what every child runs */
+
+    NetChild         *timers;   /* netexec_delay, unordered */
+    long              timeout_ms;  /* 0 = none */
+
+    NetChild        **run;      /* loop thread only */
+    size_t            nrun;
+    bool              cancelling;
+    struct timespec   cancel_at;
+};
+
+/* Process-wide cancel request: a flag plus a self-pipe the loop polls, so a
+ * signal handler can raise it without touching any executor. */
+static volatile sig_atomic_t g_cancel_req = 0;
+static int                   g_cancel_pipe[2] = { -1, -1 };
+
+static _Thread_local NetChild *t_job = NULL;   /* the job this thread runs */
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+static void set_cloexec(int fd) {
+    int fl = fcntl(fd, F_GETFD);
+    if (fl >= 0) fcntl(fd, F_SETFD, fl | FD_CLOEXEC);
+}
+
+static void wake(NetExec *ex) {
+    char c = 0;
+    ssize_t r = write(ex->wake[1], &c, 1);   /* a full pipe is already awake */
+    (void)r;
+}
+
+/* Each running child holds a pipe and a pidfd; with a few hundred of them the
+ * common 1024 soft limit gets close, so raise it toward the hard limit. */
+static void raise_fd_limit(int max_children) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return;
+    rlim_t want = 2 * (rlim_t)max_children + 256;
+    if (rl.rlim_cur == RLIM_INFINITY || rl.rlim_cur >= want) return;
+    rl.rlim_cur = (rl.rlim_max != RLIM_INFINITY && rl.rlim_max < want) ? rl.rlim_max : want;
+    (void)setrlimit(RLIMIT_NOFILE, &rl);
+}
+
+static bool nonblocking_pipe(int fds[2]) {
+    if (pipe(fds) != 0) return false;
+    for (int k = 0; k < 2; k++) {
+        set_cloexec(fds[k]);
+        fcntl(fds[k], F_SETFL, fcntl(fds[k], F_GETFL) | O_NONBLOCK);
+    }
+    return true;
+}
+
+static void drain(int fd) {
+    char buf[64];
+    while (read(fd, buf, sizeof(buf)) > 0) {}
+}
+
+void netexec_cancel(void) {
+    g_cancel_req = 1;
+    if (g_cancel_pipe[1] >= 0) {
+        ssize_t r = write(g_cancel_pipe[1], "", 1);
+        (void)r;
+    }
+}
+
+bool netexec_cancelled(void) {
+    return g_cancel_req != 0;
+}
+
+/* For a job's callbacks: give up now (cancelled, or past the timeout). */
+bool netexec_stopping(void) {
+    return g_cancel_req != 0 || (t_job && atomic_load(&t_job->expired));
+}
+
+void netexec_cancel_reset(void) {
+    g_cancel_req = 0;
+    if (g_cancel_pipe[0] >= 0) drain(g_cancel_pipe[0]);
+}
+
+/* SIGINT / SIGTERM handler for a one-shot fetch, pull or exec: stop
+ * dispatching, stop the children and fall through to the summaries. A second
+ * signal exits at once. */
+void netexec_on_signal(int sig) {
+    if (netexec_cancelled()) {
+        signal(sig, SIG_DFL);
+        raise(sig);
+        return;
+    }
+    netexec_cancel();
+}
+
+/* Every child runs prog (git, or /bin/sh for exec) with the argv it is given.
+ * Call from the main thread before a handler may call netexec_cancel(). */
+NetExec *netexec_new(const char *prog, int max_children, int host_max) {
+    if (g_cancel_pipe[0] < 0 && !nonblocking_pipe(g_cancel_pipe))
+        g_cancel_pipe[0] = g_cancel_pipe[1] = -1;   /* the flag still works */
+    NetExec *ex = calloc(1, sizeof(*ex));
+    if (!ex) oom();
+    if (!nonblocking_pipe(ex->wake)) { free(ex); return NULL; }
+    pthread_mutex_init(&ex->lock, NULL);
+    ex->max = max_children > 0 ? max_children : 1;
+    ex->host_max = host_max > 0 ? host_max : 0;
+    raise_fd_limit(ex->max);
+    snprintf(ex->prog, sizeof(ex->prog), "%s", prog);
+    ex->run = calloc((size_t)ex->max, sizeof(*ex->run));
+    if (!ex->run) oom();
+    return ex;
+}
+
+void netexec_free(NetExec *ex) {
+    if (!ex) return;
+    close(ex->wake[0]);
+    close(ex->wake[1]);
+    pthread_mutex_destroy(&ex->lock);
+    for (size_t h = 0; h < ex->nhosts; h++) free(ex->hosts[h].name);
+    free(ex->hosts);
+    free(ex->run);
+    free(ex);
+}
+
+/* Before netexec_run(). */
+void netexec_set_timeout(NetExec *ex, long ms) {
+    ex->timeout_ms = ms > 0 ? ms : 0;
+}
+
+void netexec_hold(NetExec *ex) {
+    pthread_mutex_lock(&ex->lock);
+    ex->holds++;
+    pthread_mutex_unlock(&ex->lock);
+}
+
+/* The wake-up is written under the lock: once it is dropped the loop may
+ * return and the executor be freed. */
+void netexec_release(NetExec *ex) {
+    pthread_mutex_lock(&ex->lock);
+    ex->holds--;
+    wake(ex);
+    pthread_mutex_unlock(&ex->lock);
+}
+
+/* Index of host's entry, added if new. Called with ex->lock held. */
+static size_t host_slot(NetExec *ex, const char *host) {
+    for (size_t h = 0; h < ex->nhosts; h++)
+        if (strcmp(ex->hosts[h].name, host) == 0) return h;
+    if (ex->nhosts == ex->hosts_cap) {
+        size_t cap = ex->hosts_cap ? ex->hosts_cap * 2 : 8;
+        NetHost *tmp = realloc(ex->hosts, cap * sizeof(*tmp));
+        if (!tmp) oom();
+        ex->hosts = tmp;
+        ex->hosts_cap = cap;
+    }
+    NetHost *nh = &ex->hosts[ex->nhosts];
+    memset(nh, 0, sizeof(*nh));
+    if (!(nh->name = strdup(host))) oom();
+    return ex->nhosts++;
+}
+
+static NetChild *child_new(size_t outcap, NetDoneFn done, void *ctx) {
+    NetChild *c = calloc(1, sizeof(*c));
+    if (!c) oom();
+    c->outcap = outcap > 0 ? outcap : 1;
+    c->out    = malloc(c->outcap);
+    if (!c->out) oom();
+    c->out[0] = '\0';
+    c->done   = done;
+    c->ctx    = ctx;
+    c->out_fd = c->pid_fd = -1;
+    return c;
+}
+
+static void enqueue(NetExec *ex, const char *host, NetChild *c) {
+    pthread_mutex_lock(&ex->lock);
+    c->ex   = ex;
+    c->host = host_slot(ex, host ? host : "");
+    NetHost *nh = &ex->hosts[c->host];
+    if (nh->qtail) nh->qtail->next = c;
+    else           nh->qhead = c;
+    nh->qtail = c;
+    ex->queued++;
+    pthread_mutex_unlock(&ex->lock);
+    wake(ex);
+}
+
+static NetChild *child_cmd(const char *const *argv, size_t outcap, bool progress,
+                           NetDoneFn done, void *ctx) {
+    NetChild *c = child_new(outcap, done, ctx);
+    c->progress = progress;
+    size_t argc = 0;
+    while (argv[argc]) argc++;
+    c->argv = calloc(argc + 1, sizeof(char *));
+    if (!c->argv) oom();
+    for (size_t k = 0; k < argc; k++)
+        if (!(c->argv[k] = strdup(argv[k]))) oom();
+    return c;
+}
+
+void netexec_spawn(NetExec *ex, const char *host, const char *const *argv,
+                   size_t outcap, bool progress, NetDoneFn done, void *ctx) {
+    enqueue(ex, host, child_cmd(argv, outcap, progress, done, ctx));
+}
+
+/* netexec_spawn, timed out after ms if that is sooner than the executor's
+ * timeout. Without an executor timeout there is none. */
+void netexec_spawn_within(NetExec *ex, const char *host, const char *const *argv,
+                          size_t outcap, bool progress, long ms,
+                          NetDoneFn done, void *ctx) {
+    NetChild *c = child_cmd(argv, outcap, progress, done, ctx);
+    c->limit_ms = ms > 0 ? ms : 1;
+    enqueue(ex, host, c);
+}
+
+void netexec_call(NetExec *ex, const char *host, NetCallFn fn, void *arg,
+                  size_t outcap, NetDoneFn done, void *ctx) {
+    NetChild *c = child_new(outcap, done, ctx);
+    c->call     = fn;
+    c->call_arg = arg;
+    enqueue(ex, host, c);
+}
+
+/* done(ctx, 0, "", false, 0) on the loop thread after ms, or at once (status
+ * NETEXEC_CANCELLED) on a cancel. */
+void netexec_delay(NetExec *ex, long ms, NetDoneFn done, void *ctx) {
+    NetChild *c = child_new(1, done, ctx);
+    clock_gettime(CLOCK_MONOTONIC, &c->due);
+    c->due.tv_sec  += ms / 1000;
+    c->due.tv_nsec += (ms % 1000) * 1000000;
+    if (c->due.tv_nsec >= 1000000000) {
+        c->due.tv_sec++;
+        c->due.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&ex->lock);
+    c->ex     = ex;
+    c->next   = ex->timers;
+    ex->timers = c;
+    pthread_mutex_unlock(&ex->lock);
+    wake(ex);
+}
+
+/* Next child to start: the first host from the round-robin cursor on that has
+ * work queued and is under its cap. Called with ex->lock held. */
+static NetChild *dequeue_fair(NetExec *ex) {
+    for (size_t k = 0; k < ex->nhosts; k++) {
+        size_t h = (ex->rr + k) % ex->nhosts;
+        NetHost *nh = &ex->hosts[h];
+        if (!nh->qhead) continue;
+        if (ex->host_max > 0 && nh->name[0] && nh->running >= ex->host_max) continue;
+        NetChild *c = nh->qhead;
+        nh->qhead = c->next;
+        if (!nh->qhead) nh->qtail = NULL;
+        nh->running++;
+        ex->queued--;
+        ex->rr = h + 1;
+        return c;
+    }
+    return NULL;
+}
+
+static void *call_thread(void *arg) {
+    NetChild *c  = arg;
+    NetExec  *ex = c->ex;                       /* c may be gone once done is set */
+    t_job = c;
+    c->status = c->call(c->call_arg, c->out, c->outcap);
+    t_job = NULL;
+    c->out[c->outcap - 1] = '\0';
+    c->len = strlen(c->out);
+    pthread_mutex_lock(&ex->lock);              /* see netexec_release */
+    atomic_store(&c->call_done, true);
+    wake(ex);
+    pthread_mutex_unlock(&ex->lock);
+    return NULL;
+}
+
+/* Launch c, or mark it finished (status 127, like a failed exec). */
+static void child_start(NetExec *ex, NetChild *c) {
+    clock_gettime(CLOCK_MONOTONIC, &c->start);
+    c->started = true;
+    if (c->call) {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_t tid;
+        if (pthread_create(&tid, &attr, call_thread, c) != 0) {
+            c->exited = true;
+            c->status = 127;
+        }
+        pthread_attr_destroy(&attr);
+        return;
+    }
+    int p[2];
+    if (pipe(p) != 0) { c->exited = true; c->status = 127; return; }
+    set_cloexec(p[0]);
+    set_cloexec(p[1]);
+
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_adddup2(&fa, p[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&fa, p[1], STDERR_FILENO);
+    int rc = ex->prog[0]
+           ? posix_spawn(&c->pid, ex->prog, &fa, NULL, c->argv, environ)
+           : ENOENT;
+    posix_spawn_file_actions_destroy(&fa);
+    close(p[1]);
+    if (rc != 0) {
+        close(p[0]);
+        c->exited = true;
+        c->status = 127;
+        return;
+    }
+    fcntl(p[0], F_SETFL, fcntl(p[0], F_GETFL) | O_NONBLOCK);
+    c->out_fd = p[0];
+#if defined(SYS_pidfd_open)
+    c->pid_fd = (int)syscall(SYS_pidfd_open, c->pid, 0);   /* ENOSYS on old kernels */
+    if (c->pid_fd < 0) c->pid_fd = -1;
+#endif
+}
+
+/* The buffer is full: drop a whole line to make room, so that what a child
+ * says last -- why it failed -- is kept. git's one line per updated ref (they
+ * start with a space) goes first, then the oldest line; the transfer counts
+ * near the top stay as long as anything else can go. False when the line
+ * being written fills the buffer by itself. */
+static bool child_make_room(NetChild *c) {
+    size_t drop = 0, end = 0;                   /* [drop, end), end 0 = nothing */
+    for (size_t k = 0, e; k < c->line; k = e) {
+        e = (size_t)((const char *)memchr(c->out + k, '\n', c->line - k) - c->out) + 1;
+        if (k == 0) end = e;
+        if (c->out[k] == ' ') { drop = k; end = e; break; }
+    }
+    if (end == 0) return false;
+    memmove(c->out + drop, c->out + end, c->len - end);
+    c->len  -= end - drop;
+    c->line -= end - drop;
+    return true;
+}
+
+/* One byte of output. Progress output: "\r\n" ends a line, a lone '\r'
+ * rewinds it, and a full buffer makes room. Anything else is kept as written
+ * up to the cap. */
+static void child_put(NetChild *c, char ch) {
+    if (!c->progress) {
+        if (c->len < c->outcap - 1) c->out[c->len++] = ch;
+        else                        c->cut = true;
+        return;
+    }
+    if (c->cr) {
+        c->cr = false;
+        if (ch != '\n') c->len = c->line;
+    }
+    if (ch == '\r') {
+        c->cr = true;
+        return;
+    }
+    if (c->len == c->outcap - 1) {
+        c->cut = true;
+        if (!child_make_room(c)) return;
+    }
+    c->out[c->len++] = ch;
+    if (ch == '\n') c->line = c->len;
+}
+
+/* Read whatever is available. */
+static void child_read(NetChild *c) {
+    char tmp[4096];
+    for (;;) {
+        ssize_t nr = read(c->out_fd, tmp, sizeof(tmp));
+        if (nr > 0) {
+            for (ssize_t k = 0; k < nr; k++) child_put(c, tmp[k]);
+            continue;
+        }
+        if (nr < 0 && errno == EINTR) continue;
+        if (nr == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close(c->out_fd);                   /* EOF or error */
+            c->out_fd = -1;
+        }
+        return;
+    }
+}
+
+static void child_reap(NetChild *c) {
+    int status;
+    pid_t r = waitpid(c->pid, &status, WNOHANG);
+    if (r == c->pid) {
+        c->exited = true;
+        c->status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        if (c->killed && c->status != 0) c->status = NETEXEC_CANCELLED;
+        else if (c->timed_out && c->status != 0) c->status = NETEXEC_TIMEDOUT;
+    } else if (r < 0 && errno == ECHILD) {
+        c->exited = true;
+        c->status = -1;
+    }
+}
+
+static void child_finish(NetChild *c) {
+    if (c->call && c->timed_out && c->status != 0 && !g_cancel_req)
+        c->status = NETEXEC_TIMEDOUT;
+    if (c->status == NETEXEC_TIMEDOUT) {         /* whatever it said, this is why */
+        snprintf(c->out, c->outcap, "timed out after %lds", c->ex->timeout_ms / 1000);
+        c->len = strlen(c->out);
+        c->cut = false;
+        if (c->out_fd >= 0) { close(c->out_fd); c->out_fd = -1; }
+    }
+    if (c->out_fd >= 0) {
+        child_read(c);                          /* what git wrote before exiting */
+        if (c->out_fd >= 0) close(c->out_fd);
+    }
+    if (c->pid_fd >= 0) close(c->pid_fd);
+    c->out[c->len] = '\0';
+    while (c->len > 0 && (c->out[c->len - 1] == '\n' || c->out[c->len - 1] == '\r'))
+        c->out[--c->len] = '\0';
+
+    long ms = 0;
+    if (c->started) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ms = (now.tv_sec - c->start.tv_sec) * 1000
+           + (now.tv_nsec - c->start.tv_nsec) / 1000000;
+    }
+    c->done(c->ctx, c->status, c->out, c->cut, ms);
+
+    if (c->argv) {
+        for (char **a = c->argv; *a; a++) free(*a);
+        free(c->argv);
+    }
+    free(c->out);
+    free(c);
+}
+
+static long ms_between(const struct timespec *a, const struct timespec *b) {
+    return (b->tv_sec - a->tv_sec) * 1000 + (b->tv_nsec - a->tv_nsec) / 1000000;
+}
+
+/* Stop children past the timeout: SIGTERM (a job is told through
+ * netexec_stopping), then SIGKILL after the grace period. Returns the ms
+ * until the next deadline, -1 if none. */
+static long expire_running(NetExec *ex, const struct timespec *now) {
+    if (ex->timeout_ms == 0) return -1;
+    long next = -1;
+    for (size_t k = 0; k < ex->nrun; k++) {
+        NetChild *c = ex->run[k];
+        if (c->exited) continue;
+        long age = ms_between(&c->start, now);
+        long lim = c->limit_ms > 0 && c->limit_ms < ex->timeout_ms ? c->limit_ms : ex->timeout_ms;
+        long at  = c->timed_out ? lim + NETEXEC_KILL_MS : lim;
+        if (age < at) {
+            if (next < 0 || at - age < next) next = at - age;
+        } else if (!c->timed_out) {
+            c->timed_out = true;
+            if (c->call) atomic_store(&c->expired, true);
+            else         kill(c->pid, SIGTERM);
+            if (!c->call && (next < 0 || NETEXEC_KILL_MS < next)) next = NETEXEC_KILL_MS;
+        } else if (!c->call) {
+            kill(c->pid, SIGKILL);
+        }
+    }
+    return next;
+}
+
+/* Complete the timers that are due (all of them after a cancel). Returns
+ * whether any were, and through *next the ms until the earliest left. */
+static bool fire_timers(NetExec *ex, const struct timespec *now, long *next) {
+    NetChild *due = NULL;
+    *next = -1;
+    pthread_mutex_lock(&ex->lock);
+    for (NetChild **p = &ex->timers; *p; ) {
+        NetChild *c = *p;
+        long left = ms_between(now, &c->due);
+        if (left <= 0 || ex->cancelling) {
+            *p = c->next;
+            c->next = due;
+            due = c;
+            c->status = ex->cancelling ? NETEXEC_CANCELLED : 0;
+        } else {
+            if (*next < 0 || left < *next) *next = left;
+            p = &c->next;
+        }
+    }
+    pthread_mutex_unlock(&ex->lock);
+    bool fired = due != NULL;
+    while (due) {
+        NetChild *c = due;
+        due = c->next;
+        child_finish(c);
+    }
+    return fired;
+}
+
+/* SIGTERM every running child on the first call, SIGKILL the stragglers once
+ * the grace period is over. */
+static void cancel_running(NetExec *ex) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!ex->cancelling) {
+        ex->cancelling = true;
+        ex->cancel_at  = now;
+        for (size_t k = 0; k < ex->nrun; k++) {
+            NetChild *c = ex->run[k];
+            if (c->exited || c->call) continue;   /* jobs stop themselves */
+            c->killed = true;
+            kill(c->pid, SIGTERM);
+        }
+    } else if (ms_between(&ex->cancel_at, &now) >= NETEXEC_KILL_MS) {
+        for (size_t k = 0; k < ex->nrun; k++)
+            if (!ex->run[k]->exited && !ex->run[k]->call) kill(ex->run[k]->pid, SIGKILL);
+    }
+}
+
+void netexec_run(NetExec *ex) {
+    size_t slots = 2 * (size_t)ex->max + 2;
+    struct pollfd *pfd   = calloc(slots, sizeof(*pfd));
+    NetChild     **owner = calloc(slots, sizeof(*owner));   /* NULL: the wake pipe */
+    if (!pfd || !owner) oom();
+
+    for (;;) {
+        if (g_cancel_req) cancel_running(ex);
+
+        /* top up the running set from the queue; after a cancel, flush it */
+        bool flushed = false;
+        for (;;) {
+            pthread_mutex_lock(&ex->lock);
+            NetChild *c = (ex->cancelling || (int)ex->nrun < ex->max)
+                        ? dequeue_fair(ex) : NULL;
+            if (c && ex->cancelling) ex->hosts[c->host].running--;
+            pthread_mutex_unlock(&ex->lock);
+            if (!c) break;
+            if (ex->cancelling) {
+                c->status = NETEXEC_CANCELLED;
+                child_finish(c);
+                flushed = true;
+                continue;
+            }
+            child_start(ex, c);
+            ex->run[ex->nrun++] = c;
+        }
+        if (flushed) continue;                  /* completions may have queued more */
+
+        /* complete exited children; compact the running set */
+        size_t kept = 0;
+        for (size_t k = 0; k < ex->nrun; k++) {
+            NetChild *c = ex->run[k];
+            if (c->call && atomic_load(&c->call_done)) c->exited = true;
+            if (!c->exited) {
+                ex->run[kept++] = c;
+                continue;
+            }
+            pthread_mutex_lock(&ex->lock);
+            ex->hosts[c->host].running--;
+            pthread_mutex_unlock(&ex->lock);
+            child_finish(c);
+        }
+        bool finished_some = kept != ex->nrun;
+        ex->nrun = kept;
+        if (finished_some) continue;            /* completions may have queued more */
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long next_timer;
+        if (fire_timers(ex, &now, &next_timer)) continue;
+        long next_expiry = expire_running(ex, &now);
+
+        pthread_mutex_lock(&ex->lock);
+        bool idle = ex->holds == 0 && ex->queued == 0 && !ex->timers;
+        pthread_mutex_unlock(&ex->lock);
+        if (idle && ex->nrun == 0) break;
+
+        /* wait for output, exits or a wake-up */
+        nfds_t n = 0;
+        bool need_tick = false;
+        owner[n] = NULL;
+        pfd[n++] = (struct pollfd){ .fd = ex->wake[0], .events = POLLIN };
+        if (g_cancel_pipe[0] >= 0 && !ex->cancelling) {
+            owner[n] = NULL;
+            pfd[n++] = (struct pollfd){ .fd = g_cancel_pipe[0], .events = POLLIN };
+        }
+        for (size_t k = 0; k < ex->nrun; k++) {
+            NetChild *c = ex->run[k];
+            if (c->call) continue;              /* reports through the wake pipe */
+            if (c->out_fd >= 0) {
+                owner[n] = c;
+                pfd[n++] = (struct pollfd){ .fd = c->out_fd, .events = POLLIN };
+            }
+            if (c->pid_fd >= 0) {
+                owner[n] = c;
+                pfd[n++] = (struct pollfd){ .fd = c->pid_fd, .events = POLLIN };
+            } else {
+                need_tick = true;               /* waitpid(WNOHANG) sweep below */
+            }
+        }
+        if (ex->cancelling) need_tick = true;  /* SIGKILL deadline */
+        long wait = need_tick ? 50 : -1;
+        if (next_timer >= 0 && (wait < 0 || next_timer < wait))   wait = next_timer;
+        if (next_expiry >= 0 && (wait < 0 || next_expiry < wait)) wait = next_expiry;
+        int ready = poll(pfd, n, wait > INT_MAX ? INT_MAX : (int)wait);
+        if (ready < 0 && errno != EINTR) break;
+
+        for (nfds_t k = 0; ready > 0 && k < n; k++) {
+            if (!pfd[k].revents) continue;
+            NetChild *c = owner[k];
+            if (!c) {
+                drain(pfd[k].fd);               /* wake-up or cancel: re-loop */
+            } else if (pfd[k].fd == c->out_fd) {
+                child_read(c);
+            } else {
+                child_reap(c);                  /* pidfd readable: it exited */
+            }
+        }
+        if (need_tick)
+            for (size_t k = 0; k < ex->nrun; k++)
+                if (!ex->run[k]->call && ex->run[k]->pid_fd < 0 && !ex->run[k]->exited)
+                    child_reap(ex->run[k]);
+    }
+    free(pfd);
+    free(owner);
+}
+
+/* ── Remote host key ───────────────────────────────────────────────────────── */
+/*
+ * The server a remote URL talks to, lower-cased and without user or port:
+ * "https://u@Git.Example.com:8443/x.git" and "git@git.example.com:x.git" both
+ * give "git.example.com". Local paths and file:// URLs give "" (false).
+ */
+bool remote_host(const char *url, char *out, size_t n) {
+    if (n == 0) return false;
+    out[0] = '\0';
+    if (!url) return false;
+
+    const char *h, *end;
+    const char *scheme = strstr(url, "://");
+    if (scheme) {
+        if (strncmp(url, "file://", 7) == 0) return false;
+        h   = scheme + 3;
+        end = h + strcspn(h, "/?#");
+        const char *at = memchr(h, '@', (size_t)(end - h));
+        if (at) h = at + 1;
+    } else {
+        /* scp-like [user@]host:path; a colon after the first slash is a path */
+        const char *colon = strchr(url, ':');
+        const char *slash = strchr(url, '/');
+        if (!colon || (slash && slash < colon)) return false;
+        h   = url;
+        end = colon;
+        const char *at = memchr(h, '@', (size_t)(end - h));
+        if (at) h = at + 1;
+    }
+
+    if (*h == '[') {                           /* [v6 address]:port */
+        const char *close = memchr(h, ']', (size_t)(end - h));
+        if (!close) return false;
+        h++;
+        end = close;
+    } else if (scheme) {
+        const char *port = memchr(h, ':', (size_t)(end - h));
+        if (port) end = port;
+    }
+
+    size_t len = (size_t)(end - h);
+    if (len == 0 || len >= n) return false;
+    for (size_t k = 0; k < len; k++)
+        out[k] = (h[k] >= 'A' && h[k] <= 'Z') ? (char)(h[k] - 'A' + 'a') : h[k];
+    out[len] = '\0';
+    return true;
+}
+
+/* ── git fetch --progress ──────────────────────────────────────────────────── */
+/* "3.06 MiB" (git's humanised size) into bytes; 0 if it is not one. */
+static uint64_t parse_size(const char *p) {
+    char *end;
+    double v = strtod(p, &end);
+    if (end == p || v < 0) return 0;
+    while (*end == ' ') end++;
+    static const struct { const char *unit; double mul; } units[] = {
+        { "GiB", 1073741824.0 }, { "MiB", 1048576.0 }, { "KiB", 1024.0 },
+        { "TiB", 1099511627776.0 }, { "byte", 1.0 },
+    };
+    for (size_t k = 0; k < sizeof(units) / sizeof(units[0]); k++)
+        if (strncmp(end, units[k].unit, strlen(units[k].unit)) == 0)
+            return (uint64_t)(v * units[k].mul);
+    return 0;
+}
+
+/*
+ * What a `git fetch --progress` says it received, added to *bytes and
+ * *objects: "Receiving objects: 100% (126/126), 3.06 MiB | ..., done." when
+ * it keeps the pack, "Unpacking objects: ..." when it explodes it. Small
+ * fetches unpacked without a byte count only have the server's "remote:
+ * Total N" for the objects. False if the output has none of these.
+ */
+bool git_transfer_stats(const char *out, uint64_t *bytes, size_t *objects) {
+    size_t total = 0;
+    bool have_total = false;
+    for (const char *line = out; *line; ) {
+        const char *eol = strchr(line, '\n');
+        if (!eol) eol = line + strlen(line);
+        if (strncmp(line, "Receiving objects: ", 19) == 0
+                || strncmp(line, "Unpacking objects: ", 19) == 0) {
+            const char *open  = memchr(line, '(', (size_t)(eol - line));
+            const char *close = open ? memchr(open, ')', (size_t)(eol - open)) : NULL;
+            if (close) {                        /* (got/all): a failed one stops short */
+                *objects += (size_t)strtoull(open + 1, NULL, 10);
+                if (close[1] == ',' && close + 2 < eol)
+                    *bytes += parse_size(close + 2);
+                return true;
+            }
+        } else if (strncmp(line, "remote: Total ", 14) == 0) {
+            total = (size_t)strtoull(line + 14, NULL, 10);
+            have_total = true;
+        }
+        line = *eol ? eol + 1 : eol;
+    }
+    if (have_total) *objects += total;
+    return have_total;
+}
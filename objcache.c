@@ -0,0 +1,279 @@
+/*
+ * objcache.c – one shared fetch per upstream for many clones of it
+ *
+ * Opt-in (shared_cache=true). When several repos in a run fetch from the same
+ * network URL, gitls keeps a bare mirror of that URL under
+ * $XDG_CACHE_HOME/gitls/mirrors/<hash>.git, updates it with a single
+ * `git fetch` from the network, and the clones then fetch from the mirror on
+ * local disk. N downloads of the same new objects become one download and N
+ * local copies. The clones are never pointed at the mirror (no alternates), so
+ * deleting the cache directory is always safe.
+ *
+ * Phase 1 counts clones per URL; a URL with fewer than two goes straight to
+ * the network as before. The first Phase 2 unit to ask for a URL starts the
+ * mirror fetch on the NetExec and parks; later ones park behind it. When the
+ * fetch finishes every parked unit is resumed through its callback, and if it
+ * failed they fetch directly instead.
+ *
+ * A new mirror would otherwise download the upstream's whole history, which
+ * for a large upstream is far more than the N incremental fetches it saves.
+ * So it is seeded first from the first clone seen, over the local transport
+ * (its origin branches and tags), and the network fetch then only brings
+ * what that clone was missing. The mirror is a full copy of the upstream and
+ * keeps every object it is sent; it is never pruned, so its disk use is about
+ * one more clone per upstream, growing with that upstream.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "gitools.h"
+
+typedef enum { MIRROR_NEW = 0, MIRROR_FETCHING, MIRROR_READY, MIRROR_FAILED } MirrorState;
+
+typedef struct {
+    void (*resume)(void *);
+    void  *arg;
+} Waiter;
+
+typedef struct {
+    ObjCache    *oc;
+    char        *key;           /* normalised URL */
+    char        *url;           /* as configured in the first clone seen */
+    char        *seed;          /* that clone's path, to seed a new mirror from */
+    int          clones;
+    MirrorState  state;
+    char         path[PATH_MAX];
+    char         host[256];     /* the URL's server, for net_account */
+    NetExec     *ex;            /* what the seed's completion fetches on */
+    Waiter      *waiters;
+    size_t       nwait, capwait;
+} Mirror;
+
+struct ObjCache {
+    pthread_mutex_t lock;       /* guards the table and every mirror's state */
+    Mirror        **m;
+    size_t          n, cap;
+};
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+/* Same upstream written with or without a trailing "/" or ".git". */
+static char *url_key(const char *url) {
+    char *k = strdup(url);
+    if (!k) oom();
+    size_t len = strlen(k);
+    while (len > 0 && k[len - 1] == '/') k[--len] = '\0';
+    if (len > 4 && strcmp(k + len - 4, ".git") == 0) k[len - 4] = '\0';
+    return k;
+}
+
+/* Called with oc->lock held. */
+static Mirror *mirror_find(ObjCache *oc, const char *key) {
+    for (size_t i = 0; i < oc->n; i++)
+        if (strcmp(oc->m[i]->key, key) == 0) return oc->m[i];
+    return NULL;
+}
+
+ObjCache *objcache_new(void) {
+    ObjCache *oc = calloc(1, sizeof(*oc));
+    if (!oc) oom();
+    pthread_mutex_init(&oc->lock, NULL);
+    return oc;
+}
+
+/* Only once nothing is parked any more (after Phase 2). */
+void objcache_free(ObjCache *oc) {
+    if (!oc) return;
+    for (size_t i = 0; i < oc->n; i++) {
+        free(oc->m[i]->key);
+        free(oc->m[i]->url);
+        free(oc->m[i]->seed);
+        free(oc->m[i]->waiters);
+        free(oc->m[i]);
+    }
+    free(oc->m);
+    pthread_mutex_destroy(&oc->lock);
+    free(oc);
+}
+
+/* One more clone, at path, fetches from url. Local and file:// remotes are
+ * cheap to fetch already and are not counted. Safe from any thread. */
+void objcache_count(ObjCache *oc, const char *url, const char *path) {
+    char host[256];
+    if (!url || !remote_host(url, host, sizeof(host))) return;
+    char *key = url_key(url);
+    pthread_mutex_lock(&oc->lock);
+    Mirror *m = mirror_find(oc, key);
+    if (m) {
+        m->clones++;
+        free(key);
+    } else {
+        if (oc->n == oc->cap) {
+            size_t cap = oc->cap ? oc->cap * 2 : 16;
+            Mirror **tmp = realloc(oc->m, cap * sizeof(*tmp));
+            if (!tmp) oom();
+            oc->m   = tmp;
+            oc->cap = cap;
+        }
+        m = calloc(1, sizeof(*m));
+        if (!m || !(m->url = strdup(url)) || !(m->seed = strdup(path))) oom();
+        m->oc     = oc;
+        m->key    = key;
+        m->clones = 1;
+        oc->m[oc->n++] = m;
+    }
+    pthread_mutex_unlock(&oc->lock);
+}
+
+static void mirror_done(void *ctx, int status, const char *out, bool cut, long ms);
+
+/* <cache>/mirrors/<64-bit FNV-1a of key>.git, created bare if missing.
+ * *empty: it has no branches yet (new, or never fetched into). */
+static bool mirror_open(Mirror *m, bool *empty) {
+    char dir[PATH_MAX];
+    if (!cache_dir(dir, sizeof(dir), true)) return false;
+    uint64_t h = 1469598103934665603ULL;
+    for (const char *p = m->key; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 1099511628211ULL;
+    }
+    int n = snprintf(m->path, sizeof(m->path), "%s/mirrors", dir);
+    if (n <= 0 || n >= (int)sizeof(m->path)) return false;
+    if (mkdir(m->path, 0700) != 0 && errno != EEXIST) return false;
+    n = snprintf(m->path, sizeof(m->path), "%s/mirrors/%016llx.git",
+                 dir, (unsigned long long)h);
+    if (n <= 0 || n >= (int)sizeof(m->path)) return false;
+
+    git_repository *repo = NULL;
+    if (git_repository_open_bare(&repo, m->path) != 0
+            && git_repository_init(&repo, m->path, 1) != 0)
+        return false;
+    git_reference_iterator *it = NULL;
+    git_reference *ref = NULL;
+    *empty = true;
+    if (git_reference_iterator_glob_new(&it, repo, "refs/heads/*") == 0
+            && git_reference_next(&ref, it) == 0) {
+        *empty = false;
+        git_reference_free(ref);
+    }
+    git_reference_iterator_free(it);
+    git_repository_free(repo);
+    return true;
+}
+
+static void mirror_fetch(Mirror *m, NetExec *ex) {
+    const char *argv[] = { "git", "--git-dir", m->path, "fetch", "--progress",
+                           "--prune", m->url, "+refs/heads/*:refs/heads/*",
+                           "+refs/tags/*:refs/tags/*", NULL };
+    netexec_spawn(ex, m->host, argv, FETCH_OUT_CAP, true, mirror_done, m);
+}
+
+/* NetExec completion for the seed: whatever it managed, the network fetch
+ * follows (unless the run is being cancelled). */
+static void mirror_seeded(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)out;
+    (void)cut;
+    (void)ms;
+    Mirror *m = ctx;
+    if (status == NETEXEC_CANCELLED) {
+        mirror_done(m, status, "", false, 0);
+        return;
+    }
+    mirror_fetch(m, m->ex);
+}
+
+/* NetExec completion for the mirror fetch: wake everyone parked on it. */
+static void mirror_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)cut;
+    Mirror *m = ctx;
+    uint64_t bytes = 0;
+    size_t objects = 0;
+    if (status != NETEXEC_CANCELLED) {
+        git_transfer_stats(out, &bytes, &objects);
+        net_account(m->host, bytes, objects, ms);
+    }
+    pthread_mutex_lock(&m->oc->lock);
+    m->state = status == 0 ? MIRROR_READY : MIRROR_FAILED;
+    Waiter *w = m->waiters;
+    size_t  n = m->nwait;
+    m->waiters = NULL;
+    m->nwait = m->capwait = 0;
+    pthread_mutex_unlock(&m->oc->lock);
+    for (size_t i = 0; i < n; i++) w[i].resume(w[i].arg);
+    free(w);
+}
+
+/*
+ * Where should a clone of url fetch from?
+ *   OBJCACHE_DIRECT   from the network as usual (not shared, or the mirror
+ *                     could not be set up or updated)
+ *   OBJCACHE_READY    from the mirror at path, which is up to date
+ *   OBJCACHE_PARKED   not yet: resume(arg) is called once the mirror fetch
+ *                     is over. The caller must not touch arg's state after
+ *                     this returns, as resume may already be running.
+ */
+ObjCacheState objcache_acquire(ObjCache *oc, NetExec *ex, const char *url,
+                               void (*resume)(void *), void *arg,
+                               char *path, size_t n) {
+    if (!oc || !url) return OBJCACHE_DIRECT;
+    char *key = url_key(url);
+    pthread_mutex_lock(&oc->lock);
+    Mirror *m = mirror_find(oc, key);
+    free(key);
+    if (!m || m->clones < 2) {
+        pthread_mutex_unlock(&oc->lock);
+        return OBJCACHE_DIRECT;
+    }
+
+    bool start = m->state == MIRROR_NEW, empty = false;
+    if (start && !mirror_open(m, &empty)) {
+        m->state = MIRROR_FAILED;
+        start = false;
+    } else if (start) {
+        m->state = MIRROR_FETCHING;
+    }
+    if (m->state == MIRROR_READY) {
+        snprintf(path, n, "%s", m->path);
+        pthread_mutex_unlock(&oc->lock);
+        return OBJCACHE_READY;
+    }
+    if (m->state == MIRROR_FAILED) {
+        pthread_mutex_unlock(&oc->lock);
+        return OBJCACHE_DIRECT;
+    }
+
+    if (m->nwait == m->capwait) {
+        size_t cap = m->capwait ? m->capwait * 2 : 8;
+        Waiter *tmp = realloc(m->waiters, cap * sizeof(*tmp));
+        if (!tmp) oom();
+        m->waiters = tmp;
+        m->capwait = cap;
+    }
+    m->waiters[m->nwait++] = (Waiter){ resume, arg };
+    pthread_mutex_unlock(&oc->lock);
+
+    if (start) {            /* path, url and host are fixed from here on */
+        remote_host(m->url, m->host, sizeof(m->host));
+        m->ex = ex;
+        if (empty) {
+            /* origin's HEAD is a symref, not a branch of the upstream */
+            const char *argv[] = { "git", "--git-dir", m->path, "fetch", "--no-tags",
+                                   m->seed, "+refs/remotes/origin/*:refs/heads/*",
+                                   "^refs/remotes/origin/HEAD",
+                                   "+refs/tags/*:refs/tags/*", NULL };
+            netexec_spawn(ex, "", argv, 1024, false, mirror_seeded, m);
+        } else {
+            mirror_fetch(m, ex);
+        }
+    }
+    return OBJCACHE_PARKED;
+}
@@ -0,0 +1,271 @@
+/*
+ * pool.c – one long-lived work-stealing thread pool
+ *
+ * Started once by main() and shared by every parallel stage: the directory
+ * scan, Phase 1 status queries, Phase 2 fetch/pull and the watch-mode branch
+ * list, so no stage (and no watch refresh) creates or joins threads of its own.
+ *
+ * Each worker owns a deque: tasks it submits go on the bottom and it pops
+ * them from there (depth first, cache warm), while idle workers steal from
+ * the top of someone else's. Tasks submitted from outside the pool go through
+ * a shared FIFO injector queue. Every deque has its own mutex -- tasks here
+ * are milliseconds of libgit2 or syscalls, so a lock-free deque would buy
+ * nothing measurable.
+ *
+ * Completion is tracked per TaskGroup; tasks never wait on other tasks, so a
+ * task that needs follow-up work simply submits it into the same group.
+ *
+ * A task that may block indefinitely (a status query on a stalled mount) can
+ * be written off with pool_compensate(), which adds a thread so the pool keeps
+ * its width; pool_release() from the task, once it finally returns, retires
+ * one surplus thread again.
+ *
+ * If no thread can be started the pool runs every task inline in
+ * pool_submit(), which is also what happens when the pool was never started
+ * (unit tests).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "gitools.h"
+
+typedef struct {
+    void      (*fn)(void *);
+    void       *arg;
+    TaskGroup  *group;
+} Task;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Task           *buf;        /* ring buffer */
+    size_t          cap;
+    size_t          head;       /* top: thieves and the injector's consumers */
+    size_t          count;      /* bottom = head + count - 1: the owner's end */
+} Deque;
+
+static struct {
+    pthread_mutex_t lock;       /* sleeping, lifecycle, the counters below */
+    pthread_cond_t  work;       /* a task was queued, or stop / surplus */
+    pthread_cond_t  done;       /* a group drained or a thread exited */
+    Deque          *deques;     /* [0, nslots) per worker, [nslots] injector */
+    int             nslots;
+    int             live;       /* threads running */
+    int             stuck;      /* written off by pool_compensate */
+    bool            stop;
+    bool            started;
+    _Atomic size_t  queued;     /* tasks sitting in any deque */
+    _Atomic int     surplus;    /* threads to retire */
+} P = { .lock = PTHREAD_MUTEX_INITIALIZER,
+        .work = PTHREAD_COND_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER };
+
+static _Thread_local int t_slot = -1;   /* this thread's deque, -1 = none */
+
+/* ── Deque ─────────────────────────────────────────────────────────────────── */
+static void deque_push(Deque *d, Task t) {
+    pthread_mutex_lock(&d->lock);
+    if (d->count == d->cap) {
+        size_t cap = d->cap ? d->cap * 2 : 64;
+        Task *buf = malloc(cap * sizeof(*buf));
+        if (!buf) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        for (size_t k = 0; k < d->count; k++)
+            buf[k] = d->buf[(d->head + k) % d->cap];
+        free(d->buf);
+        d->buf  = buf;
+        d->cap  = cap;
+        d->head = 0;
+    }
+    d->buf[(d->head + d->count) % d->cap] = t;
+    d->count++;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static bool deque_pop_bottom(Deque *d, Task *out) {
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->count > 0;
+    if (ok) *out = d->buf[(d->head + --d->count) % d->cap];
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static bool deque_pop_top(Deque *d, Task *out) {
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->count > 0;
+    if (ok) {
+        *out    = d->buf[d->head];
+        d->head = (d->head + 1) % d->cap;
+        d->count--;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* ── Workers ───────────────────────────────────────────────────────────────── */
+/* Own deque (newest first), then the injector (oldest first), then steal. */
+static bool take_task(Task *t) {
+    bool ok = (t_slot >= 0 && deque_pop_bottom(&P.deques[t_slot], t))
+           || deque_pop_top(&P.deques[P.nslots], t);
+    int start = t_slot < 0 ? 0 : t_slot + 1;
+    for (int k = 0; !ok && k < P.nslots; k++) {
+        int victim = (start + k) % P.nslots;
+        if (victim != t_slot) ok = deque_pop_top(&P.deques[victim], t);
+    }
+    if (ok) atomic_fetch_sub(&P.queued, 1);
+    return ok;
+}
+
+static void run_task(Task t) {
+    t.fn(t.arg);
+    /* the group may live on the waiter's stack: never touch it after this */
+    if (atomic_fetch_sub(&t.group->pending, 1) == 1) {
+        pthread_mutex_lock(&P.lock);
+        pthread_cond_broadcast(&P.done);
+        pthread_mutex_unlock(&P.lock);
+    }
+}
+
+static bool claim_surplus(void) {
+    int s = atomic_load(&P.surplus);
+    while (s > 0)
+        if (atomic_compare_exchange_weak(&P.surplus, &s, s - 1)) return true;
+    return false;
+}
+
+static void *pool_thread(void *arg) {
+    t_slot = (int)(intptr_t)arg;
+    for (;;) {
+        Task t;
+        if (atomic_load(&P.surplus) == 0 && take_task(&t)) {
+            run_task(t);
+            continue;
+        }
+        pthread_mutex_lock(&P.lock);
+        if (claim_surplus() || (P.stop && atomic_load(&P.queued) == 0)) {
+            P.live--;
+            pthread_cond_broadcast(&P.done);
+            pthread_mutex_unlock(&P.lock);
+            return NULL;
+        }
+        if (atomic_load(&P.queued) == 0 && !P.stop)
+            pthread_cond_wait(&P.work, &P.lock);
+        pthread_mutex_unlock(&P.lock);
+    }
+}
+
+/* Start one detached worker on deque slot (-1: injector and stealing only).
+ * Called with P.lock held. */
+static bool spawn_thread(int slot) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t tid;
+    int rc = pthread_create(&tid, &attr, pool_thread, (void *)(intptr_t)slot);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) return false;
+    P.live++;
+    return true;
+}
+
+/* ── API ───────────────────────────────────────────────────────────────────── */
+void pool_start(int nthreads) {
+    if (P.started || nthreads <= 0) return;
+    P.deques = calloc((size_t)nthreads + 1, sizeof(*P.deques));
+    if (!P.deques) return;                       /* inline mode */
+    for (int k = 0; k <= nthreads; k++)
+        pthread_mutex_init(&P.deques[k].lock, NULL);
+    P.nslots = nthreads;
+    P.stop   = false;
+
+    pthread_mutex_lock(&P.lock);
+    for (int k = 0; k < nthreads; k++) {
+        if (!spawn_thread(k)) {
+            fprintf(stderr, "Warning: could not create worker thread %d\n", k);
+            break;
+        }
+    }
+    P.started = P.live > 0;
+    pthread_mutex_unlock(&P.lock);
+    if (!P.started) {
+        for (int k = 0; k <= nthreads; k++)
+            pthread_mutex_destroy(&P.deques[k].lock);
+        free(P.deques);
+        P.deques = NULL;
+        P.nslots = 0;
+    }
+}
+
+/* Threads available to run tasks; 0 in inline mode. */
+int pool_size(void) {
+    pthread_mutex_lock(&P.lock);
+    int n = P.started ? P.live - P.stuck : 0;
+    pthread_mutex_unlock(&P.lock);
+    return n;
+}
+
+void pool_submit(TaskGroup *g, void (*fn)(void *), void *arg) {
+    if (!P.started) {                            /* inline mode */
+        fn(arg);
+        return;
+    }
+    atomic_fetch_add(&g->pending, 1);
+    Task t = { fn, arg, g };
+    deque_push(&P.deques[t_slot >= 0 ? t_slot : P.nslots], t);
+    atomic_fetch_add(&P.queued, 1);
+    pthread_mutex_lock(&P.lock);
+    pthread_cond_signal(&P.work);
+    pthread_mutex_unlock(&P.lock);
+}
+
+void pool_wait(TaskGroup *g) {
+    pthread_mutex_lock(&P.lock);
+    while (atomic_load(&g->pending) > 0)
+        pthread_cond_wait(&P.done, &P.lock);
+    pthread_mutex_unlock(&P.lock);
+}
+
+/* The calling code has given up on a task that still occupies a thread: add
+ * a thread so the pool stays as wide as it was. */
+void pool_compensate(void) {
+    if (!P.started) return;
+    pthread_mutex_lock(&P.lock);
+    P.stuck++;
+    spawn_thread(-1);        /* failure just leaves the pool one thread short */
+    pthread_mutex_unlock(&P.lock);
+}
+
+/* Called by a written-off task when it finally returns: the pool is now one
+ * thread wider than it should be. */
+void pool_release(void) {
+    if (!P.started) return;
+    pthread_mutex_lock(&P.lock);
+    P.stuck--;
+    atomic_fetch_add(&P.surplus, 1);
+    pthread_cond_broadcast(&P.work);
+    pthread_mutex_unlock(&P.lock);
+}
+
+/* Drain and stop. Threads still stuck in a written-off task are left to die
+ * with the process, so the deques are only freed when every thread is gone. */
+void pool_stop(void) {
+    if (!P.started) return;
+    pthread_mutex_lock(&P.lock);
+    P.stop = true;
+    pthread_cond_broadcast(&P.work);
+    while (P.live > P.stuck)
+        pthread_cond_wait(&P.done, &P.lock);
+    bool idle = (P.live == 0);
+    P.started = false;
+    pthread_mutex_unlock(&P.lock);
+    if (!idle) return;
+    for (int k = 0; k <= P.nslots; k++) {
+        pthread_mutex_destroy(&P.deques[k].lock);
+        free(P.deques[k].buf);
+    }
+    free(P.deques);
+    P.deques = NULL;
+    P.nslots = 0;
+}
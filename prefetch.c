@@ -0,0 +1,222 @@
+/*
+ * prefetch.c – warm the page cache ahead of the Phase 1 workers
+ *
+ * On a cold cache (first run after a reboot, spinning disks) the workers stall
+ * on synchronous reads of each repo's index, packed-refs and pack .idx files,
+ * one repo at a time. A single detached thread walks the Phase 1 queue up to
+ * prefetch_depth repos ahead of the workers' cursor and asks the kernel to read
+ * those files in (POSIX_FADV_WILLNEED, F_RDADVISE on macOS), so the disk is
+ * busy while libgit2 spends CPU on earlier repos.
+ *
+ * The hints are advisory: a failure of any kind is ignored, and files are
+ * opened O_NONBLOCK and skipped unless regular, so a FIFO or device where the
+ * index should be cannot wedge the thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gitools.h"
+
+struct Prefetcher {
+    pthread_mutex_t  lock;      /* guards everything below */
+    pthread_cond_t   cond;      /* signalled by prefetch_kick and prefetch_stop */
+    int              refs;      /* caller + thread */
+    bool             stop;
+    bool             waiting;   /* far enough ahead, until the cursor moves */
+    char           **paths;
+    const size_t    *order;
+    size_t           n;
+    _Atomic size_t  *cursor;    /* workers' queue position in order[] */
+    size_t           depth;
+    size_t           pos;       /* next order[] position to warm */
+};
+
+static void advise_file(const char *path) {
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+#if defined(POSIX_FADV_WILLNEED)
+        (void)posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+        struct radvisory ra = {
+            .ra_offset = 0,
+            .ra_count  = st.st_size > INT_MAX ? INT_MAX : (int)st.st_size,
+        };
+        (void)fcntl(fd, F_RDADVISE, &ra);
+#endif
+    }
+    close(fd);
+}
+
+static void advise_at(const char *dir, const char *name) {
+    char p[PATH_MAX];
+    int m = snprintf(p, sizeof(p), "%s/%s", dir, name);
+    if (m > 0 && m < (int)sizeof(p)) advise_file(p);
+}
+
+/* Hint the files libgit2 reads to open a repo, compute its status and walk
+ * ahead/behind: index and HEAD from the git dir; config, packed-refs, the
+ * commit-graph and every pack index from the common dir. */
+static void warm_repo(const char *path) {
+    char gitdir[PATH_MAX], common[PATH_MAX];
+    bool linked;
+    if (!resolve_git_dirs(path, gitdir, common, sizeof(common), &linked)) return;
+
+    advise_at(gitdir, "index");
+    advise_at(gitdir, "HEAD");
+    advise_at(common, "config");
+    advise_at(common, "packed-refs");
+    advise_at(common, "objects/info/commit-graph");
+
+    char packdir[PATH_MAX];
+    int m = snprintf(packdir, sizeof(packdir), "%s/objects/pack", common);
+    if (m <= 0 || m >= (int)sizeof(packdir)) return;
+    DIR *d = opendir(packdir);
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        size_t len = strlen(e->d_name);
+        if (len > 4 && strcmp(e->d_name + len - 4, ".idx") == 0)
+            advise_at(packdir, e->d_name);
+    }
+    closedir(d);
+}
+
+static void prefetch_unref(Prefetcher *pf) {
+    pthread_mutex_lock(&pf->lock);
+    bool last = (--pf->refs == 0);
+    pthread_mutex_unlock(&pf->lock);
+    if (!last) return;
+    pthread_cond_destroy(&pf->cond);
+    pthread_mutex_destroy(&pf->lock);
+    free(pf);
+}
+
+/* paths / order / cursor belong to the caller and are only read under the lock
+ * while stop is unset; the thread works on its own copy of each path, so
+ * prefetch_stop never has to wait for a hint stuck on a slow mount. */
+static void *prefetch_thread(void *arg) {
+    Prefetcher *pf = arg;
+    pthread_mutex_lock(&pf->lock);
+    while (!pf->stop && pf->pos < pf->n) {
+        size_t cur = atomic_load(pf->cursor);
+        if (pf->pos < cur) pf->pos = cur;           /* workers overtook us */
+        if (pf->pos >= pf->n) break;
+        if (pf->pos >= cur + pf->depth) {           /* far enough ahead */
+            pf->waiting = true;
+            pthread_cond_wait(&pf->cond, &pf->lock);
+            pf->waiting = false;
+            continue;
+        }
+        char *path = strdup(pf->paths[pf->order[pf->pos++]]);
+        if (!path) break;
+        pthread_mutex_unlock(&pf->lock);
+        warm_repo(path);
+        free(path);
+        pthread_mutex_lock(&pf->lock);
+    }
+    pthread_mutex_unlock(&pf->lock);
+    prefetch_unref(pf);
+    return NULL;
+}
+
+Prefetcher *prefetch_start(char **paths, const size_t *order, size_t n,
+                           _Atomic size_t *cursor, int depth) {
+    if (depth <= 0 || n == 0) return NULL;
+    Prefetcher *pf = calloc(1, sizeof(*pf));
+    if (!pf) return NULL;
+    pthread_mutex_init(&pf->lock, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+    pf->refs   = 2;
+    pf->paths  = paths;
+    pf->order  = order;
+    pf->n      = n;
+    pf->cursor = cursor;
+    pf->depth  = (size_t)depth;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t tid;
+    int rc = pthread_create(&tid, &attr, prefetch_thread, pf);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        pthread_cond_destroy(&pf->cond);
+        pthread_mutex_destroy(&pf->lock);
+        free(pf);
+        return NULL;          /* no prefetch is only slower, never wrong */
+    }
+    return pf;
+}
+
+/* The workers moved the cursor on: wake the thread if it was waiting for
+ * that. Must not be called after prefetch_stop. */
+void prefetch_kick(Prefetcher *pf) {
+    if (!pf) return;
+    pthread_mutex_lock(&pf->lock);
+    if (pf->waiting) pthread_cond_signal(&pf->cond);
+    pthread_mutex_unlock(&pf->lock);
+}
+
+/* After this returns the thread no longer reads the caller's arrays. */
+void prefetch_stop(Prefetcher *pf) {
+    if (!pf) return;
+    pthread_mutex_lock(&pf->lock);
+    pf->stop = true;
+    pthread_cond_signal(&pf->cond);
+    pthread_mutex_unlock(&pf->lock);
+    prefetch_unref(pf);
+}
+
+/* ── On-disk ordering ──────────────────────────────────────────────────────── */
+/*
+ * Inode numbers are the portable stand-in for disk position: ext4 and XFS
+ * allocate a directory's inodes, and mostly its blocks, in the same group, and
+ * HFS+/APFS catalog IDs grow with creation time. Visiting git dirs in
+ * (device, inode) order turns a cold-cache scan's random seeks into a mostly
+ * forward sweep. Paths that cannot be stat'ed keep their relative order at the
+ * end.
+ */
+typedef struct {
+    dev_t  dev;
+    ino_t  ino;
+    bool   ok;
+    size_t idx;
+} LocKey;
+
+static int lockey_cmp(const void *a, const void *b) {
+    const LocKey *x = a, *y = b;
+    if (x->ok != y->ok)   return x->ok ? -1 : 1;
+    if (x->ok) {
+        if (x->dev != y->dev) return x->dev < y->dev ? -1 : 1;
+        if (x->ino != y->ino) return x->ino < y->ino ? -1 : 1;
+    }
+    return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+void sort_by_location(char **paths, size_t *order, size_t n) {
+    LocKey *keys = malloc(n * sizeof(*keys));
+    if (!keys) return;        /* scan order is a fine fallback */
+    for (size_t k = 0; k < n; k++) {
+        char dotgit[PATH_MAX];
+        struct stat st;
+        int m = snprintf(dotgit, sizeof(dotgit), "%s/.git", paths[order[k]]);
+        keys[k].idx = order[k];
+        keys[k].ok  = m > 0 && m < (int)sizeof(dotgit) && stat(dotgit, &st) == 0;
+        keys[k].dev = keys[k].ok ? st.st_dev : 0;
+        keys[k].ino = keys[k].ok ? st.st_ino : 0;
+    }
+    qsort(keys, n, sizeof(*keys), lockey_cmp);
+    for (size_t k = 0; k < n; k++) order[k] = keys[k].idx;
+    free(keys);
+}
@@ -0,0 +1,131 @@
+/*
+ * progressive.c – --progressive: table rows printed as their repos finish
+ *
+ * The plain table waits for the last repo; on a big tree that is a spinner
+ * for as long as the slowest repo takes. With --progressive the header goes
+ * out as soon as the scan is done and each row follows the moment its repo is
+ * finished -- after Phase 1, or after its fetch, pull or probe.
+ *
+ *   scan (default)  rows in scan order, as in the plain table. A row finished
+ *                   ahead of its turn is held back until every row above it
+ *                   is out; jobs are started in scan order so that is never
+ *                   for long.
+ *   done            rows in the order their repos finish.
+ *
+ * The column widths cannot wait for the last row. NAME is exact: every path
+ * is known once the scan is done. BRANCH, SYNC and WHEN are what the rows of
+ * the previous progressive run over the same directory needed (the widths
+ * cache), or generous defaults the first time; longer content is cut with
+ * '~' as it is in a narrow terminal. The table's footer and any fetch, pull,
+ * probe or switch summary follow the rows.
+ *
+ * Rows are written under one lock, one write() per repo finished.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "gitools.h"
+
+/* before a directory has saved widths; no WHEN is wider than "11 hours ago" */
+#define GUESS_BRANCH 20
+#define GUESS_SYNC   5
+#define GUESS_TIME   12
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool      g_started = false;
+static ColWidths g_w;           /* what the rows are printed at */
+static ColWidths g_need;        /* what the rows printed so far needed */
+static bool     *g_done;        /* finished, by scan index */
+static size_t    g_next;        /* scan order: first row not yet printed */
+static Frame     g_out;
+static char      g_dir[PATH_MAX];
+
+static void oom(void) {
+    fprintf(stderr, "Error: out of memory\n");
+    exit(1);
+}
+
+/* Print the header with provisional widths. Called once the rows exist,
+ * before any repo is processed; does nothing without --progressive. */
+void progressive_start(const char *dir) {
+    if (opt_progressive == PROG_OFF) return;
+    spinner_stop();
+
+    g_done = calloc(g_repo_count, sizeof(*g_done));
+    if (!g_done) oom();
+    g_next = 0;
+    snprintf(g_dir, sizeof(g_dir), "%s", dir);
+
+    /* an unfinished row has its name and nothing else that is wider */
+    g_w = COL_WIDTHS_MIN;
+    for (size_t i = 0; i < g_repo_count; i++)
+        col_widths_add(&g_w, &g_repos[i]);
+    ColWidths saved;
+    if (widths_get(dir, &saved)) {
+        g_w.branch = MAX(g_w.branch, saved.branch);
+        g_w.sync   = MAX(g_w.sync,   saved.sync);
+        g_w.time   = MAX(g_w.time,   saved.time);
+    } else {
+        g_w.branch = MAX(g_w.branch, GUESS_BRANCH);
+        g_w.sync   = MAX(g_w.sync,   GUESS_SYNC);
+        g_w.time   = MAX(g_w.time,   GUESS_TIME);
+    }
+    col_widths_fit(&g_w);
+    g_need = COL_WIDTHS_MIN;
+
+    frame_init(&g_out, 0);
+    int tw = term_width();
+    char dir_buf[PATH_MAX + 8];
+    frame_printf(&g_out, "%sScanned:%s %s\n\n", C(COL_BOLD), C(COL_RESET),
+                 tw > 0 ? ellipsize(dir, tw - 10, dir_buf, sizeof(dir_buf)) : dir);
+    print_header(&g_out, &g_w);
+    frame_flush(&g_out);
+    g_started = true;
+}
+
+/* Called with g_lock held. */
+static void put_row(size_t i) {
+    const Repo *r = &g_repos[i];
+    col_widths_add(&g_need, r);
+    if (opt_dirty_only && !repo_is_dirty(r)) return;
+    print_repo(&g_out, r, &g_w);
+}
+
+/* Repo i is finished: print its row, or hold it until its turn. Thread safe. */
+void progressive_repo(size_t i) {
+    if (!g_started) return;
+    pthread_mutex_lock(&g_lock);
+    g_done[i] = true;
+    if (opt_progressive == PROG_DONE)
+        put_row(i);
+    while (g_next < g_repo_count && g_done[g_next]) {
+        if (opt_progressive == PROG_SCAN) put_row(g_next);
+        g_next++;
+    }
+    frame_flush(&g_out);
+    pthread_mutex_unlock(&g_lock);
+}
+
+/* Close the table into f and save the widths its rows needed. w gets the
+ * widths it was printed at, for the summaries. False if there was none. */
+bool progressive_end(Frame *f, ColWidths *w) {
+    if (!g_started) return false;
+    pthread_mutex_lock(&g_lock);
+    /* none should be left */
+    for (size_t i = opt_progressive == PROG_SCAN ? g_next : 0; i < g_repo_count; i++)
+        if (opt_progressive == PROG_SCAN || !g_done[i]) put_row(i);
+    frame_flush(&g_out);
+    g_started = false;
+    pthread_mutex_unlock(&g_lock);
+
+    print_table_footer(f, &g_w, opt_dirty_only);
+    widths_put(g_dir, &g_need);
+    *w = g_w;
+    frame_free(&g_out);
+    free(g_done);
+    g_done = NULL;
+    return true;
+}
@@ -5,12 +5,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include <stdatomic.h>
 #include <pthread.h>
 #include <unistd.h>
-#include <sys/wait.h>
+#include <stdint.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/stat.h>
 
-extern char **environ;
 #include "gitools.h"
 
 /* Suppress noisy -Wmissing-field-initializers triggered by libgit2 macros */
@@ -21,9 +24,9 @@ static char g_git_path[PATH_MAX] = "";
 
 /*
  * Walk PATH and store the first executable named "git" in g_git_path.
- * Must be called from the main thread before any threads are spawned so that
- * run_git_capture can use execve(g_git_path) instead of execvp("git").
- * execve is a direct syscall (async-signal-safe); execvp calls getenv+malloc.
+ * Must be called from the main thread before any threads are spawned; the
+ * Phase 2 executor then posix_spawn()s g_git_path directly, with no PATH
+ * search (getenv + malloc) per child.
  */
 /* True once resolve_git_path() has found a usable git binary. */
 int git_available(void) {
@@ -49,6 +52,40 @@ void resolve_git_path(void) {
     }
 }
 
+/* ── Run strings ───────────────────────────────────────────────────────────── */
+/*
+ * Paths, branch names and error messages of the current scan live in
+ * g_strings, rewound (not freed) by free_repo_collection. While watch mode
+ * keeps the previous tick's rows as the status_timeout cache, the arena they
+ * point into is kept too, as g_prev_strings, and the two swap every tick.
+ * Atomic because a worker abandoned by status_timeout may still intern a
+ * branch while the main thread swaps; it writes into either arena, both
+ * outlive it, and its row is discarded anyway.
+ */
+static _Atomic(StrArena *) g_strings      = NULL;
+static StrArena           *g_prev_strings = NULL;
+
+static StrArena *strings(void) {
+    return atomic_load(&g_strings);
+}
+
+/* r->net_error = the formatted message, cut to a summary row's worth */
+static void set_net_error(Repo *r, const char *fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    r->net_error = arena_strdup(strings(), buf);
+}
+
+/* Only once no worker can be running (see workers_outstanding). */
+void free_repo_strings(void) {
+    arena_free(atomic_exchange(&g_strings, NULL));
+    arena_free(g_prev_strings);
+    g_prev_strings = NULL;
+}
+
 /* ── Path collection (filled by scan.c) ────────────────────────────────────── */
 char  **g_paths      = NULL;
 size_t  g_path_count = 0;
@@ -61,15 +98,345 @@ void collect_path(const char *path) {
         if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
         g_paths = tmp;
     }
-    g_paths[g_path_count] = strdup(path);
-    if (!g_paths[g_path_count]) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
-    g_path_count++;
+    if (!strings()) atomic_store(&g_strings, arena_new());
+    g_paths[g_path_count++] = arena_strdup(strings(), path);
 }
 
 /* ── Repo array (pre-allocated before threading) ───────────────────────────── */
 Repo  *g_repos     = NULL;
 size_t g_repo_count = 0;
 
+/* Phase 1 processing order: a permutation of the g_paths indices. Results
+ * still land in g_repos[i], so the table keeps scan order whatever this is. */
+static size_t *g_order = NULL;
+
+/* Phase 2 processing order: standalone repos and worktree-group leaders only
+ * (a leader's worker handles its whole group). */
+static size_t *g_net_order = NULL;
+static size_t  g_net_count = 0;
+
+/* This run's per-repo durations in ms (-1 = not measured), folded into the
+ * timings cache once the phases are over. */
+static long *g_local_ms = NULL;
+static long *g_net_ms   = NULL;
+
+/* shared_cache: clones per upstream, counted in Phase 1, mirrored in Phase 2 */
+static ObjCache *g_objcache = NULL;
+
+/* What Phase 2 pulled from each network host, for the summaries. Added to from
+ * the pool threads and the mirror fetches, sorted once the phase is over. */
+NetHostStat *g_net_hosts      = NULL;
+size_t       g_net_host_count = 0;
+static size_t g_net_host_cap  = 0;
+static pthread_mutex_t g_net_host_lock = PTHREAD_MUTEX_INITIALIZER;
+long         g_net_wall_ms    = 0;
+
+/* Rows of the previous watch tick, kept while status_timeout is set so a repo
+ * that times out can still be shown with its last known values. */
+static Repo  *g_prev_repos = NULL;
+static size_t g_prev_count = 0;
+
+/* Last known row for path (hint: its index in the previous tick), or NULL. */
+static const Repo *cached_status(const char *path, size_t hint) {
+    if (hint < g_prev_count && strcmp(g_prev_repos[hint].path, path) == 0)
+        return g_prev_repos[hint].branch[0] ? &g_prev_repos[hint] : NULL;
+    for (size_t i = 0; i < g_prev_count; i++)
+        if (strcmp(g_prev_repos[i].path, path) == 0)
+            return g_prev_repos[i].branch[0] ? &g_prev_repos[i] : NULL;
+    return NULL;
+}
+
+void drop_status_cache(void) {
+    free(g_prev_repos);
+    g_prev_repos = NULL;
+    g_prev_count = 0;
+    arena_reset(g_prev_strings);
+}
+
+/* ── Linked worktrees ──────────────────────────────────────────────────────── */
+/*
+ * Worktrees created with `git worktree add` share one $GIT_COMMON_DIR (objects,
+ * packed refs, remote-tracking refs) with their main checkout, yet each one is
+ * found by the scan as a repo of its own. Repos sharing a common dir are grouped
+ * before Phase 1 so that every member reads objects through one git_odb (pack
+ * indexes are loaded once), a given (local, upstream) ahead/behind pair is only
+ * walked once, and Phase 2 fetches once per group. The refdb is not shared:
+ * HEAD and other per-worktree refs live there. Only groups with at least two
+ * scanned members are formed.
+ */
+typedef struct {
+    git_oid local, upstream;
+    size_t  ahead, behind;
+} AheadBehindEnt;
+
+typedef struct {
+    char            *main_name;    /* display name of the main worktree */
+    git_odb         *odb;          /* shared by every member; NULL if open failed */
+    size_t           leader;       /* first member in scan order */
+    pthread_mutex_t  ab_lock;      /* guards the ahead/behind memo below */
+    AheadBehindEnt  *ab;
+    size_t           ab_count, ab_cap;
+} WorktreeGroup;
+
+/*
+ * The group table is reference counted: a Phase 1 worker that outlives its
+ * status deadline keeps the table it started with alive until it finishes,
+ * even after the next watch tick has replaced g_wt.
+ */
+typedef struct {
+    _Atomic int    refs;
+    WorktreeGroup *groups;
+    size_t         count;
+    size_t        *next;     /* per repo: next member of its group, SIZE_MAX = last */
+} WorktreeTable;
+
+static WorktreeTable *g_wt = NULL;
+
+static WorktreeTable *wt_table_ref(WorktreeTable *t) {
+    if (t) atomic_fetch_add(&t->refs, 1);
+    return t;
+}
+
+static void wt_table_unref(WorktreeTable *t) {
+    if (!t || atomic_fetch_sub(&t->refs, 1) != 1) return;
+    for (size_t i = 0; i < t->count; i++) {
+        WorktreeGroup *g = &t->groups[i];
+        free(g->main_name);
+        if (g->odb) git_odb_free(g->odb);
+        pthread_mutex_destroy(&g->ab_lock);
+        free(g->ab);
+    }
+    free(t->groups);
+    free(t->next);
+    free(t);
+}
+
+static WorktreeGroup *wt_group_of(WorktreeTable *t, const Repo *r) {
+    return (t && r->wt_group) ? &t->groups[r->wt_group - 1] : NULL;
+}
+
+/* Next member of repo i's worktree group, or SIZE_MAX. */
+static size_t wt_next(size_t i) {
+    return (g_wt && g_repos[i].wt_group) ? g_wt->next[i] : SIZE_MAX;
+}
+
+static bool read_first_line(const char *file, char *out, size_t n) {
+    FILE *f = fopen(file, "r");
+    if (!f) return false;
+    bool ok = fgets(out, (int)n, f) != NULL;
+    fclose(f);
+    if (!ok) return false;
+    size_t len = strlen(out);
+    while (len > 0 && (out[len - 1] == '\n' || out[len - 1] == '\r'))
+        out[--len] = '\0';
+    return len > 0;
+}
+
+/* Collapse "." and ".." components of an absolute path in place (lexically). */
+static void normalize_path(char *p) {
+    if (p[0] != '/') return;
+    size_t w = 0;
+    const char *rd = p;
+    while (*rd) {
+        while (*rd == '/') rd++;
+        if (!*rd) break;
+        const char *seg = rd;
+        while (*rd && *rd != '/') rd++;
+        size_t len = (size_t)(rd - seg);
+        if (len == 1 && seg[0] == '.') continue;
+        if (len == 2 && seg[0] == '.' && seg[1] == '.') {
+            while (w > 0 && p[w - 1] != '/') w--;   /* drop the last component */
+            if (w > 0) w--;                          /* and its slash */
+            continue;
+        }
+        p[w++] = '/';
+        memmove(p + w, seg, len);
+        w += len;
+    }
+    if (w == 0) p[w++] = '/';
+    p[w] = '\0';
+}
+
+/*
+ * Resolve the git dir and common git dir of the checkout at path without
+ * opening it with libgit2: both are <path>/.git for a main worktree; for a
+ * gitfile the git dir is its target and the common dir follows the target's
+ * "commondir" link (linked worktree) or is the git dir itself (e.g. an absorbed
+ * submodule). gitdir and commondir must each hold n bytes.
+ */
+bool resolve_git_dirs(const char *path, char *gitdir, char *commondir, size_t n,
+                      bool *linked) {
+    char dotgit[PATH_MAX];
+    int m = snprintf(dotgit, sizeof(dotgit), "%s/.git", path);
+    if (m <= 0 || m >= (int)sizeof(dotgit)) return false;
+
+    struct stat st;
+    if (stat(dotgit, &st) != 0) return false;
+    *linked = false;
+    if (S_ISDIR(st.st_mode)) {
+        snprintf(gitdir, n, "%s", dotgit);
+        snprintf(commondir, n, "%s", dotgit);
+        return true;
+    }
+
+    char line[PATH_MAX];
+    if (!read_first_line(dotgit, line, sizeof(line)) || strncmp(line, "gitdir: ", 8) != 0)
+        return false;
+    if (line[8] == '/') m = snprintf(gitdir, n, "%s", line + 8);
+    else                m = snprintf(gitdir, n, "%s/%s", path, line + 8);
+    if (m <= 0 || m >= (int)n) return false;
+
+    char cfile[PATH_MAX], rel[PATH_MAX];
+    m = snprintf(cfile, sizeof(cfile), "%s/commondir", gitdir);
+    if (m <= 0 || m >= (int)sizeof(cfile) || !read_first_line(cfile, rel, sizeof(rel))) {
+        snprintf(commondir, n, "%s", gitdir);
+        return true;
+    }
+    if (rel[0] == '/') m = snprintf(commondir, n, "%s", rel);
+    else               m = snprintf(commondir, n, "%s/%s", gitdir, rel);
+    if (m <= 0 || m >= (int)n) return false;
+    normalize_path(commondir);
+    *linked = true;
+    return true;
+}
+
+/* "…/name/.git" → "name", "…/name.git" → "name". */
+static char *main_name_from_common_dir(const char *commondir) {
+    size_t len = strlen(commondir);
+    while (len > 1 && commondir[len - 1] == '/') len--;
+    if (len > 5 && strncmp(commondir + len - 5, "/.git", 5) == 0) len -= 5;
+    else if (len > 4 && strncmp(commondir + len - 4, ".git", 4) == 0) len -= 4;
+    size_t start = len;
+    while (start > 0 && commondir[start - 1] != '/') start--;
+    return strndup(commondir + start, len - start);
+}
+
+typedef struct {
+    dev_t  dev;
+    ino_t  ino;
+    size_t idx;
+    bool   linked;
+    char  *commondir;
+} WtKey;
+
+static int wt_key_cmp(const void *a, const void *b) {
+    const WtKey *x = a, *y = b;
+    if (x->dev != y->dev) return x->dev < y->dev ? -1 : 1;
+    if (x->ino != y->ino) return x->ino < y->ino ? -1 : 1;
+    return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+/*
+ * Group the collected paths by common dir (compared by device/inode, so any
+ * spelling of the same directory matches) and open one shared odb per group.
+ * Runs on the main thread after g_repos is allocated and before Phase 1.
+ */
+static void group_worktrees(void) {
+    WtKey *keys = calloc(g_path_count, sizeof(*keys));
+    if (!keys) return;
+
+    size_t nkeys = 0;
+    for (size_t i = 0; i < g_path_count; i++) {
+        char gitdir[PATH_MAX], common[PATH_MAX];
+        bool linked;
+        struct stat st;
+        if (!resolve_git_dirs(g_paths[i], gitdir, common, sizeof(common), &linked)
+                || stat(common, &st) != 0)
+            continue;
+        keys[nkeys] = (WtKey){ .dev = st.st_dev, .ino = st.st_ino, .idx = i,
+                               .linked = linked, .commondir = strdup(common) };
+        if (keys[nkeys].commondir) nkeys++;
+    }
+    qsort(keys, nkeys, sizeof(*keys), wt_key_cmp);
+
+    WorktreeTable *t = calloc(1, sizeof(*t));
+    if (!t) goto out;
+    atomic_init(&t->refs, 1);
+    t->next = malloc(g_path_count * sizeof(*t->next));
+    if (!t->next) { free(t); goto out; }
+
+    for (size_t a = 0; a < nkeys; ) {
+        size_t b = a + 1;
+        while (b < nkeys && keys[b].dev == keys[a].dev && keys[b].ino == keys[a].ino) b++;
+        if (b - a >= 2) {
+            WorktreeGroup *tmp = realloc(t->groups, (t->count + 1) * sizeof(*tmp));
+            if (!tmp) break;
+            t->groups = tmp;
+            WorktreeGroup *g = &t->groups[t->count++];
+            memset(g, 0, sizeof(*g));
+            pthread_mutex_init(&g->ab_lock, NULL);
+            g->leader = keys[a].idx;   /* keys within a run are sorted by index */
+
+            /* prefer the scanned main worktree's own name for the label */
+            for (size_t k = a; k < b && !g->main_name; k++) {
+                if (keys[k].linked) continue;
+                const char *slash = strrchr(g_paths[keys[k].idx], '/');
+                g->main_name = strdup(slash ? slash + 1 : g_paths[keys[k].idx]);
+            }
+            if (!g->main_name) g->main_name = main_name_from_common_dir(keys[a].commondir);
+
+            char objects[PATH_MAX];
+            int m = snprintf(objects, sizeof(objects), "%s/objects", keys[a].commondir);
+            if (m > 0 && m < (int)sizeof(objects) && git_odb_open(&g->odb, objects) != 0)
+                g->odb = NULL;
+
+            for (size_t k = a; k < b; k++) {
+                Repo *r      = &g_repos[keys[k].idx];
+                r->wt_group  = (int)t->count;
+                r->wt_linked = keys[k].linked;
+                r->wt_main   = g->main_name;
+                t->next[keys[k].idx] = (k + 1 < b) ? keys[k + 1].idx : SIZE_MAX;
+            }
+        }
+        a = b;
+    }
+    if (t->count > 0) {
+        g_wt = t;
+    } else {
+        free(t->next);
+        free(t);
+    }
+
+out:
+    for (size_t k = 0; k < nkeys; k++) free(keys[k].commondir);
+    free(keys);
+}
+
+/* Memoised ahead/behind within a worktree group; false on a miss. */
+static bool ab_lookup(WorktreeGroup *g, const git_oid *local, const git_oid *upstream,
+                      size_t *ahead, size_t *behind) {
+    bool hit = false;
+    pthread_mutex_lock(&g->ab_lock);
+    for (size_t i = 0; i < g->ab_count; i++) {
+        if (git_oid_equal(&g->ab[i].local, local) && git_oid_equal(&g->ab[i].upstream, upstream)) {
+            *ahead  = g->ab[i].ahead;
+            *behind = g->ab[i].behind;
+            hit = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g->ab_lock);
+    return hit;
+}
+
+static void ab_store(WorktreeGroup *g, const git_oid *local, const git_oid *upstream,
+                     size_t ahead, size_t behind) {
+    pthread_mutex_lock(&g->ab_lock);
+    if (g->ab_count == g->ab_cap) {
+        size_t ncap = g->ab_cap ? g->ab_cap * 2 : 8;
+        AheadBehindEnt *tmp = realloc(g->ab, ncap * sizeof(*tmp));
+        if (!tmp) { pthread_mutex_unlock(&g->ab_lock); return; }
+        g->ab     = tmp;
+        g->ab_cap = ncap;
+    }
+    AheadBehindEnt *e = &g->ab[g->ab_count++];
+    git_oid_cpy(&e->local, local);
+    git_oid_cpy(&e->upstream, upstream);
+    e->ahead  = ahead;
+    e->behind = behind;
+    pthread_mutex_unlock(&g->ab_lock);
+}
+
 /* ── Recent branches (for the watch-mode switch picker) ─────────────────────── */
 char  **g_recent_branches    = NULL;
 size_t  g_recent_branch_count = 0;
@@ -91,59 +458,92 @@ void free_recent_branches(void) {
     g_recent_branch_count = 0;
 }
 
+typedef struct {
+    const char *path;
+    BranchEnt  *ents;
+    size_t      n, cap;
+} BranchList;
+
+/* Keep the most recent timestamp per branch name. False on OOM. */
+static bool branch_upsert(BranchList *l, const char *name, git_time_t t) {
+    for (size_t j = 0; j < l->n; j++) {
+        if (strcmp(l->ents[j].name, name) == 0) {
+            if (t > l->ents[j].t) l->ents[j].t = t;
+            return true;
+        }
+    }
+    if (l->n == l->cap) {
+        size_t ncap = l->cap ? l->cap * 2 : 16;
+        BranchEnt *tmp = realloc(l->ents, ncap * sizeof(*tmp));
+        if (!tmp) return false;
+        l->ents = tmp;
+        l->cap  = ncap;
+    }
+    snprintf(l->ents[l->n].name, sizeof(l->ents[l->n].name), "%s", name);
+    l->ents[l->n].t = t;
+    l->n++;
+    return true;
+}
+
+/* Pool task: the local branches of one repo. */
+static void branch_list_task(void *arg) {
+    BranchList *l = arg;
+    git_repository *repo = NULL;
+    if (git_repository_open(&repo, l->path) != 0) return;
+
+    git_branch_iterator *it = NULL;
+    if (git_branch_iterator_new(&it, repo, GIT_BRANCH_LOCAL) == 0) {
+        git_reference *ref = NULL;
+        git_branch_t   type;
+        while (git_branch_next(&ref, &type, it) == 0) {
+            const char *name = NULL;
+            bool ok = true;
+            if (git_branch_name(&name, ref) == 0 && name) {
+                git_time_t t = 0;
+                git_object *obj = NULL;
+                if (git_reference_peel(&obj, ref, GIT_OBJECT_COMMIT) == 0) {
+                    t = git_commit_time((git_commit *)obj);
+                    git_object_free(obj);
+                }
+                ok = branch_upsert(l, name, t);
+            }
+            git_reference_free(ref);
+            if (!ok) break;
+        }
+        git_branch_iterator_free(it);
+    }
+    git_repository_free(repo);
+}
+
 /*
  * Build a de-duplicated list of local branch names across all collected repos,
- * ordered by most recent commit date. Used by the watch-mode switch picker.
+ * ordered by most recent commit date. Used by the watch-mode switch picker;
+ * each repo is read by its own pool task.
  * Must be called while g_paths is still populated.
  */
 void collect_recent_branches(void) {
     free_recent_branches();
+    if (g_path_count == 0) return;
 
-    size_t cap = 0, n = 0;
-    BranchEnt *ents = NULL;
+    BranchList *lists = calloc(g_path_count, sizeof(*lists));
+    if (!lists) return;
+    TaskGroup g = { 0 };
+    for (size_t i = 0; i < g_path_count; i++) {
+        lists[i].path = g_paths[i];
+        pool_submit(&g, branch_list_task, &lists[i]);
+    }
+    pool_wait(&g);
 
+    /* merge in scan order */
+    BranchList all = { 0 };
     for (size_t i = 0; i < g_path_count; i++) {
-        git_repository *repo = NULL;
-        if (git_repository_open(&repo, g_paths[i]) != 0) continue;
-
-        git_branch_iterator *it = NULL;
-        if (git_branch_iterator_new(&it, repo, GIT_BRANCH_LOCAL) == 0) {
-            git_reference *ref = NULL;
-            git_branch_t   type;
-            while (git_branch_next(&ref, &type, it) == 0) {
-                const char *name = NULL;
-                if (git_branch_name(&name, ref) == 0 && name) {
-                    git_time_t t = 0;
-                    git_object *obj = NULL;
-                    if (git_reference_peel(&obj, ref, GIT_OBJECT_COMMIT) == 0) {
-                        t = git_commit_time((git_commit *)obj);
-                        git_object_free(obj);
-                    }
-                    /* upsert: keep the most recent timestamp per branch name */
-                    size_t j;
-                    for (j = 0; j < n; j++)
-                        if (strcmp(ents[j].name, name) == 0) break;
-                    if (j < n) {
-                        if (t > ents[j].t) ents[j].t = t;
-                    } else {
-                        if (n == cap) {
-                            size_t ncap = cap ? cap * 2 : 16;
-                            BranchEnt *tmp = realloc(ents, ncap * sizeof(*ents));
-                            if (!tmp) { git_reference_free(ref); break; }
-                            ents = tmp;
-                            cap  = ncap;
-                        }
-                        snprintf(ents[n].name, sizeof(ents[n].name), "%s", name);
-                        ents[n].t = t;
-                        n++;
-                    }
-                }
-                git_reference_free(ref);
-            }
-            git_branch_iterator_free(it);
-        }
-        git_repository_free(repo);
+        for (size_t k = 0; k < lists[i].n; k++)
+            if (!branch_upsert(&all, lists[i].ents[k].name, lists[i].ents[k].t)) break;
+        free(lists[i].ents);
     }
+    free(lists);
+    BranchEnt *ents = all.ents;
+    size_t     n    = all.n;
 
     if (n == 0) { free(ents); return; }
 
@@ -157,56 +557,118 @@ void collect_recent_branches(void) {
     free(ents);
 }
 
+/* One fetch from host ("" = local: not counted) is over. Safe from any thread. */
+void net_account(const char *host, uint64_t bytes, size_t objects, long ms) {
+    if (!host[0]) return;
+    pthread_mutex_lock(&g_net_host_lock);
+    NetHostStat *h = NULL;
+    for (size_t i = 0; i < g_net_host_count && !h; i++)
+        if (strcmp(g_net_hosts[i].host, host) == 0) h = &g_net_hosts[i];
+    if (!h) {
+        if (g_net_host_count == g_net_host_cap) {
+            size_t cap = g_net_host_cap ? g_net_host_cap * 2 : 16;
+            NetHostStat *tmp = realloc(g_net_hosts, cap * sizeof(*tmp));
+            if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+            g_net_hosts    = tmp;
+            g_net_host_cap = cap;
+        }
+        h = &g_net_hosts[g_net_host_count++];
+        *h = (NetHostStat){ .host = strdup(host) };
+        if (!h->host) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    }
+    h->fetches++;
+    h->bytes   += bytes;
+    h->objects += objects;
+    h->ms      += ms;
+    pthread_mutex_unlock(&g_net_host_lock);
+}
+
+static int net_host_cmp(const void *a, const void *b) {
+    const NetHostStat *x = a, *y = b;
+    if (x->bytes != y->bytes) return x->bytes < y->bytes ? 1 : -1;
+    return x->ms < y->ms ? 1 : x->ms > y->ms ? -1 : 0;
+}
+
+static void free_net_hosts(void) {
+    for (size_t i = 0; i < g_net_host_count; i++) free(g_net_hosts[i].host);
+    free(g_net_hosts);
+    g_net_hosts = NULL;
+    g_net_host_count = g_net_host_cap = 0;
+    g_net_wall_ms = 0;
+}
+
 /*
  * Free the collected paths and repo array, resetting all counters so the
  * scan can be repeated (used by the watch loop between refreshes).
  */
 void free_repo_collection(void) {
-    for (size_t i = 0; i < g_path_count; i++)
-        free(g_paths[i]);
     free(g_paths);
     g_paths      = NULL;
     g_path_count = 0;
     g_path_cap   = 0;
 
-    free(g_repos);
+    free(g_order);
+    free(g_net_order);
+    free(g_local_ms);
+    free(g_net_ms);
+    g_order = g_net_order = NULL;
+    g_local_ms = g_net_ms = NULL;
+    g_net_count = 0;
+
+    for (size_t i = 0; i < g_repo_count; i++) {
+        free(g_repos[i].exec_out);
+        g_repos[i].exec_out = NULL;
+    }
+    drop_status_cache();
+    if (opt_watch && opt_status_timeout > 0) {
+        g_prev_repos = g_repos;       /* becomes the cache for the next tick */
+        g_prev_count = g_repo_count;
+        StrArena *spare = g_prev_strings;   /* ... along with its strings */
+        g_prev_strings = atomic_exchange(&g_strings, spare ? spare : arena_new());
+    } else {
+        free(g_repos);
+        arena_reset(strings());
+    }
     g_repos      = NULL;
     g_repo_count = 0;
+
+    wt_table_unref(g_wt);
+    g_wt = NULL;
+    free_net_hosts();
 }
 
 /* ── Branch ────────────────────────────────────────────────────────────────── */
+/* Interned: 100k repos on "main" share one copy of it. */
 static void fill_branch(Repo *r, git_repository *repo) {
+    char name[256];
     if (git_repository_head_unborn(repo) == 1) {
-        snprintf(r->branch, sizeof(r->branch), "(unborn)");
-        return;
-    }
-
-    if (git_repository_head_detached(repo) == 1) {
+        snprintf(name, sizeof(name), "(unborn)");
+    } else if (git_repository_head_detached(repo) == 1) {
         git_reference *head = NULL;
         if (git_repository_head(&head, repo) == 0) {
             git_object *obj = NULL;
             if (git_reference_peel(&obj, head, GIT_OBJECT_COMMIT) == 0) {
                 char hex[8];
                 git_oid_tostr(hex, sizeof(hex), git_object_id(obj));
-                snprintf(r->branch, sizeof(r->branch), "(%s)", hex);
+                snprintf(name, sizeof(name), "(%s)", hex);
                 git_object_free(obj);
             } else {
-                snprintf(r->branch, sizeof(r->branch), "(detached)");
+                snprintf(name, sizeof(name), "(detached)");
             }
             git_reference_free(head);
         } else {
-            snprintf(r->branch, sizeof(r->branch), "(detached)");
+            snprintf(name, sizeof(name), "(detached)");
+        }
+    } else {
+        git_reference *head = NULL;
+        if (git_repository_head(&head, repo) != 0) {
+            snprintf(name, sizeof(name), "(?)");
+        } else {
+            snprintf(name, sizeof(name), "%s", git_reference_shorthand(head));
+            git_reference_free(head);
         }
-        return;
-    }
-
-    git_reference *head = NULL;
-    if (git_repository_head(&head, repo) != 0) {
-        snprintf(r->branch, sizeof(r->branch), "(?)");
-        return;
     }
-    snprintf(r->branch, sizeof(r->branch), "%s", git_reference_shorthand(head));
-    git_reference_free(head);
+    r->branch = arena_intern(strings(), name);
 }
 
 /* ── Status ────────────────────────────────────────────────────────────────── */
@@ -245,7 +707,7 @@ static void fill_status(Repo *r, git_repository *repo) {
 }
 
 /* ── Ahead / behind ────────────────────────────────────────────────────────── */
-static void fill_ahead_behind(Repo *r, git_repository *repo) {
+static void fill_ahead_behind(Repo *r, git_repository *repo, WorktreeGroup *g) {
     r->ahead = r->behind = 0;
     r->has_remote = 0;
 
@@ -276,10 +738,13 @@ static void fill_ahead_behind(Repo *r, git_repository *repo) {
 
     git_object *upstream_obj = NULL;
     if (git_reference_peel(&upstream_obj, upstream_ref, GIT_OBJECT_COMMIT) == 0) {
-        if (git_graph_ahead_behind(&r->ahead, &r->behind, repo,
-                                   git_object_id(local_obj),
-                                   git_object_id(upstream_obj)) == 0) {
+        const git_oid *lid = git_object_id(local_obj);
+        const git_oid *uid = git_object_id(upstream_obj);
+        if (g && ab_lookup(g, lid, uid, &r->ahead, &r->behind)) {
+            r->has_remote = 1;
+        } else if (git_graph_ahead_behind(&r->ahead, &r->behind, repo, lid, uid) == 0) {
             r->has_remote = 1;
+            if (g) ab_store(g, lid, uid, r->ahead, r->behind);
         }
         git_object_free(upstream_obj);
     }
@@ -365,151 +830,816 @@ static SwitchResult do_switch(git_repository *repo, const Repo *r,
     return from_remote ? SR_CREATED : SR_SWITCHED;
 }
 
-/* ── Subprocess helper ─────────────────────────────────────────────────────── */
+/* ── Phase 2: fetch/pull units ─────────────────────────────────────────────── */
 /*
- * Fork and exec a git command, capturing combined stdout+stderr into buf.
- * argv must be NULL-terminated (argv[0] == "git").
- * Returns the process exit code, or -1 on fork/exec failure.
+ * Network state shared by the members of one worktree group, which are
+ * processed back to back by the same Phase 2 unit: once one member has
+ * fetched, the rest reuse its result instead of fetching the same clone again.
  */
-static int run_git_capture(const char **argv, char *buf, size_t n) {
-    int pfd[2];
-    if (pipe(pfd) != 0) return -1;
-
-    pid_t pid = fork();
-    if (pid < 0) {
-        close(pfd[0]); close(pfd[1]);
-        return -1;
-    }
-    if (pid == 0) {
-        close(pfd[0]);
-        dup2(pfd[1], STDOUT_FILENO);
-        dup2(pfd[1], STDERR_FILENO);
-        close(pfd[1]);
-        /* execve is a direct syscall (async-signal-safe); execvp is not.
-         * g_git_path is resolved in the parent before any threads start.
-         * If g_git_path is somehow empty, exit immediately — do not fall
-         * back to execvp, which calls getenv/malloc and is not
-         * async-signal-safe. */
-        if (g_git_path[0])
-            execve(g_git_path, (char *const *)argv, environ);
-        _exit(127);   /* execve failed or g_git_path not resolved */
-    }
-
-    close(pfd[1]);
-    size_t total = 0;
-    if (buf && n > 0) {
-        ssize_t nr;
-        while (total + 1 < n &&
-               (nr = read(pfd[0], buf + total, n - total - 1)) > 0)
-            total += (size_t)nr;
-        buf[total] = '\0';
-        /* strip trailing newlines */
-        while (total > 0 && (buf[total-1] == '\n' || buf[total-1] == '\r'))
-            buf[--total] = '\0';
-    }
-    /* drain remaining output */
-    { char tmp[256]; while (read(pfd[0], tmp, sizeof(tmp)) > 0) {} }
-    close(pfd[0]);
-
-    int status = 0;
-    waitpid(pid, &status, 0);
-    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+typedef struct {
+    bool        fetched;         /* remote-tracking refs already refreshed */
+    FetchResult fetch_result;
+    int         fetch_refs;
+    const char *net_error;
+} NetShare;
+
+/* Name-sorted (name, oid) list of the refs a fetch can move. */
+typedef struct {
+    char    *name;
+    git_oid  oid;
+} RefEnt;
+
+typedef struct {
+    RefEnt  *v;
+    size_t   n, cap;
+} RefSnap;
+
+/* --narrow: one ref fetched from origin */
+typedef struct {
+    char src[320];                   /* its name on origin */
+    char dst[320];                   /* our remote-tracking ref for it */
+    char spec[660];                  /* "+<src>:<dst>" */
+} NarrowRef;
+
+typedef enum {
+    NU_OPEN = 0,
+    NU_FETCH,
+    NU_FETCH_DONE,      /* waiting for / back from the fetch */
+    NU_RETRY,           /* waiting out the backoff before fetching again */
+    NU_SWITCH,
+    NU_PULL,            /* local fast-forward, after the fetch */
+    NU_PROBE_DONE,      /* waiting for / back from the ls-remote */
+    NU_DONE,
+} NetStep;
+
+/*
+ * One Phase 2 job: a standalone repo or a worktree group, walked member by
+ * member along wt_next. Its libgit2 work runs as pool tasks; each git child
+ * runs on the NetExec loop, whose completion resubmits the unit to the pool.
+ * So a unit occupies no thread while its child is on the network, and only
+ * one task of a unit exists at a time.
+ */
+typedef struct {
+    size_t          j;               /* member being processed, SIZE_MAX = done */
+    NetStep         step;
+    NetShare        share;
+    git_repository *repo;            /* closed while a child runs */
+    char            host[256];       /* origin's server, "" = local / unknown */
+    RefSnap         before;          /* remote refs and tags around the fetch */
+    RefSnap         after;
+    NarrowRef       narrow[2];       /* --narrow: upstream, then the -s target */
+    size_t          nnarrow;         /* 0 = fetch all of origin */
+    bool            admitted;        /* host_admit let it through: a report is owed */
+    char            upref[320];      /* probe: the upstream's name on origin */
+    git_oid         tip;             /* probe: our remote-tracking ref for it */
+    bool            have_tip;
+    bool            native;          /* fetch running in-process via libgit2 */
+    char            mirror[PATH_MAX];/* shared_cache: fetching from here, not origin */
+    char           *url;             /* ... in place of origin's url */
+    int             rc;              /* child's exit code */
+    int             attempt;         /* fetch retries used on this member */
+    uint64_t        bytes;           /* received by this member's fetches */
+    size_t          objects;
+    long            net_ms;          /* ... and their wall time */
+    struct timespec fetch_t0;        /* first fetch attempt: net_timeout runs from here */
+    char            out[256];        /* child's output, or libgit2's error */
+    long            ms;              /* this member's time, excluding queueing */
+    struct timespec t0;              /* start of the current pool task */
+    NetExec        *ex;
+    TaskGroup      *group;
+} NetUnit;
+
+static void net_unit_step(void *arg);
+static long ms_since(const struct timespec *t0);
+
+/* The unit is about to be handed to another thread: account for this task's
+ * time now, as u is not ours to touch once the hand-off is made. */
+static void net_unit_yield(NetUnit *u) {
+    u->ms += ms_since(&u->t0);
 }
 
-/* ── Fetch ─────────────────────────────────────────────────────────────────── */
-static FetchResult do_fetch(git_repository *repo, Repo *r) {
-    /* local check: does an "origin" remote exist? (no network) */
-    git_remote *remote = NULL;
-    if (git_remote_lookup(&remote, repo, "origin") != 0)
-        return FR_NO_REMOTE;
+static void net_unit_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)cut;
+    NetUnit *u = ctx;
+    u->rc = status;
+    if (u->step == NU_FETCH_DONE) {              /* a fetch, not a probe or a backoff */
+        u->net_ms += ms;
+        if (!u->native) git_transfer_stats(out, &u->bytes, &u->objects);
+    }
+    /* keep the tail: after git's progress lines is where it says what failed */
+    size_t len = strlen(out);
+    if (len >= sizeof(u->out)) {
+        const char *tail = out + len - (sizeof(u->out) - 1);
+        const char *nl = strchr(tail, '\n');
+        out = nl && nl[1] ? nl + 1 : tail;
+    }
+    snprintf(u->out, sizeof(u->out), "%s", out);
+    u->ms += ms;
+    pool_submit(u->group, net_unit_step, u);     /* loop thread: hand straight on */
+}
+
+/* within: ms the child may take, if less than net_timeout (0 = no less). */
+static void net_unit_spawn(NetUnit *u, const char *const *argv, size_t outcap, long within) {
+    git_repository_free(u->repo);                /* reopened fresh afterwards */
+    u->repo = NULL;
+    net_unit_yield(u);
+    const char *host = u->mirror[0] ? "" : u->host; /* from the local mirror: no load on origin's server */
+    if (within > 0) netexec_spawn_within(u->ex, host, argv, outcap, true, within,
+                                         net_unit_done, u);
+    else            netexec_spawn(u->ex, host, argv, outcap, true, net_unit_done, u);
+}
+
+static void net_unit_call(NetUnit *u, NetCallFn fn, size_t outcap) {
+    git_repository_free(u->repo);
+    u->repo = NULL;
+    net_unit_yield(u);
+    netexec_call(u->ex, u->mirror[0] ? "" : u->host, fn, u, outcap, net_unit_done, u);
+}
+
+/* Come back after ms (at once on a cancel, with rc NETEXEC_CANCELLED). */
+static void net_unit_delay(NetUnit *u, long ms) {
+    net_unit_yield(u);
+    netexec_delay(u->ex, ms, net_unit_done, u);
+}
+
+/* Parked on the object cache: the mirror fetch is done, carry on. */
+static void net_unit_resume(void *arg) {
+    NetUnit *u = arg;
+    pool_submit(u->group, net_unit_step, u);
+}
+
+/* Ask the host breaker whether this member may go. Once admitted it is not
+ * asked again: a member parked on the object cache comes back through here,
+ * and a trial asking again would park behind itself. */
+static HostAdmit net_unit_admit(NetUnit *u) {
+    net_unit_yield(u);
+    if (u->admitted) return HOST_GO;
+    HostAdmit ha = host_admit(u->host, net_unit_resume, u);
+    u->admitted = ha == HOST_GO;
+    return ha;
+}
+
+/* The admitted member is done with the host. A trial must report, however
+ * it ended, or whatever is parked behind it waits forever. */
+static void net_unit_report(NetUnit *u, HostOutcome outcome) {
+    if (u->admitted) host_report(u->host, outcome);
+    u->admitted = false;
+}
+
+/* ── Native fetch ──────────────────────────────────────────────────────────── */
+/*
+ * git_remote_fetch() in-process saves the fork/exec of a `git fetch` per repo.
+ * It is used only where libgit2 needs nothing git would supply: local and
+ * file:// remotes, git://, and http(s) when libgit2 has TLS and no credential
+ * helper is configured. ssh (ssh config, agents, ProxyJump) and a custom
+ * remote.origin.uploadpack always go to git. Any native failure is retried
+ * once with `git fetch`, whose error is the one reported.
+ */
+static bool native_fetch_ok(git_repository *repo, const char *url) {
+    if (!opt_native_fetch || !url) return false;
+    git_config *cfg = NULL;
+    if (git_repository_config_snapshot(&cfg, repo) != 0) return false;
+    const char *v;
+    char host[256];
+    bool ok = git_config_get_string(&v, cfg, "remote.origin.uploadpack") != 0;
+    if (!ok || !remote_host(url, host, sizeof(host)))
+        ;                                        /* local path or file:// */
+    else if (strncmp(url, "https://", 8) == 0 || strncmp(url, "http://", 7) == 0)
+        ok = (git_libgit2_features() & GIT_FEATURE_HTTPS)
+          && git_config_get_string(&v, cfg, "credential.helper") != 0;
+    else
+        ok = strncmp(url, "git://", 6) == 0;
+    git_config_free(cfg);
+    return ok;
+}
+
+/* Both callbacks abort the transfer on a cancel or past net_timeout. */
+static int native_progress(const git_indexer_progress *stats, void *payload) {
+    (void)stats; (void)payload;
+    return netexec_stopping() ? -1 : 0;
+}
+
+static int native_sideband(const char *str, int len, void *payload) {
+    (void)str; (void)len; (void)payload;
+    return netexec_stopping() ? -1 : 0;
+}
+
+/* NetCallFn: runs on an executor thread while the unit is parked. From the
+ * shared mirror, origin's refspecs are fetched from an anonymous remote. */
+static int native_fetch(void *arg, char *out, size_t outcap) {
+    NetUnit *u = arg;
+    git_repository *repo = NULL;
+    git_remote *remote = NULL, *mirror = NULL;
+    git_strarray specs = { 0 };
+    int rc = git_repository_open(&repo, g_repos[u->j].path);
+    if (rc == 0) rc = git_remote_lookup(&remote, repo, "origin");
+    if (rc == 0 && u->mirror[0] && u->nnarrow == 0)
+        rc = git_remote_get_fetch_refspecs(&specs, remote);
+    if (rc == 0 && u->mirror[0])
+        rc = git_remote_create_anonymous(&mirror, repo, u->mirror);
+    if (rc == 0) {
+        git_fetch_options opts;
+        git_fetch_options_init(&opts, GIT_FETCH_OPTIONS_VERSION);
+        opts.callbacks.transfer_progress = native_progress;
+        opts.callbacks.sideband_progress = native_sideband;
+        opts.proxy_opts.type = GIT_PROXY_AUTO;   /* http.proxy and the environment */
+        char *narrow[2];
+        git_strarray want = specs;
+        if (u->nnarrow > 0) {                    /* just these, and no tags */
+            for (size_t k = 0; k < u->nnarrow; k++) narrow[k] = u->narrow[k].spec;
+            want = (git_strarray){ narrow, u->nnarrow };
+            opts.download_tags = GIT_REMOTE_DOWNLOAD_TAGS_NONE;
+        }
+        rc = mirror ? git_remote_fetch(mirror, &want, &opts, "fetch origin")
+                    : git_remote_fetch(remote, u->nnarrow ? &want : NULL, &opts, NULL);
+        const git_indexer_progress *st = git_remote_stats(mirror ? mirror : remote);
+        u->bytes   += st->received_bytes;
+        u->objects += st->received_objects;
+    }
+    if (rc != 0) {
+        const git_error *e = git_error_last();
+        snprintf(out, outcap, "%s", e && e->message ? e->message : "fetch failed");
+    }
+    git_strarray_dispose(&specs);
+    git_remote_free(mirror);
     git_remote_free(remote);
+    git_repository_free(repo);
+    if (rc != 0 && netexec_cancelled()) return NETEXEC_CANCELLED;
+    return rc == 0 ? 0 : 1;
+}
+
+/* ── Ref snapshots ─────────────────────────────────────────────────────────── */
+/*
+ * Every ref a `fetch origin` can move -- origin's remote-tracking branches and
+ * the tags -- is read before and after the fetch and the two lists are
+ * compared in one merge pass. Symbolic refs (origin/HEAD) are skipped.
+ */
+static void refsnap_free(RefSnap *s) {
+    for (size_t k = 0; k < s->n; k++) free(s->v[k].name);
+    free(s->v);
+    s->v = NULL;
+    s->n = s->cap = 0;
+}
+
+static int refent_cmp(const void *a, const void *b) {
+    return strcmp(((const RefEnt *)a)->name, ((const RefEnt *)b)->name);
+}
 
-    /* snapshot the remote-tracking ref before fetching so we can detect changes */
-    char refspec[320] = "";
-    char ref_before[128] = "";
-    bool have_before = false;
-    if (r->branch[0] != '\0' && r->branch[0] != '(') {
-        snprintf(refspec, sizeof(refspec), "refs/remotes/origin/%s", r->branch);
-        const char *rp_argv[] = { "git", "-C", r->path, "rev-parse", "--verify", refspec, NULL };
-        have_before = (run_git_capture(rp_argv, ref_before, sizeof(ref_before)) == 0
-                       && ref_before[0] != '\0');
+static void refsnap_add(RefSnap *s, const char *name, const git_oid *id) {
+    if (s->n == s->cap) {
+        size_t cap = s->cap ? s->cap * 2 : 32;
+        RefEnt *tmp = realloc(s->v, cap * sizeof(*tmp));
+        if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        s->v   = tmp;
+        s->cap = cap;
     }
+    s->v[s->n].name = strdup(name);
+    if (!s->v[s->n].name) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    git_oid_cpy(&s->v[s->n].oid, id);
+    s->n++;
+}
 
-    const char *fetch_argv[] = { "git", "-C", r->path, "fetch", "--quiet", "origin", NULL };
-    char errbuf[256] = "";
-    int rc = run_git_capture(fetch_argv, errbuf, sizeof(errbuf));
-    if (rc != 0) {
-        strncpy(r->net_error, errbuf[0] ? errbuf : "git fetch failed",
-                sizeof(r->net_error) - 1);
-        return FR_ERROR;
+/* A narrow fetch can only move the refs it asked for: read just those. */
+static void refsnap_take(RefSnap *s, git_repository *repo,
+                         const NarrowRef *narrow, size_t nnarrow) {
+    static const char *const globs[] = { "refs/remotes/origin/*", "refs/tags/*" };
+    refsnap_free(s);
+    for (size_t k = 0; k < nnarrow; k++) {
+        git_oid id;
+        if (git_reference_name_to_id(&id, repo, narrow[k].dst) == 0)
+            refsnap_add(s, narrow[k].dst, &id);
+    }
+    for (size_t g = 0; nnarrow == 0 && g < sizeof(globs) / sizeof(globs[0]); g++) {
+        git_reference_iterator *it = NULL;
+        if (git_reference_iterator_glob_new(&it, repo, globs[g]) != 0) continue;
+        git_reference *ref;
+        while (git_reference_next(&ref, it) == 0) {
+            const git_oid *id = git_reference_target(ref);
+            if (id) refsnap_add(s, git_reference_name(ref), id);
+            git_reference_free(ref);
+        }
+        git_reference_iterator_free(it);
     }
+    qsort(s->v, s->n, sizeof(*s->v), refent_cmp);
+}
+
+static const git_oid *refsnap_find(const RefSnap *s, const char *name) {
+    RefEnt key = { .name = (char *)name };
+    const RefEnt *e = s->n ? bsearch(&key, s->v, s->n, sizeof(*s->v), refent_cmp) : NULL;
+    return e ? &e->oid : NULL;
+}
 
-    /* compare ref after fetch; unchanged → nothing new was downloaded */
-    if (have_before) {
-        char ref_after[128] = "";
-        const char *rp_argv[] = { "git", "-C", r->path, "rev-parse", "--verify", refspec, NULL };
-        if (run_git_capture(rp_argv, ref_after, sizeof(ref_after)) == 0
-                && strcmp(ref_before, ref_after) == 0)
-            return FR_UP_TO_DATE;
+/* Refs created, moved or deleted between a and b. */
+static int refsnap_diff(const RefSnap *a, const RefSnap *b) {
+    int changed = 0;
+    size_t i = 0, k = 0;
+    while (i < a->n || k < b->n) {
+        int c = i == a->n ? 1 : k == b->n ? -1 : strcmp(a->v[i].name, b->v[k].name);
+        if (c != 0)                                     changed++;
+        else if (!git_oid_equal(&a->v[i].oid, &b->v[k].oid)) changed++;
+        if (c <= 0) i++;
+        if (c >= 0) k++;
     }
-    return FR_FETCHED;
+    return changed;
 }
 
-/* ── Pull (fast-forward only) ──────────────────────────────────────────────── */
-static PullResult do_pull(git_repository *repo, Repo *r) {
-    if (r->staged || r->modified)
-        return PR_DIRTY;
+/* The upstream of r's branch on origin: its name there (branch.<b>.merge)
+ * and its remote-tracking ref, else <branch> under refs/heads/ and
+ * refs/remotes/origin/ when none is configured on origin. *tracked (unless
+ * NULL) says which. False when HEAD is detached. */
+static bool origin_upstream(git_repository *repo, const Repo *r,
+                            char *src, char *dst, size_t n, bool *tracked) {
+    if (r->branch[0] == '\0' || r->branch[0] == '(') return false;
+    char local[320];
+    snprintf(local, sizeof(local), "refs/heads/%s", r->branch);
+    git_buf remote = GIT_BUF_INIT, merge = GIT_BUF_INIT, up = GIT_BUF_INIT;
+    if (git_branch_upstream_remote(&remote, repo, local) == 0
+            && strcmp(remote.ptr, "origin") == 0
+            && git_branch_upstream_merge(&merge, repo, local) == 0
+            && git_branch_upstream_name(&up, repo, local) == 0) {
+        snprintf(src, n, "%s", merge.ptr);
+        snprintf(dst, n, "%s", up.ptr);
+        if (tracked) *tracked = true;
+    } else {
+        snprintf(src, n, "refs/heads/%s", r->branch);
+        snprintf(dst, n, "refs/remotes/origin/%s", r->branch);
+        if (tracked) *tracked = false;
+    }
+    git_buf_dispose(&remote);
+    git_buf_dispose(&merge);
+    git_buf_dispose(&up);
+    return true;
+}
+
+/* Commits the fetch added to the upstream of r's branch; 0 when it was
+ * created or is unknown. */
+static size_t upstream_new_commits(const NetUnit *u, const Repo *r, git_repository *repo) {
+    char src[320], name[320];
+    if (!origin_upstream(repo, r, src, name, sizeof(name), NULL)) return 0;
+
+    const git_oid *old = refsnap_find(&u->before, name);
+    const git_oid *new = refsnap_find(&u->after, name);
+    size_t added = 0, removed = 0;
+    if (!old || !new || git_oid_equal(old, new)
+            || git_graph_ahead_behind(&added, &removed, repo, new, old) != 0)
+        return 0;
+    return added;
+}
+
+/* ── Fetch ─────────────────────────────────────────────────────────────────── */
+/* FETCH_HEAD is rewritten by every fetch (git's and libgit2's), in the
+ * worktree's git dir or the common dir depending on the writer; the newer of
+ * the two says when this clone last fetched. */
+static bool fetched_within(git_repository *repo, long max_age) {
+    const char *dirs[] = { git_repository_path(repo), git_repository_commondir(repo) };
+    time_t newest = 0;
+    for (size_t k = 0; k < sizeof(dirs) / sizeof(dirs[0]); k++) {
+        char file[PATH_MAX];
+        struct stat st;
+        if (!dirs[k]) continue;
+        int m = snprintf(file, sizeof(file), "%sFETCH_HEAD", dirs[k]);   /* dirs end in / */
+        if (m > 0 && m < (int)sizeof(file) && stat(file, &st) == 0 && st.st_mtime > newest)
+            newest = st.st_mtime;
+    }
+    time_t now = time(NULL);
+    return newest > 0 && newest <= now && now - newest < max_age;
+}
+
+/* net_timeout bounds a member's fetch, fallback and retries included: what
+ * is left of it (0 = no timeout). */
+static long fetch_budget_ms(const NetUnit *u) {
+    if (opt_net_timeout <= 0) return 0;
+    long left = opt_net_timeout * 1000 - ms_since(&u->fetch_t0);
+    return left > 0 ? left : 1;
+}
+
+/* From the shared mirror, origin's URL is rewritten to it for this one
+ * command, so origin's own refspecs and tag following still apply. A narrow
+ * fetch names its refspecs, which also makes git send them as ref-prefixes. */
+static void fetch_spawn_git(NetUnit *u, Repo *r) {
+    char rewrite[2 * PATH_MAX + 32];
+    const char *argv[16];
+    size_t n = 0;
+    argv[n++] = "git";
+    argv[n++] = "-C";
+    argv[n++] = r->path;
+    if (u->mirror[0] && u->url) {
+        snprintf(rewrite, sizeof(rewrite), "url.%s.insteadOf=%s", u->mirror, u->url);
+        argv[n++] = "-c";
+        argv[n++] = rewrite;
+    }
+    argv[n++] = "fetch";
+    argv[n++] = "--progress";                    /* for what it received */
+    if (u->nnarrow > 0) argv[n++] = "--no-tags";
+    argv[n++] = "origin";
+    for (size_t k = 0; k < u->nnarrow; k++) argv[n++] = u->narrow[k].spec;
+    argv[n] = NULL;
+    u->native = false;
+    net_unit_spawn(u, argv, FETCH_OUT_CAP, fetch_budget_ms(u));
+}
+
+static void narrow_add(NetUnit *u, const char *src, const char *dst) {
+    for (size_t k = 0; k < u->nnarrow; k++)
+        if (strcmp(u->narrow[k].dst, dst) == 0) return;
+    NarrowRef *n = &u->narrow[u->nnarrow++];
+    snprintf(n->src, sizeof(n->src), "%s", src);
+    snprintf(n->dst, sizeof(n->dst), "%s", dst);
+    snprintf(n->spec, sizeof(n->spec), "+%s:%s", src, dst);
+}
+
+/* --narrow: the upstream of the checked-out branch and the -s target, all
+ * a status row needs. Left empty (fetch everything) on a detached HEAD
+ * with nothing to switch to, and on a branch with no upstream on origin:
+ * guessing one would make git fail the whole fetch when the branch was
+ * never pushed. */
+static void narrow_refs(NetUnit *u, const Repo *r) {
+    u->nnarrow = 0;
+    if (!opt_narrow) return;
+    char src[320], dst[320];
+    bool tracked = false;
+    if (origin_upstream(u->repo, r, src, dst, sizeof(dst), &tracked)) {
+        if (!tracked) return;
+        narrow_add(u, src, dst);
+    }
+    if (opt_fetch && opt_switch) {
+        snprintf(src, sizeof(src), "refs/heads/%s", opt_switch_branch);
+        snprintf(dst, sizeof(dst), "refs/remotes/origin/%s", opt_switch_branch);
+        narrow_add(u, src, dst);
+    }
+}
 
+/* Local checks and a snapshot of the remote refs, then the fetch
+ * (native where possible, else `git fetch`). False (with r->fetch_result
+ * set) when there is nothing to run. The unit may instead park (true, step
+ * left at NU_FETCH) behind the trial fetch of a host that was down, or with
+ * shared_cache until the upstream's mirror is fetched. */
+static bool fetch_start(NetUnit *u, Repo *r) {
     /* local check: does an "origin" remote exist? (no network) */
     git_remote *remote = NULL;
-    if (git_remote_lookup(&remote, repo, "origin") != 0)
-        return PR_NO_REMOTE;
+    if (git_remote_lookup(&remote, u->repo, "origin") != 0) {
+        r->fetch_result = FR_NO_REMOTE;
+        return false;
+    }
+    remote_host(git_remote_url(remote), u->host, sizeof(u->host));
+    bool native = native_fetch_ok(u->repo, git_remote_url(remote));
+
+    if (opt_max_age > 0 && fetched_within(u->repo, opt_max_age)) {
+        git_remote_free(remote);
+        r->fetch_result = FR_FRESH;              /* refs are recent enough */
+        return false;
+    }
+    u->step = NU_FETCH;                          /* where a parked unit resumes */
+    HostAdmit ha = net_unit_admit(u);
+    if (ha == HOST_WAIT) {
+        git_remote_free(remote);                 /* u belongs to the resume now */
+        return true;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &u->t0);
+    u->step = NU_FETCH_DONE;
+    if (ha == HOST_SKIP) {
+        git_remote_free(remote);
+        r->fetch_result = FR_HOST_DOWN;
+        return false;
+    }
+    narrow_refs(u, r);
+
+    if (g_objcache) {
+        u->step = NU_FETCH;                      /* where a parked unit resumes */
+        net_unit_yield(u);
+        ObjCacheState st = objcache_acquire(g_objcache, u->ex, git_remote_url(remote),
+                                            net_unit_resume, u,
+                                            u->mirror, sizeof(u->mirror));
+        if (st == OBJCACHE_PARKED) {
+            git_remote_free(remote);             /* u belongs to the resume now */
+            return true;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &u->t0);
+        u->step = NU_FETCH_DONE;
+        if (st == OBJCACHE_READY) {
+            free(u->url);
+            u->url = strdup(git_remote_url(remote));
+            if (!u->url) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+            native = opt_native_fetch;           /* a local fetch either way */
+        }
+    }
     git_remote_free(remote);
 
-    const char *argv[] = {
-        "git", "-C", r->path, "pull", "--ff-only", "--no-rebase", NULL
+    refsnap_take(&u->before, u->repo, u->narrow, u->nnarrow);
+
+    clock_gettime(CLOCK_MONOTONIC, &u->fetch_t0);
+    if (native) {
+        u->native = true;
+        net_unit_call(u, native_fetch, sizeof(u->out));
+    } else {
+        fetch_spawn_git(u, r);
+    }
+    return true;
+}
+
+/* git refuses a whole narrow fetch when one named branch is not on origin;
+ * libgit2 just skips it. True when that branch is the -s target, which may
+ * well exist only in some of the repos. */
+static bool narrow_target_missing(const NetUnit *u) {
+    if (u->native || u->rc == 0 || u->rc == NETEXEC_CANCELLED) return false;
+    if (!opt_switch || u->nnarrow == 0) return false;
+    char target[320];
+    snprintf(target, sizeof(target), "refs/heads/%s", opt_switch_branch);
+    return strcmp(u->narrow[u->nnarrow - 1].src, target) == 0
+        && strstr(u->out, "couldn't find remote ref") && strstr(u->out, target);
+}
+
+/* 1s, 2s, 4s ... capped at 8s, plus up to half again so that the repos of a
+ * flaky server do not all come back at the same moment. */
+static long fetch_backoff_ms(const NetUnit *u) {
+    long ms = 1000L << (u->attempt < 3 ? u->attempt : 3);
+    return ms + (long)((u->j * 2654435761u) % (size_t)(ms / 2));
+}
+
+/* Less than this left of net_timeout after the pause: not worth a retry. */
+#define FETCH_RETRY_MIN_MS 1000
+
+/* A failed fetch worth another go after a pause: the connection or the
+ * server hiccupped (as git, curl, ssh or libgit2 put it). Timeouts are not
+ * retried -- an unreachable server would cost one per attempt, and the host
+ * breaker counts them -- and neither is anything that looks permanent (auth,
+ * missing repo, unknown host). A retry runs on what is left of net_timeout,
+ * and is skipped when too little would be. */
+static bool fetch_retryable(const NetUnit *u) {
+    static const char *const transient[] = {
+        "Connection reset", "connection reset",
+        "Temporary failure in name resolution",
+        "early EOF", "the remote end hung up unexpectedly",
+        "RPC failed", "returned error: 50", "unexpected disconnect",
+        "SSL_read", "TLS connection was non-properly terminated",
+        "unexpected http status code: 50",
     };
-    char outbuf[512] = "";
-    int rc = run_git_capture(argv, outbuf, sizeof(outbuf));
+    if (u->rc == 0 || u->rc == NETEXEC_CANCELLED || u->rc == NETEXEC_TIMEDOUT) return false;
+    if (u->attempt >= opt_net_retries || netexec_cancelled()) return false;
+    if (opt_net_timeout > 0 && fetch_budget_ms(u) - fetch_backoff_ms(u) < FETCH_RETRY_MIN_MS)
+        return false;
+    for (size_t k = 0; k < sizeof(transient) / sizeof(transient[0]); k++)
+        if (strstr(u->out, transient[k])) return true;
+    return false;
+}
+
+/* For the host breaker: could the failed op not get through to the server
+ * at all? Anything it answered -- auth, missing repo, a 5xx -- says it is up.
+ * A fetch from the mirror reached origin through the mirror's fetch. */
+static HostOutcome host_outcome(const NetUnit *u) {
+    static const char *const unreachable[] = {
+        "Could not resolve host", "Could not resolve hostname",
+        "Name or service not known", "failed to resolve address",
+        "Temporary failure in name resolution",
+        "Connection refused", "No route to host", "Network is unreachable",
+        "Connection timed out", "Operation timed out",
+        "failed to connect", "Failed to connect", "Couldn't connect to server",
+    };
+    if (u->rc == NETEXEC_CANCELLED) return HOST_UNTRIED;
+    if (u->mirror[0]) return u->rc == 0 ? HOST_REACHED : HOST_UNTRIED;
+    if (u->rc == NETEXEC_TIMEDOUT) return HOST_UNREACHABLE;
+    if (u->rc == 0) return HOST_REACHED;
+    for (size_t k = 0; k < sizeof(unreachable) / sizeof(unreachable[0]); k++)
+        if (strstr(u->out, unreachable[k])) return HOST_UNREACHABLE;
+    return HOST_REACHED;
+}
 
+static FetchResult fetch_finish(NetUnit *u, Repo *r) {
+    if (u->rc == NETEXEC_CANCELLED) return FR_CANCELLED;
+    if (u->rc != 0) {
+        set_net_error(r, "%s", u->out[0] ? u->out : "git fetch failed");
+        return FR_ERROR;
+    }
+
+    if (!u->repo) return FR_FETCHED;             /* could not reopen: assume news */
+    refsnap_take(&u->after, u->repo, u->narrow, u->nnarrow);
+    r->fetch_refs = refsnap_diff(&u->before, &u->after);
+    r->fetch_new  = upstream_new_commits(u, r, u->repo);
+    return r->fetch_refs > 0 ? FR_FETCHED : FR_UP_TO_DATE;
+}
+
+/* ── Probe ─────────────────────────────────────────────────────────────────── */
+/*
+ * `gitls probe` asks origin for the current tip of each repo's upstream branch
+ * and compares it with the remote-tracking ref, without downloading anything:
+ * `git ls-remote origin <ref>` (a protocol v2 ls-refs with that ref prefix),
+ * or the in-process equivalent on the same remotes as the native fetch. Both
+ * leave "<oid>\t<ref>" lines in u->out.
+ */
+static int native_probe(void *arg, char *out, size_t outcap) {
+    NetUnit *u = arg;
+    git_repository *repo = NULL;
+    git_remote *remote = NULL;
+    int rc = git_repository_open(&repo, g_repos[u->j].path);
+    if (rc == 0) rc = git_remote_lookup(&remote, repo, "origin");
+    if (rc == 0) {
+        git_remote_callbacks cb;
+        git_proxy_options proxy = { .version = GIT_PROXY_OPTIONS_VERSION,
+                                    .type    = GIT_PROXY_AUTO };
+        git_remote_init_callbacks(&cb, GIT_REMOTE_CALLBACKS_VERSION);
+        rc = git_remote_connect(remote, GIT_DIRECTION_FETCH, &cb, &proxy, NULL);
+    }
+    const git_remote_head **heads;
+    size_t n = 0;
+    if (rc == 0) rc = git_remote_ls(&heads, &n, remote);
     if (rc == 0) {
-        if (strstr(outbuf, "Already up to date") != NULL)
-            return PR_UP_TO_DATE;
-        return PR_PULLED;
+        out[0] = '\0';
+        for (size_t k = 0; k < n; k++) {
+            if (strcmp(heads[k]->name, u->upref) != 0) continue;
+            char hex[GIT_OID_MAX_HEXSIZE + 1];
+            git_oid_tostr(hex, sizeof(hex), &heads[k]->oid);
+            snprintf(out, outcap, "%s\t%s\n", hex, heads[k]->name);
+            break;
+        }
+    } else {
+        const git_error *e = git_error_last();
+        snprintf(out, outcap, "%s", e && e->message ? e->message : "ls-remote failed");
     }
+    if (remote) git_remote_disconnect(remote);
+    git_remote_free(remote);
+    git_repository_free(repo);
+    if (rc != 0 && netexec_cancelled()) return NETEXEC_CANCELLED;
+    return rc == 0 ? 0 : 1;
+}
 
-    /* non-zero exit: classify the failure */
-    if (strstr(outbuf, "Not possible to fast-forward") != NULL ||
-        strstr(outbuf, "not possible to fast-forward") != NULL)
-        return PR_NOT_FF;
+static void probe_spawn_git(NetUnit *u) {
+    const char *argv[] = { "git", "-C", g_repos[u->j].path, "-c", "protocol.version=2",
+                           "ls-remote", "origin", u->upref, NULL };
+    u->native = false;
+    net_unit_spawn(u, argv, sizeof(u->out), 0);
+}
 
-    if (strstr(outbuf, "no tracking information") != NULL ||
-        strstr(outbuf, "no upstream configured")  != NULL)
-        return PR_NO_REMOTE;
+/* Work out which ref to ask for, then ask. False (with r->probe_result set)
+ * when there is nothing to ask. Like fetch_start it may park behind a trial
+ * of a host that was down. */
+static bool probe_start(NetUnit *u, Repo *r) {
+    git_remote *remote = NULL;
+    if (git_remote_lookup(&remote, u->repo, "origin") != 0) {
+        r->probe_result = PB_NO_REMOTE;
+        return false;
+    }
+    remote_host(git_remote_url(remote), u->host, sizeof(u->host));
+    bool native = native_fetch_ok(u->repo, git_remote_url(remote));
+    git_remote_free(remote);
+    char tracking[320];
+    if (!origin_upstream(u->repo, r, u->upref, tracking, sizeof(tracking), NULL)) {
+        r->probe_result = PB_NO_REMOTE;         /* detached: nothing to compare */
+        return false;
+    }
+    u->have_tip = git_reference_name_to_id(&u->tip, u->repo, tracking) == 0;
+    u->step = NU_FETCH;                          /* parked: back through NU_FETCH */
+    HostAdmit ha = net_unit_admit(u);
+    if (ha == HOST_WAIT) return true;
+    clock_gettime(CLOCK_MONOTONIC, &u->t0);
+    u->step = NU_PROBE_DONE;
+    if (ha == HOST_SKIP) {
+        r->probe_result = PB_HOST_DOWN;
+        return false;
+    }
+
+    if (native) {
+        u->native = true;
+        net_unit_call(u, native_probe, sizeof(u->out));
+    } else {
+        probe_spawn_git(u);
+    }
+    return true;
+}
+
+static ProbeResult probe_finish(NetUnit *u, Repo *r) {
+    if (u->rc == NETEXEC_CANCELLED) return PB_CANCELLED;
+    if (u->rc != 0) {
+        set_net_error(r, "%s", u->out[0] ? u->out : "git ls-remote failed");
+        return PB_ERROR;
+    }
+
+    /* find "<hex>\t<upref>" among the lines; absent = not on the remote */
+    size_t reflen = strlen(u->upref);
+    for (const char *line = u->out; *line; ) {
+        const char *tab = strchr(line, '\t');
+        const char *eol = strchr(line, '\n');
+        if (!eol) eol = line + strlen(line);
+        if (tab && tab < eol && (size_t)(eol - tab - 1) == reflen
+                && strncmp(tab + 1, u->upref, reflen) == 0
+                && (size_t)(tab - line) <= GIT_OID_MAX_HEXSIZE) {
+            char hex[GIT_OID_MAX_HEXSIZE + 1];
+            git_oid remote_tip;
+            snprintf(hex, sizeof(hex), "%.*s", (int)(tab - line), line);
+            if (git_oid_fromstr(&remote_tip, hex) != 0) break;
+            return u->have_tip && git_oid_equal(&u->tip, &remote_tip) ? PB_SAME : PB_CHANGED;
+        }
+        line = *eol ? eol + 1 : eol;
+    }
+    return u->have_tip ? PB_CHANGED : PB_NO_REMOTE;   /* deleted upstream / never there */
+}
 
-    strncpy(r->net_error, outbuf[0] ? outbuf : "git pull failed",
-            sizeof(r->net_error) - 1);
+/* ── Pull (fast-forward only) ──────────────────────────────────────────────── */
+/*
+ * A pull is the Phase 2 fetch followed by this local step: a merge analysis
+ * of HEAD against its upstream and, only when that says fast-forward, a safe
+ * checkout of the upstream tree and a move of the branch ref. A repo that is
+ * not behind its upstream never gets a checkout. Runs on the pool after the
+ * fetch has finished, so it never touches the network.
+ */
+static PullResult pull_error(Repo *r, const char *what) {
+    const git_error *e = git_error_last();
+    set_net_error(r, "%s%s%s", what,
+                  e && e->message ? ": " : "", e && e->message ? e->message : "");
     return PR_ERROR;
 }
 
+/* HEAD's branch ref name into out; false when detached. */
+static bool head_branch(git_repository *repo, char *out, size_t n) {
+    git_reference *head = NULL;
+    if (git_reference_lookup(&head, repo, "HEAD") != 0) return false;
+    const char *name = git_reference_symbolic_target(head);
+    bool ok = name && strncmp(name, "refs/heads/", 11) == 0
+           && snprintf(out, n, "%s", name) < (int)n;
+    git_reference_free(head);
+    return ok;
+}
+
+static PullResult pull_fast_forward(git_repository *repo, Repo *r) {
+    if (r->staged || r->modified) return PR_DIRTY;
+    if (r->fetch_result == FR_NO_REMOTE) return PR_NO_REMOTE;
+    if (r->fetch_result == FR_ERROR)     return PR_ERROR;   /* net_error is set */
+    if (r->fetch_result == FR_HOST_DOWN) return PR_HOST_DOWN;
+
+    char branch[320];
+    if (!head_branch(repo, branch, sizeof(branch))) {
+        set_net_error(r, "not on a branch");
+        return PR_ERROR;
+    }
+    git_buf upstream = GIT_BUF_INIT;
+    if (git_branch_upstream_name(&upstream, repo, branch) != 0) {
+        git_buf_dispose(&upstream);
+        return PR_NO_REMOTE;                      /* no tracking information */
+    }
+
+    PullResult res = PR_ERROR;
+    git_reference *up = NULL;
+    git_annotated_commit *theirs = NULL;
+    git_object *target = NULL;
+    git_merge_analysis_t analysis;
+    git_merge_preference_t pref;
+    if (git_reference_lookup(&up, repo, upstream.ptr) != 0) {
+        set_net_error(r, "%s does not exist", upstream.ptr);
+        goto out;
+    }
+    if (git_annotated_commit_from_ref(&theirs, repo, up) != 0
+            || git_merge_analysis(&analysis, &pref, repo,
+                                  (const git_annotated_commit **)&theirs, 1) != 0) {
+        res = pull_error(r, "merge analysis failed");
+        goto out;
+    }
+
+    if (analysis & GIT_MERGE_ANALYSIS_UP_TO_DATE) {
+        res = PR_UP_TO_DATE;
+    } else if (analysis & (GIT_MERGE_ANALYSIS_FASTFORWARD | GIT_MERGE_ANALYSIS_UNBORN)) {
+        const git_oid *id = git_annotated_commit_id(theirs);
+        git_checkout_options opts = {
+            .version           = GIT_CHECKOUT_OPTIONS_VERSION,
+            .checkout_strategy = GIT_CHECKOUT_SAFE,
+        };
+        git_reference *moved = NULL;
+        if (git_object_lookup(&target, repo, id, GIT_OBJECT_COMMIT) != 0
+                || git_checkout_tree(repo, target, &opts) != 0)
+            res = pull_error(r, "checkout failed");
+        else if (git_reference_create(&moved, repo, branch, id, 1,
+                                      "pull: Fast-forward") != 0)
+            res = pull_error(r, "could not update branch");
+        else
+            res = PR_PULLED;
+        git_reference_free(moved);
+    } else {
+        res = PR_NOT_FF;                          /* diverged */
+    }
+
+out:
+    git_object_free(target);
+    git_annotated_commit_free(theirs);
+    git_reference_free(up);
+    git_buf_dispose(&upstream);
+    return res;
+}
+
 /* ── Phase 1: local libgit2 queries (no subprocess) ────────────────────────── */
 /*
  * Called from worker threads — must NOT call fork/exec.
  * Handles all local queries and, when not fetching first, branch switching.
  * Ahead/behind is filled here only when no network op will refresh it.
  */
-static void process_repo_local(const char *path, Repo *r) {
+static void process_repo_local(const char *path, Repo *r, WorktreeTable *wt) {
     git_repository *repo = NULL;
     if (git_repository_open(&repo, path) != 0) {
         fprintf(stderr, "Warning: could not open repository at '%s'\n", path);
-        memset(r, 0, sizeof(*r));
-        strncpy(r->path, path, sizeof(r->path) - 1);
-        r->path[sizeof(r->path) - 1] = '\0';
+        *r = (Repo){ .path = r->path, .branch = "", .net_error = "" };
         return;
     }
 
-    strncpy(r->path, path, sizeof(r->path) - 1);
-    r->path[sizeof(r->path) - 1] = '\0';
+    /* worktrees of one clone read objects through the group's shared odb */
+    WorktreeGroup *g = wt_group_of(wt, r);
+    if (g && g->odb)
+        git_repository_set_odb(repo, g->odb);
 
     fill_branch(r, repo);
     fill_status(r, repo);
@@ -528,92 +1658,557 @@ static void process_repo_local(const char *path, Repo *r) {
     /* ahead/behind uses local remote-tracking refs; skip when a fetch will
      * refresh them in phase 2 (stale data would just be overwritten anyway) */
     if (!opt_fetch && !opt_pull)
-        fill_ahead_behind(r, repo);
+        fill_ahead_behind(r, repo, g);
+
+    /* one fetch per unit: count a group's leader only, and no dirty repo a
+     * pull would skip */
+    git_remote *origin = NULL;
+    if (g_objcache && (!g || g->leader == (size_t)(r - g_repos))
+            && !(opt_pull && (r->staged || r->modified))
+            && git_remote_lookup(&origin, repo, "origin") == 0)
+        objcache_count(g_objcache, git_remote_url(origin), r->path);
+    git_remote_free(origin);
 
     git_repository_free(repo);
 }
 
-/* ── Phase 2: subprocess fetch/pull (called from net_worker_thread pool) ────── */
+/* ── Phase 2: one member's fetch / switch / pull ───────────────────────────── */
 /*
- * Called concurrently from the Phase 2 thread pool after all Phase 1 workers
- * have joined. Only async-signal-safe syscalls (dup2, execve) are used between
- * fork and exec in run_git_capture, so concurrent fork() calls are safe.
+ * Advance the current member until it either starts a fetch (true: the
+ * unit is resumed from net_unit_done) or is finished (false). Runs on the
+ * pool, never concurrently for one unit, after all Phase 1 workers are done.
  */
-static void process_repo_network(Repo *r) {
-    if (r->path[0] == '\0') return;   /* slot that failed to open in phase 1 */
+static bool net_member_advance(NetUnit *u, Repo *r) {
+    /* coming back from a child: the repo was closed while it ran */
+    if ((u->step == NU_FETCH_DONE || u->step == NU_PROBE_DONE)
+            && git_repository_open(&u->repo, r->path) != 0)
+        u->repo = NULL;
+
+    for (;;) {
+        switch (u->step) {
+        case NU_OPEN:
+            if (r->branch[0] == '\0') return false;   /* failed to open in phase 1 */
+            if (r->timed_out) return false;         /* status deadline passed; leave it alone */
+            if (git_repository_open(&u->repo, r->path) != 0) return false;
+            u->host[0]   = '\0';
+            u->mirror[0] = '\0';
+            u->admitted  = false;
+            u->step = NU_FETCH;
+            break;
 
-    git_repository *repo = NULL;
-    if (git_repository_open(&repo, r->path) != 0) return;
+        case NU_FETCH:
+            u->step = NU_SWITCH;
+            if (opt_probe) {
+                u->step = NU_DONE;
+                if (netexec_cancelled()) {
+                    r->probe_result = PB_CANCELLED;
+                    break;
+                }
+                u->step = NU_PROBE_DONE;         /* set before the hand-off */
+                if (probe_start(u, r)) return true;
+                u->step = NU_DONE;
+                break;
+            }
+            if (!opt_fetch && !opt_pull) break;
+            if (opt_pull && (r->staged || r->modified)) break;   /* pull skips it */
+            if (u->share.fetched && !opt_narrow) {   /* narrow: each its own upstream */
+                r->fetch_result = u->share.fetch_result;
+                r->fetch_refs   = u->share.fetch_refs;
+                if (u->repo) r->fetch_new = upstream_new_commits(u, r, u->repo);
+                r->net_error = u->share.net_error;
+                break;
+            }
+            if (netexec_cancelled()) {          /* Ctrl-C: dispatch nothing new */
+                net_unit_report(u, HOST_UNTRIED);   /* parked on the mirror, maybe */
+                r->fetch_result = FR_CANCELLED;
+                if (opt_pull) r->pull_result = PR_CANCELLED;
+                u->step = NU_DONE;
+                break;
+            }
+            u->step = NU_FETCH_DONE;
+            if (fetch_start(u, r)) return true;
+            net_unit_report(u, HOST_UNTRIED);   /* admitted, then found nothing to do */
+            u->step = NU_SWITCH;
+            u->share.fetched      = true;
+            u->share.fetch_result = r->fetch_result;
+            break;
+
+        case NU_FETCH_DONE:
+            if (u->native && u->rc != 0 && u->rc != NETEXEC_CANCELLED
+                    && u->rc != NETEXEC_TIMEDOUT) {
+                fetch_spawn_git(u, r);          /* fall back: git knows more tricks */
+                return true;
+            }
+            if (narrow_target_missing(u)) {
+                u->nnarrow--;                   /* do_switch reports it not found */
+                fetch_spawn_git(u, r);
+                return true;
+            }
+            if (fetch_retryable(u)) {
+                u->step = NU_RETRY;
+                net_unit_delay(u, fetch_backoff_ms(u));
+                return true;
+            }
+            net_unit_report(u, host_outcome(u));
+            r->net_bytes   = u->bytes;
+            r->net_objects = u->objects;
+            r->net_ms      = u->net_ms;
+            if (u->rc != NETEXEC_CANCELLED && !u->mirror[0])
+                net_account(u->host, u->bytes, u->objects, u->net_ms);
+            r->fetch_result = fetch_finish(u, r);
+            u->share.fetched      = true;
+            u->share.fetch_result = r->fetch_result;
+            u->share.fetch_refs   = r->fetch_refs;
+            u->share.net_error = r->net_error;
+            u->step = NU_SWITCH;
+            break;
 
-    if (opt_fetch) {
-        r->fetch_result = do_fetch(repo, r);
-        /* after fetch the remote-tracking refs are fresh; now switch if requested */
-        if (opt_switch) {
-            r->switch_result = do_switch(repo, r, opt_switch_branch);
+        case NU_RETRY:
+            u->step = NU_FETCH_DONE;
+            if (u->rc == NETEXEC_CANCELLED) break;   /* cancelled while waiting */
+            u->attempt++;
+            fetch_spawn_git(u, r);              /* a native fetch has fallen back already */
+            return true;
+
+        case NU_SWITCH:
+            /* after fetch the remote-tracking refs are fresh; now switch if requested */
+            u->step = NU_PULL;
+            if (r->fetch_result == FR_CANCELLED) {
+                if (opt_pull) r->pull_result = PR_CANCELLED;
+                u->step = NU_DONE;
+                break;
+            }
+            if (!opt_fetch || !opt_switch || !u->repo) break;
+            r->switch_result = do_switch(u->repo, r, opt_switch_branch);
             if (r->switch_result == SR_SWITCHED || r->switch_result == SR_CREATED) {
-                fill_branch(r, repo);
-                fill_status(r, repo);
-                fill_last_commit(r, repo);
+                fill_branch(r, u->repo);
+                fill_status(r, u->repo);
+                fill_last_commit(r, u->repo);
             }
-        }
-    }
+            break;
 
-    if (opt_pull) {
-        r->pull_result = do_pull(repo, r);
-        if (r->pull_result == PR_PULLED) {
-            fill_branch(r, repo);
-            fill_status(r, repo);
+        case NU_PULL:
+            u->step = NU_DONE;
+            if (!opt_pull || !u->repo) break;
+            if (netexec_cancelled()) {
+                r->pull_result = PR_CANCELLED;
+                break;
+            }
+            r->pull_result = pull_fast_forward(u->repo, r);
+            if (r->pull_result == PR_PULLED) {
+                fill_branch(r, u->repo);
+                fill_status(r, u->repo);
+            }
+            break;
+
+        case NU_PROBE_DONE:
+            if (u->native && u->rc != 0 && u->rc != NETEXEC_CANCELLED
+                    && u->rc != NETEXEC_TIMEDOUT) {
+                probe_spawn_git(u);
+                return true;
+            }
+            net_unit_report(u, host_outcome(u));
+            r->probe_result = probe_finish(u, r);
+            u->step = NU_DONE;
+            break;
+
+        case NU_DONE:
+            if (u->repo) {   /* refreshed after any network op; a probe moves no refs */
+                if (!opt_probe) fill_ahead_behind(r, u->repo, wt_group_of(g_wt, r));
+                git_repository_free(u->repo);
+                u->repo = NULL;
+            }
+            return false;
         }
     }
-
-    fill_ahead_behind(r, repo);   /* refreshed after any network op */
-    git_repository_free(repo);
 }
 
-/* ── Thread pool ────────────────────────────────────────────────────────────── */
+/* ── Phase runners ─────────────────────────────────────────────────────────── */
+/*
+ * Phase 1 submits as many runner tasks to the shared pool as it wants
+ * concurrency (-j); every runner drains the queue in job order through an
+ * atomic cursor. Phase 2 submits one task per unit in job order and lets the
+ * NetExec cap the number of live git children (--net-jobs).
+ */
 static _Atomic size_t work_idx = 0;
-static _Atomic size_t net_idx  = 0;
+static Prefetcher    *g_prefetch;      /* warming ahead of work_idx */
+
+/* Phase 1 concurrency: -j, else one per usable CPU (affinity and cgroup quota
+ * respected), capped at 8 -- status work is CPU and disk bound. */
+int status_jobs(void) {
+    if (opt_jobs > 0) return opt_jobs;
+    int n = available_cpus();
+    return n > 8 ? 8 : n;
+}
 
-static void *worker_thread(void *arg) {
-    (void)arg;
-    size_t i;
-    while ((i = atomic_fetch_add(&work_idx, 1)) < g_path_count)
-        process_repo_local(g_paths[i], &g_repos[i]);
-    return NULL;
+/* Phase 2 concurrency: git children mostly wait on the network and cost no
+ * thread of ours, so the default goes well past the core count. */
+int net_jobs(void) {
+    return opt_net_jobs > 0 ? opt_net_jobs : DEFAULT_NET_JOBS;
+}
+
+/* Is Phase 1 all a repo gets? Then it is finished when its status is. */
+static bool local_only(void) {
+    return !opt_fetch && !opt_pull && !opt_probe && !opt_exec;
+}
+
+/* Repo i has been through every phase it gets: stream it out. */
+static void repo_done(size_t i) {
+    ndjson_repo(&g_repos[i]);
+    progressive_repo(i);
 }
 
-static void *net_worker_thread(void *arg) {
+static long ms_since(const struct timespec *t0) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - t0->tv_sec) * 1000 + (now.tv_nsec - t0->tv_nsec) / 1000000;
+}
+
+static void worker_task(void *arg) {
     (void)arg;
-    size_t i;
-    while ((i = atomic_fetch_add(&net_idx, 1)) < g_repo_count)
-        process_repo_network(&g_repos[i]);
-    return NULL;
+    size_t k;
+    while ((k = atomic_fetch_add(&work_idx, 1)) < g_path_count) {
+        prefetch_kick(g_prefetch);
+        size_t i = g_order[k];
+        struct timespec t0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        process_repo_local(g_paths[i], &g_repos[i], g_wt);
+        g_local_ms[i] = ms_since(&t0);
+        if (local_only()) repo_done(i);
+    }
 }
 
-/* Spawn up to nthreads threads running fn, fall back to single-threaded. */
-static void run_thread_pool(int nthreads, void *(*fn)(void *)) {
-    if (nthreads <= 1) {
-        fn(NULL);
-        return;
+static void net_unit_step(void *arg) {
+    NetUnit *u = arg;
+    while (u->j != SIZE_MAX) {
+        Repo *r = &g_repos[u->j];
+        clock_gettime(CLOCK_MONOTONIC, &u->t0);
+        if (net_member_advance(u, r)) return;    /* handed off, time taken */
+        u->ms += ms_since(&u->t0);
+        repo_done(u->j);
+
+        if (!r->timed_out && r->fetch_result != FR_CANCELLED
+                && r->fetch_result != FR_FRESH && r->fetch_result != FR_HOST_DOWN
+                && r->pull_result != PR_CANCELLED
+                && r->probe_result != PB_HOST_DOWN)     /* skipped: says nothing */
+            g_net_ms[u->j] = u->ms;
+        u->j    = wt_next(u->j);
+        u->step    = NU_OPEN;
+        u->ms      = 0;
+        u->attempt = 0;
+        u->bytes   = 0;
+        u->objects = 0;
+        u->net_ms  = 0;
     }
-    pthread_t *threads = malloc((size_t)nthreads * sizeof(pthread_t));
-    if (!threads) { fn(NULL); return; }
+    netexec_release(u->ex);
+    free(u->url);
+    refsnap_free(&u->before);
+    refsnap_free(&u->after);
+    free(u);
+}
+
+/* Run n copies of a runner on the pool and wait for them. */
+static void run_runners(int n, void (*fn)(void *)) {
+    TaskGroup g = { 0 };
+    for (int t = 0; t < n; t++)
+        pool_submit(&g, fn, NULL);
+    pool_wait(&g);
+}
 
-    int created = 0;
-    for (int i = 0; i < nthreads; i++) {
-        if (pthread_create(&threads[i], NULL, fn, NULL) != 0) {
-            fprintf(stderr, "Warning: could not create worker thread %d\n", i);
+/* ── Phase 1 with a per-repo status deadline ───────────────────────────────── */
+/*
+ * With status_timeout set, the calling thread does not wait on the runners
+ * but acts as a watchdog: a repo still being queried when its deadline passes
+ * is resolved as timed out (with the previous watch tick's values, if any),
+ * its runner is written off -- pool_compensate() keeps the pool at width --
+ * and a replacement runner takes over the rest of the queue. The abandoned
+ * runner writes into a private Repo, finds its slot already resolved when
+ * libgit2 finally returns and discards the result, so g_repos is never touched
+ * after the watchdog returns. It owns a copy of its path and a reference to
+ * the worktree table, and frees its libgit2 handles as usual.
+ */
+typedef enum { SLOT_PENDING = 0, SLOT_RUNNING, SLOT_DONE, SLOT_TIMED_OUT } SlotState;
+
+typedef struct {
+    bool            busy;
+    size_t          slot;
+    struct timespec start;      /* CLOCK_MONOTONIC */
+} DeadlineWorker;
+
+typedef struct {
+    pthread_mutex_t  lock;      /* guards everything below except next */
+    pthread_cond_t   cond;      /* signalled whenever a worker finishes a slot */
+    int              refs;      /* watchdog + live workers */
+    size_t           n;
+    _Atomic size_t   next;      /* queue cursor */
+    size_t           resolved;  /* slots DONE or TIMED_OUT */
+    SlotState       *state;
+    DeadlineWorker  *workers;
+    size_t           nworkers;
+    size_t           live;      /* workers that have not been abandoned */
+    Prefetcher      *pf;        /* kicked as next moves; NULL once stopped */
+} Deadline;
+
+typedef struct { Deadline *dl; size_t k; } DeadlineArg;
+
+static _Atomic int g_abandoned = 0;   /* workers still running past their deadline */
+
+/* Never waited on: the watchdog tracks deadline runners itself, and a runner
+ * may outlive the Deadline it was started for. */
+static TaskGroup g_deadline_tasks;
+
+bool workers_outstanding(void) {
+    return atomic_load(&g_abandoned) > 0;
+}
+
+static void deadline_unref(Deadline *dl) {
+    pthread_mutex_lock(&dl->lock);
+    bool last = (--dl->refs == 0);
+    pthread_mutex_unlock(&dl->lock);
+    if (!last) return;
+    pthread_cond_destroy(&dl->cond);
+    pthread_mutex_destroy(&dl->lock);
+    free(dl->state);
+    free(dl->workers);
+    free(dl);
+}
+
+static void deadline_worker(void *arg) {
+    Deadline *dl = ((DeadlineArg *)arg)->dl;
+    size_t    k  = ((DeadlineArg *)arg)->k;
+    free(arg);
+
+    size_t k_next;
+    while ((k_next = atomic_fetch_add(&dl->next, 1)) < dl->n) {
+        size_t i = g_order[k_next];
+        /* the slot is still pending, so the watchdog has not returned and
+         * g_order / g_paths / g_repos / g_wt are safe to read here */
+        char *path = strdup(g_paths[i]);
+        if (!path) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        Repo tmp = g_repos[i];                  /* carries the worktree fields */
+        WorktreeTable *wt = wt_table_ref(g_wt);
+        struct timespec t0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        pthread_mutex_lock(&dl->lock);
+        prefetch_kick(dl->pf);
+        dl->state[i] = SLOT_RUNNING;
+        dl->workers[k].busy = true;
+        dl->workers[k].slot = i;
+        clock_gettime(CLOCK_MONOTONIC, &dl->workers[k].start);
+        pthread_mutex_unlock(&dl->lock);
+
+        process_repo_local(path, &tmp, wt);
+
+        pthread_mutex_lock(&dl->lock);
+        bool mine = (dl->state[i] == SLOT_RUNNING);
+        if (mine) {
+            g_repos[i]          = tmp;
+            g_local_ms[i]       = ms_since(&t0);
+            dl->state[i]        = SLOT_DONE;
+            dl->workers[k].busy = false;
+            dl->resolved++;
+            /* under the lock, so the watchdog cannot return before it is out */
+            if (local_only()) repo_done(i);
+            pthread_cond_signal(&dl->cond);
+        }
+        pthread_mutex_unlock(&dl->lock);
+
+        wt_table_unref(wt);
+        free(path);
+        if (!mine) {                            /* a replacement took over */
+            atomic_fetch_sub(&g_abandoned, 1);
+            pool_release();
             break;
         }
-        created++;
     }
-    for (int i = 0; i < created; i++)
-        pthread_join(threads[i], NULL);
+    deadline_unref(dl);
+}
+
+/* Queue one more runner on the pool. Called with dl->lock held; the pool
+ * must have threads (an inline submit would run under the lock). */
+static bool deadline_spawn(Deadline *dl) {
+    DeadlineWorker *tmp = realloc(dl->workers, (dl->nworkers + 1) * sizeof(*tmp));
+    if (!tmp) return false;
+    dl->workers = tmp;
+    dl->workers[dl->nworkers] = (DeadlineWorker){ 0 };
+
+    DeadlineArg *a = malloc(sizeof(*a));
+    if (!a) return false;
+    a->dl = dl;
+    a->k  = dl->nworkers;
+
+    dl->nworkers++;
+    dl->live++;
+    dl->refs++;
+    pool_submit(&g_deadline_tasks, deadline_worker, a);
+    return true;
+}
+
+/* Resolve slot i as timed out. Called with dl->lock held. */
+static void deadline_expire(Deadline *dl, size_t i) {
+    Repo *r = &g_repos[i];
+    const Repo *prev = cached_status(r->path, i);
+    if (prev) {
+        r->branch      = arena_intern(strings(), prev->branch);   /* outlives prev */
+        r->staged      = prev->staged;
+        r->modified    = prev->modified;
+        r->untracked   = prev->untracked;
+        r->ahead       = prev->ahead;
+        r->behind      = prev->behind;
+        r->has_remote  = prev->has_remote;
+        r->last_commit = prev->last_commit;
+    }
+    r->timed_out = true;
+    g_local_ms[i] = (long)opt_status_timeout * 1000;   /* at least this slow */
+    dl->state[i] = SLOT_TIMED_OUT;
+    dl->resolved++;
+    if (local_only()) repo_done(i);
+}
+
+static void run_phase1_deadline(int nthreads) {
+    Deadline *dl = calloc(1, sizeof(*dl));
+    SlotState *state = calloc(g_path_count, sizeof(*state));
+    if (!dl || !state) {
+        free(dl);
+        free(state);
+        atomic_store(&work_idx, 0);
+        run_runners(nthreads, worker_task);
+        return;
+    }
+    pthread_mutex_init(&dl->lock, NULL);
+    pthread_cond_init(&dl->cond, NULL);
+    dl->refs  = 1;
+    dl->n     = g_path_count;
+    dl->state = state;
+    atomic_init(&dl->next, 0);
+
+    const long limit_ms = (long)opt_status_timeout * 1000;
+
+    Prefetcher *pf = prefetch_start(g_paths, g_order, dl->n, &dl->next, opt_prefetch_depth);
+
+    pthread_mutex_lock(&dl->lock);
+    dl->pf = pf;
+    for (int t = 0; t < nthreads; t++)
+        if (!deadline_spawn(dl)) break;
+
+    while (dl->resolved < dl->n) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long wait_ms = 1000;
+
+        for (size_t k = 0; k < dl->nworkers; k++) {
+            DeadlineWorker *w = &dl->workers[k];
+            if (!w->busy) continue;
+            long elapsed = (now.tv_sec - w->start.tv_sec) * 1000
+                         + (now.tv_nsec - w->start.tv_nsec) / 1000000;
+            if (elapsed < limit_ms) {
+                if (limit_ms - elapsed < wait_ms) wait_ms = limit_ms - elapsed;
+                continue;
+            }
+            w->busy = false;
+            dl->live--;
+            atomic_fetch_add(&g_abandoned, 1);
+            pool_compensate();
+            deadline_expire(dl, w->slot);
+            if (atomic_load(&dl->next) < dl->n)
+                deadline_spawn(dl);
+        }
+
+        /* nobody left to drain the queue (allocation failed): resolve
+         * whatever is still unclaimed as timed out rather than waiting forever */
+        if (dl->live == 0) {
+            size_t q;
+            while ((q = atomic_fetch_add(&dl->next, 1)) < dl->n)
+                deadline_expire(dl, g_order[q]);
+        }
+        if (dl->resolved >= dl->n) break;
+
+        /* macOS has no pthread_condattr_setclock, so wait on the realtime clock */
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_sec  += wait_ms / 1000;
+        until.tv_nsec += (wait_ms % 1000) * 1000000;
+        if (until.tv_nsec >= 1000000000) { until.tv_sec++; until.tv_nsec -= 1000000000; }
+        pthread_cond_timedwait(&dl->cond, &dl->lock, &until);
+    }
+    dl->pf = NULL;        /* abandoned workers may still move the cursor */
+    pthread_mutex_unlock(&dl->lock);
+    prefetch_stop(pf);    /* before dl (and its cursor) can go away */
+    deadline_unref(dl);
+}
+
+/* ── Job order ─────────────────────────────────────────────────────────────── */
+/*
+ * Longest-job-first: with the repos sorted by their historical duration the
+ * few giants start immediately instead of being picked up last by a single
+ * thread while the others sit idle. Repos without history go first -- they
+ * may well be the giants -- and ties keep scan order.
+ */
+typedef struct { long cost; size_t idx; } CostKey;
+
+static int cost_cmp(const void *a, const void *b) {
+    const CostKey *x = a, *y = b;
+    if (x->cost != y->cost) return x->cost > y->cost ? -1 : 1;
+    return x->idx < y->idx ? -1 : x->idx > y->idx;
+}
+
+static void sort_by_cost(CostKey *keys, size_t *order, size_t n) {
+    qsort(keys, n, sizeof(*keys), cost_cmp);
+    for (size_t k = 0; k < n; k++) order[k] = keys[k].idx;
+}
+
+static void build_orders(void) {
+    g_order     = malloc(g_path_count * sizeof(*g_order));
+    g_net_order = malloc(g_path_count * sizeof(*g_net_order));
+    g_local_ms  = malloc(g_path_count * sizeof(*g_local_ms));
+    g_net_ms    = malloc(g_path_count * sizeof(*g_net_ms));
+    if (!g_order || !g_net_order || !g_local_ms || !g_net_ms) {
+        fprintf(stderr, "Error: out of memory\n");
+        exit(1);
+    }
+    g_net_count = 0;
+    for (size_t i = 0; i < g_path_count; i++) {
+        g_order[i]    = i;
+        g_local_ms[i] = -1;
+        g_net_ms[i]   = -1;
+        /* worktree groups are handled as one unit by their leader's worker */
+        if (!g_repos[i].wt_group || g_wt->groups[g_repos[i].wt_group - 1].leader == i)
+            g_net_order[g_net_count++] = i;
+    }
 
-    if (created == 0)
-        fn(NULL);
+    if (opt_job_order == ORDER_DISK) {
+        sort_by_location(g_paths, g_order, g_path_count);
+        return;
+    }
+    if (opt_job_order != ORDER_LONGEST) return;
 
-    free(threads);
+    CostKey *keys = malloc(g_path_count * sizeof(*keys));
+    if (!keys) return;                          /* scan order it is */
+    for (size_t i = 0; i < g_path_count; i++) {
+        long ms = timings_get(g_paths[i], TIMING_LOCAL);
+        keys[i] = (CostKey){ ms < 0 ? LONG_MAX : ms, i };
+    }
+    sort_by_cost(keys, g_order, g_path_count);
+
+    if (opt_fetch || opt_pull || opt_probe) {
+        for (size_t k = 0; k < g_net_count; k++) {
+            long sum = 0;
+            for (size_t j = g_net_order[k]; j != SIZE_MAX && sum != LONG_MAX; j = wt_next(j)) {
+                long ms = timings_get(g_paths[j], TIMING_NET);
+                sum = ms < 0 ? LONG_MAX : sum + ms;
+            }
+            keys[k] = (CostKey){ sum, g_net_order[k] };
+        }
+        sort_by_cost(keys, g_net_order, g_net_count);
+    }
+    free(keys);
+}
+
+static void record_timings(const long *ms, TimingPhase phase) {
+    if (opt_job_order != ORDER_LONGEST) return;
+    for (size_t i = 0; i < g_path_count; i++)
+        if (ms[i] >= 0) timings_put(g_paths[i], phase, ms[i]);
 }
 
 /* ── process_all_repos ─────────────────────────────────────────────────────── */
@@ -624,45 +2219,110 @@ void process_all_repos(const char *dir) {
     g_repos = calloc(g_path_count, sizeof(Repo));
     if (!g_repos) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
     g_repo_count = g_path_count;
+    for (size_t i = 0; i < g_repo_count; i++)
+        g_repos[i] = (Repo){ .path = g_paths[i], .branch = "", .net_error = "" };
 
-    /* choose thread count: CPU cores, capped at 8, no more than repo count */
-#if defined(_SC_NPROCESSORS_ONLN)
-    long _ncpus = sysconf(_SC_NPROCESSORS_ONLN);
-    int nthreads = (_ncpus > 0) ? (int)_ncpus : 4;
-#else
-    int nthreads = 4;
-#endif
-    if (nthreads > 8) nthreads = 8;
+    group_worktrees();
+    build_orders();
+    progressive_start(dir);
+    if (opt_shared_cache && (opt_fetch || opt_pull))
+        g_objcache = objcache_new();
+
+    /* never more runners than repos */
+    int nthreads = status_jobs();
     if ((size_t)nthreads > g_path_count) nthreads = (int)g_path_count;
 
-    /* ── Phase 1: parallel local libgit2 queries ── */
-    atomic_store(&work_idx, 0);
-    run_thread_pool(nthreads, worker_thread);
+    /* ── Phase 1: parallel local libgit2 queries ──
+     * The watchdog needs real pool threads; inline mode just runs the queue. */
+    if (opt_status_timeout > 0 && pool_size() > 0) {
+        run_phase1_deadline(nthreads);
+    } else {
+        atomic_store(&work_idx, 0);
+        g_prefetch = prefetch_start(g_paths, g_order, g_path_count, &work_idx,
+                                    opt_prefetch_depth);
+        run_runners(nthreads, worker_task);
+        prefetch_stop(g_prefetch);
+        g_prefetch = NULL;
+    }
+    record_timings(g_local_ms, TIMING_LOCAL);
 
-    /* ── Phase 2: parallel subprocess fetch/pull ──
+    /* ── Phase 2: fetch/pull children on the NetExec loop ──
      * Stop the Phase 1 spinner before starting Phase 2 so we can print an
      * inter-phase status line and start a fresh spinner with the network verb.
      * spinner_stop() is idempotent; the matching call in main() becomes a no-op.
      * The Phase 2 spinner uses write() (async-signal-safe) so it can run safely
-     * alongside the fork() calls in net_worker_thread. */
-    if (opt_fetch || opt_pull) {
+     * alongside the posix_spawn() calls of the executor. */
+    if (opt_fetch || opt_pull || opt_probe) {
         /* watch mode renders on the alternate screen and shows its own
-         * progress, so the inter-phase line and spinner are suppressed there */
-        if (!opt_watch) {
+         * progress, and ndjson and --progressive are printing rows already,
+         * so the inter-phase line and spinner are suppressed there */
+        if (!opt_watch && opt_format == FMT_TABLE && opt_progressive == PROG_OFF) {
             spinner_stop();
             printf("  Found %zu repo%s\n", g_path_count,
                    g_path_count == 1 ? "" : "s");
             fflush(stdout);
 
-            const char *verb = opt_fetch ? "Fetching:" : "Pulling:";
+            const char *verb = opt_fetch ? "Fetching:"
+                             : opt_pull  ? "Pulling:" : "Probing:";
             char phase2[PATH_MAX + 64];
             snprintf(phase2, sizeof(phase2), "%s%s%s %s",
                      C(COL_BOLD), verb, C(COL_RESET), dir);
             spinner_start(phase2);
         }
 
-        atomic_store(&net_idx, 0);
-        run_thread_pool(nthreads, net_worker_thread);
+        int net_children = net_jobs();
+        if ((size_t)net_children > g_net_count) net_children = (int)g_net_count;
+
+        NetExec *ex = netexec_new(g_git_path, net_children, opt_host_jobs);
+        if (!ex) {
+            fprintf(stderr, "Error: could not set up git subprocesses\n");
+            exit(1);
+        }
+        if (opt_net_timeout > 0) {
+            netexec_set_timeout(ex, opt_net_timeout * 1000);
+            /* native jobs only notice the deadline in a callback: make libgit2's
+             * own connects and reads give up by then too (ignored before 1.7) */
+            int ms = opt_net_timeout > INT_MAX / 1000 ? INT_MAX : (int)(opt_net_timeout * 1000);
+            git_libgit2_opts(GIT_OPT_SET_SERVER_CONNECT_TIMEOUT, ms);
+            git_libgit2_opts(GIT_OPT_SET_SERVER_TIMEOUT, ms);
+        }
+        /* units queue their children in job order, the executor interleaves
+         * remote hosts; this thread runs the loop */
+        TaskGroup g = { 0 };
+        for (size_t k = 0; k < g_net_count; k++) {
+            NetUnit *u = calloc(1, sizeof(*u));
+            if (!u) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+            u->j     = g_net_order[k];
+            u->ex    = ex;
+            u->group = &g;
+            netexec_hold(ex);
+            pool_submit(&g, net_unit_step, u);
+        }
+        /* watch mode routes its own signals and cancel key to netexec_cancel */
+        struct sigaction sa = { 0 }, old_int, old_term;
+        sa.sa_handler = netexec_on_signal;
+        sa.sa_flags   = SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (!opt_watch) {
+            sigaction(SIGINT,  &sa, &old_int);
+            sigaction(SIGTERM, &sa, &old_term);
+        }
+        struct timespec t0;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        free_net_hosts();
+        netexec_run(ex);
+        pool_wait(&g);
+        g_net_wall_ms = ms_since(&t0);
+        qsort(g_net_hosts, g_net_host_count, sizeof(*g_net_hosts), net_host_cmp);
+        netexec_free(ex);
+        objcache_free(g_objcache);
+        g_objcache = NULL;
+        if (!opt_watch) {
+            sigaction(SIGINT,  &old_int,  NULL);
+            sigaction(SIGTERM, &old_term, NULL);
+        }
+        if (!opt_probe)                /* a probe says little about fetch times */
+            record_timings(g_net_ms, TIMING_NET);
 
         if (!opt_watch) spinner_stop();
     }
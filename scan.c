@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
 #include <fnmatch.h>
@@ -22,27 +23,55 @@ static int should_skip(const char *name) {
     return 0;
 }
 
-void find_repos(const char *path, int depth) {
-    if (depth > opt_max_depth) return;
+/*
+ * The walk runs on the pool: every directory is one task, which lists its
+ * subdirectories into its node (in readdir order) and submits a task for
+ * each. Once the whole tree is done it is flattened depth first -- a repo
+ * before anything below it, siblings in readdir order -- so g_paths comes out
+ * exactly as a sequential recursive walk would produce it.
+ */
+typedef struct ScanNode {
+    char             *path;
+    int               depth;
+    bool              is_repo;
+    struct ScanNode **kids;     /* subdirectories within max_depth, readdir order */
+    size_t            nkids;
+    TaskGroup        *group;
+} ScanNode;
+
+static ScanNode *scan_node_new(const char *path, int depth, TaskGroup *group) {
+    ScanNode *n = calloc(1, sizeof(*n));
+    if (!n) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    n->path = strdup(path);
+    if (!n->path) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    n->depth = depth;
+    n->group = group;
+    return n;
+}
+
+static void scan_task(void *arg) {
+    ScanNode *node = arg;
 
     /* if this directory is a git repo, collect its path then keep recursing */
     char git_path[PATH_MAX];
-    int n = snprintf(git_path, sizeof(git_path), "%s/.git", path);
+    int n = snprintf(git_path, sizeof(git_path), "%s/.git", node->path);
     if (n > 0 && n < (int)sizeof(git_path)) {
         struct stat st;
-        if (stat(git_path, &st) == 0) collect_path(path);
+        node->is_repo = (stat(git_path, &st) == 0);
     }
+    if (node->depth + 1 > opt_max_depth) return;
 
-    DIR *dir = opendir(path);
+    DIR *dir = opendir(node->path);
     if (!dir) return;
 
+    size_t cap = 0;
     struct dirent *ent;
     while ((ent = readdir(dir)) != NULL) {
         if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
         if (should_skip(ent->d_name)) continue;
 
         char sub[PATH_MAX];
-        int m = snprintf(sub, sizeof(sub), "%s/%s", path, ent->d_name);
+        int m = snprintf(sub, sizeof(sub), "%s/%s", node->path, ent->d_name);
         if (m <= 0 || m >= (int)sizeof(sub)) continue;  /* path too long, skip */
 
         struct stat sub_st;
@@ -50,7 +79,41 @@ void find_repos(const char *path, int depth) {
         if (lstat(sub, &sub_st) != 0) continue;
         if (!S_ISDIR(sub_st.st_mode)) continue;
 
-        find_repos(sub, depth + 1);
+        if (node->nkids == cap) {
+            cap = cap ? cap * 2 : 8;
+            ScanNode **tmp = realloc(node->kids, cap * sizeof(*tmp));
+            if (!tmp) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+            node->kids = tmp;
+        }
+        node->kids[node->nkids++] = scan_node_new(sub, node->depth + 1, node->group);
     }
     closedir(dir);
+
+    /* only once the list is final: children never touch their parent */
+    for (size_t k = 0; k < node->nkids; k++)
+        pool_submit(node->group, scan_task, node->kids[k]);
+}
+
+static void scan_flatten(ScanNode *node) {
+    if (node->is_repo) collect_path(node->path);
+    for (size_t k = 0; k < node->nkids; k++)
+        scan_flatten(node->kids[k]);
+    for (size_t k = 0; k < node->nkids; k++) {
+        free(node->kids[k]->path);
+        free(node->kids[k]);
+    }
+    free(node->kids);
+}
+
+void find_repos(const char *path, int depth) {
+    if (depth > opt_max_depth) return;
+
+    TaskGroup g = { 0 };
+    ScanNode *root = scan_node_new(path, depth, &g);
+    pool_submit(&g, scan_task, root);
+    pool_wait(&g);
+
+    scan_flatten(root);
+    free(root->path);
+    free(root);
 }
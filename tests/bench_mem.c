@@ -0,0 +1,200 @@
+/*
+ * tests/bench_mem.c – memory and walk cost of the repo collection
+ *
+ * Builds a synthetic sweep of N repos (default 100000; `make bench N=...`) in
+ * the current layout -- slim Repo rows, paths and interned branch names in a
+ * string arena -- and in the layout it replaced, where every row embedded
+ * path[PATH_MAX], branch[256] and net_error[256] and g_paths held a strdup of
+ * every path besides. Reports the bytes each takes and the time of the pass
+ * compute_col_widths() makes over every row, then the real thing.
+ *
+ * Bytes are what is asked of malloc; its per-allocation overhead, which only
+ * the old layout pays per path, is not counted.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../gitools.h"
+
+/* globals normally defined in main.c */
+int    opt_max_depth             = 5;
+bool   opt_all                   = false;
+bool   opt_no_color              = true;
+bool   opt_verbose               = false;
+bool   opt_switch                = false;
+char   opt_switch_branch[256]    = "";
+bool   opt_fetch                 = false;
+bool   opt_pull                  = false;
+bool   opt_probe                 = false;
+bool   opt_watch                 = false;
+int    opt_watch_interval        = 3;
+bool   opt_dirty_only            = false;
+int    opt_status_timeout        = 0;
+int    opt_prefetch_depth        = 16;
+JobOrder opt_job_order           = ORDER_SCAN;
+int    opt_jobs                  = 0;
+int    opt_net_jobs              = 0;
+int    opt_host_jobs             = 0;
+bool   opt_native_fetch          = true;
+long   opt_max_age               = 0;
+bool   opt_shared_cache          = false;
+bool   opt_narrow                = false;
+long   opt_net_timeout           = 0;
+int    opt_net_retries           = 2;
+int    opt_host_fail_limit       = 3;
+long   opt_host_cooldown         = 600;
+bool   opt_net_stats             = false;
+bool   opt_exec                  = false;
+char **opt_exec_argv             = NULL;
+OutputFormat opt_format          = FMT_TABLE;
+Progressive opt_progressive      = PROG_OFF;
+char   opt_default_dir[PATH_MAX] = "";
+char **opt_extra_skip            = NULL;
+size_t opt_extra_skip_count      = 0;
+
+/* Repo as it was: strings inline. */
+typedef struct {
+    char         path[PATH_MAX];
+    char         branch[256];
+    int          staged;
+    int          modified;
+    int          untracked;
+    size_t       ahead;
+    size_t       behind;
+    int          has_remote;
+    git_time_t   last_commit;
+    SwitchResult switch_result;
+    FetchResult  fetch_result;
+    PullResult   pull_result;
+    ProbeResult  probe_result;
+    ExecResult   exec_result;
+    int          exec_status;
+    char        *exec_out;
+    long         exec_ms;
+    int          fetch_refs;
+    size_t       fetch_new;
+    char         net_error[256];
+    uint64_t     net_bytes;
+    size_t       net_objects;
+    long         net_ms;
+    int          wt_group;
+    bool         wt_linked;
+    const char  *wt_main;
+    bool         timed_out;
+} LegacyRepo;
+
+static const char *const BRANCHES[] = {
+    "main", "main", "main", "main", "master", "master", "develop",
+    "release/2026.10", "feature/login", "fix/flaky-test",
+};
+
+static double ms_since(const struct timespec *t0) {
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (double)(t1.tv_sec - t0->tv_sec) * 1e3 + (double)(t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+/* The fields the width pass reads, for either layout. */
+#define WALK(rows, n, sum) do {                                             \
+    for (size_t i_ = 0; i_ < (n); i_++) {                                   \
+        const char *name_ = strrchr((rows)[i_].path, '/');                  \
+        (sum) += (size_t)utf8_width(name_ ? name_ + 1 : (rows)[i_].path);   \
+        (sum) += (size_t)utf8_width((rows)[i_].branch);                     \
+        (sum) += (rows)[i_].ahead + (rows)[i_].behind                       \
+               + (size_t)(rows)[i_].last_commit + (size_t)(rows)[i_].timed_out; \
+    }                                                                       \
+} while (0)
+
+static void fill_path(char *buf, size_t n, size_t i) {
+    snprintf(buf, n, "/home/dev/src/org-%03zu/team-%02zu/service-%06zu",
+             i / 1000, i / 50 % 20, i);
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    if (n == 0) n = 1;
+    time_t now = time(NULL);
+    char path[PATH_MAX], detached[16];
+    struct timespec t0;
+
+    /* before */
+    LegacyRepo *old = calloc(n, sizeof(*old));
+    char **old_paths = malloc(n * sizeof(*old_paths));
+    if (!old || !old_paths) { fprintf(stderr, "Error: out of memory\n"); return 1; }
+    size_t old_bytes = n * sizeof(*old) + n * sizeof(*old_paths);
+    for (size_t i = 0; i < n; i++) {
+        fill_path(path, sizeof(path), i);
+        old_paths[i] = strdup(path);
+        if (!old_paths[i]) { fprintf(stderr, "Error: out of memory\n"); return 1; }
+        old_bytes += strlen(path) + 1;
+        snprintf(old[i].path, sizeof(old[i].path), "%s", path);
+        snprintf(old[i].branch, sizeof(old[i].branch), "%s", BRANCHES[i % 10]);
+        old[i].last_commit = now - (git_time_t)(i % 86400);
+        old[i].ahead = i % 3;
+    }
+
+    /* after: as collect_path and fill_branch build it */
+    StrArena *a = arena_new();
+    g_paths = malloc(n * sizeof(*g_paths));
+    g_repos = calloc(n, sizeof(*g_repos));
+    if (!g_paths || !g_repos) { fprintf(stderr, "Error: out of memory\n"); return 1; }
+    g_path_count = g_repo_count = n;
+    for (size_t i = 0; i < n; i++) {
+        fill_path(path, sizeof(path), i);
+        g_paths[i] = arena_strdup(a, path);
+        Repo *r = &g_repos[i];
+        *r = (Repo){ .path = g_paths[i], .net_error = "" };
+        if (i % 1000 == 999) {                      /* the odd detached HEAD */
+            snprintf(detached, sizeof(detached), "(%07zx)", i);
+            r->branch = arena_intern(a, detached);
+        } else {
+            r->branch = arena_intern(a, BRANCHES[i % 10]);
+        }
+        r->last_commit = now - (git_time_t)(i % 86400);
+        r->ahead = i % 3;
+    }
+    size_t new_bytes = n * sizeof(Repo) + n * sizeof(*g_paths) + arena_footprint(a);
+
+    printf("%zu repos\n\n", n);
+    printf("  %-8s %9s %12s %10s\n", "layout", "row", "total", "per repo");
+    printf("  %-8s %8zuB %10.1fMB %9zuB\n", "before", sizeof(LegacyRepo),
+           (double)old_bytes / 1048576, old_bytes / n);
+    printf("  %-8s %8zuB %10.1fMB %9zuB\n", "after", sizeof(Repo),
+           (double)new_bytes / 1048576, new_bytes / n);
+    printf("  %.1fx smaller\n\n", (double)old_bytes / (double)new_bytes);
+
+    size_t sum = 0;
+    double old_ms = 1e30, new_ms = 1e30, widths_ms = 1e30;
+    for (int round = 0; round < 5; round++) {       /* best of five */
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        WALK(old, n, sum);
+        double ms = ms_since(&t0);
+        if (ms < old_ms) old_ms = ms;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        WALK(g_repos, n, sum);
+        ms = ms_since(&t0);
+        if (ms < new_ms) new_ms = ms;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        ColWidths w = compute_col_widths();
+        ms = ms_since(&t0);
+        if (ms < widths_ms) widths_ms = ms;
+        sum += (size_t)w.name;
+    }
+    printf("  width pass fields, before  %8.2f ms\n", old_ms);
+    printf("  width pass fields, after   %8.2f ms\n", new_ms);
+    printf("  compute_col_widths()       %8.2f ms\n", widths_ms);
+    if (sum == 42) printf("\n");                    /* keep the walks */
+
+    for (size_t i = 0; i < n; i++) free(old_paths[i]);
+    free(old_paths);
+    free(old);
+    free(g_repos);
+    free(g_paths);
+    arena_free(a);
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * tests/bench_width.c – cost of measuring display width
+ *
+ * Runs utf8_width() over three corpora of N strings (default 100000;
+ * `make bench N=...`) with each ASCII run kernel this CPU has, and the
+ * code-point counter it replaced -- one byte test per character, and wrong
+ * for wide and combining characters -- as the baseline:
+ *
+ *   ascii     repo paths as bench_mem builds them, and branch names
+ *   cjk       the same with CJK directory and branch names
+ *   accented  European names, half of them with decomposed accents
+ *
+ * Reports the best of five passes in ns per string and MB/s.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../gitools.h"
+
+/* globals normally defined in main.c */
+int    opt_max_depth             = 5;
+bool   opt_all                   = false;
+bool   opt_no_color              = true;
+bool   opt_verbose               = false;
+bool   opt_switch                = false;
+char   opt_switch_branch[256]    = "";
+bool   opt_fetch                 = false;
+bool   opt_pull                  = false;
+bool   opt_probe                 = false;
+bool   opt_watch                 = false;
+int    opt_watch_interval        = 3;
+bool   opt_dirty_only            = false;
+int    opt_status_timeout        = 0;
+int    opt_prefetch_depth        = 16;
+JobOrder opt_job_order           = ORDER_SCAN;
+int    opt_jobs                  = 0;
+int    opt_net_jobs              = 0;
+int    opt_host_jobs             = 0;
+bool   opt_native_fetch          = true;
+long   opt_max_age               = 0;
+bool   opt_shared_cache          = false;
+bool   opt_narrow                = false;
+long   opt_net_timeout           = 0;
+int    opt_net_retries           = 2;
+int    opt_host_fail_limit       = 3;
+long   opt_host_cooldown         = 600;
+bool   opt_net_stats             = false;
+bool   opt_exec                  = false;
+char **opt_exec_argv             = NULL;
+OutputFormat opt_format          = FMT_TABLE;
+Progressive opt_progressive      = PROG_OFF;
+char   opt_default_dir[PATH_MAX] = "";
+char **opt_extra_skip            = NULL;
+size_t opt_extra_skip_count      = 0;
+
+static const char *const BRANCHES[] = {
+    "main", "master", "develop", "release/2026.10", "feature/login",
+};
+static const char *const CJK[] = {
+    "\xe6\x9c\x8d\xe5\x8a\xa1",                         /* 服务 */
+    "\xe3\x83\x97\xe3\x83\xad\xe3\x82\xb8\xe3\x82\xa7\xe3\x82\xaf\xe3\x83\x88", /* プロジェクト */
+    "\xec\x84\x9c\xeb\xb9\x84\xec\x8a\xa4",             /* 서비스 */
+    "\xe6\xa9\x9f\xe8\x83\xbd/\xe3\x83\xad\xe3\x82\xb0\xe3\x82\xa4\xe3\x83\xb3", /* 機能/ログイン */
+};
+static const char *const ACCENTED[] = {
+    "caf\xc3\xa9-r\xc3\xa9seau",                        /* café-réseau, precomposed */
+    "cafe\xcc\x81-re\xcc\x81seau",                      /* the same, decomposed */
+    "na\xc3\xafve-\xc3\xbc" "bersicht",                 /* naïve-übersicht */
+    "se\xc3\xb1or-ma\xc3\xb1" "ana",                    /* señor-mañana */
+};
+
+/* The measure before width.c: one column per code point. */
+static int legacy_width(const char *s) {
+    int w = 0;
+    const unsigned char *p = (const unsigned char *)s;
+    while (*p) {
+        int seqlen;
+        if      (*p < 0x80) seqlen = 1;
+        else if (*p < 0xE0) seqlen = 2;
+        else if (*p < 0xF0) seqlen = 3;
+        else                seqlen = 4;
+        for (int j = 1; j < seqlen; j++)
+            if (p[j] == '\0') return w;
+        p += seqlen;
+        w++;
+    }
+    return w;
+}
+
+static double ms_since(const struct timespec *t0) {
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (double)(t1.tv_sec - t0->tv_sec) * 1e3 + (double)(t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+typedef struct {
+    const char *name;
+    char      **s;
+    size_t      bytes;
+} Corpus;
+
+static void fill(Corpus *c, size_t n, int kind) {
+    c->s = malloc(n * sizeof(*c->s));
+    if (!c->s) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+    c->bytes = 0;
+    char buf[PATH_MAX];
+    for (size_t i = 0; i < n; i++) {
+        if (kind == 0 && i % 2)
+            snprintf(buf, sizeof(buf), "%s", BRANCHES[i / 2 % 5]);
+        else if (kind == 0)
+            snprintf(buf, sizeof(buf), "/home/dev/src/org-%03zu/team-%02zu/service-%06zu",
+                     i / 1000, i / 50 % 20, i);
+        else if (kind == 1 && i % 2)
+            snprintf(buf, sizeof(buf), "%s-%zu", CJK[i / 2 % 4], i % 100);
+        else if (kind == 1)
+            snprintf(buf, sizeof(buf), "/home/dev/src/%s/%s-%06zu", CJK[i % 4], CJK[i / 4 % 4], i);
+        else
+            snprintf(buf, sizeof(buf), "%s-%zu", ACCENTED[i % 4], i % 1000);
+        c->s[i] = strdup(buf);
+        if (!c->s[i]) { fprintf(stderr, "Error: out of memory\n"); exit(1); }
+        c->bytes += strlen(buf);
+    }
+}
+
+/* Best of five passes over the corpus, in ms. */
+static double run(const Corpus *c, size_t n, int (*fn)(const char *), size_t *sum) {
+    double best = 1e30;
+    struct timespec t0;
+    for (int round = 0; round < 5; round++) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (size_t i = 0; i < n; i++)
+            *sum += (size_t)fn(c->s[i]);
+        double ms = ms_since(&t0);
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static void report(const char *what, double ms, size_t n, size_t bytes) {
+    printf("  %-10s %8.1f ns %9.0f MB/s\n", what, ms * 1e6 / (double)n,
+           (double)bytes / 1048576 / (ms / 1e3));
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    if (n == 0) n = 1;
+
+    Corpus corpora[] = { { .name = "ascii" }, { .name = "cjk" }, { .name = "accented" } };
+    for (int k = 0; k < 3; k++) fill(&corpora[k], n, k);
+
+    static const struct { WidthKernel k; const char *name; } KERNELS[] = {
+        { WIDTH_SWAR, "swar" }, { WIDTH_SSE2, "sse2" }, { WIDTH_AVX2, "avx2" },
+    };
+
+    size_t sum = 0;
+    printf("%zu strings per corpus, per string\n", n);
+    for (int k = 0; k < 3; k++) {
+        const Corpus *c = &corpora[k];
+        printf("\n%s (%.1f bytes avg)\n", c->name, (double)c->bytes / (double)n);
+        report("legacy", run(c, n, legacy_width, &sum), n, c->bytes);
+        for (size_t j = 0; j < sizeof(KERNELS) / sizeof(*KERNELS); j++) {
+            if (!width_kernel_set(KERNELS[j].k)) continue;
+            report(KERNELS[j].name, run(c, n, utf8_width, &sum), n, c->bytes);
+        }
+        width_kernel_set(WIDTH_AUTO);
+    }
+    if (sum == 42) printf("\n");                    /* keep the passes */
+
+    for (int k = 0; k < 3; k++) {
+        for (size_t i = 0; i < n; i++) free(corpora[k].s[i]);
+        free(corpora[k].s);
+    }
+    return 0;
+}
@@ -4,6 +4,8 @@
 GITLS="$(cd "$(dirname "$0")/.." && pwd)/gitls"
 WORK=$(mktemp -d)
 trap 'rm -rf "$WORK"' EXIT
+# keep the timings cache out of the real ~/.cache
+XDG_CACHE_HOME="$WORK/.cache"; export XDG_CACHE_HOME
 passed=0
 failed=0
 
@@ -249,9 +251,224 @@ printf 'second\n' >> "$FETCH_SETUP/README"
 git -C "$FETCH_SETUP" add README
 git -C "$FETCH_SETUP" commit -q -m "second"
 git -C "$FETCH_SETUP" push -q origin HEAD
-check "fetched"      "fetched 1"    "$GITLS" --no-color fetch "$FETCH_REPO"
+check "fetched"      "1 ref updated, 1 new commit on upstream" \
+    "$GITLS" --no-color fetch "$FETCH_REPO"
 # second fetch: nothing new → up to date
 check "up to date"   "up to date 1" "$GITLS" --no-color fetch "$FETCH_REPO"
+# a branch other than the checked-out one, and a tag, still count
+git -C "$FETCH_SETUP" push -q origin HEAD:refs/heads/other
+git -C "$FETCH_SETUP" tag v1
+git -C "$FETCH_SETUP" push -q origin v1
+check "other refs fetched" "2 refs updated" "$GITLS" --no-color fetch "$FETCH_REPO"
+
+# ── fetch: --max-age ──────────────────────────────────────────────────────────
+printf "\nfetch: --max-age\n"
+printf 'fourth\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "fourth"
+git -C "$FETCH_SETUP" push -q origin HEAD
+check "just fetched is fresh" "fresh 1" "$GITLS" --no-color fetch --max-age=1h "$FETCH_REPO"
+touch -t 200001010000 "$FETCH_REPO/.git/FETCH_HEAD"
+check "stale is fetched" "fetched 1" "$GITLS" --no-color fetch --max-age 1h "$FETCH_REPO"
+printf 'max_age=1d\n' > "$WORK/maxage.gitlsrc"
+check "max_age config key" "fresh 1" \
+    env GITLS_CONFIG="$WORK/maxage.gitlsrc" "$GITLS" --no-color fetch "$FETCH_REPO"
+check_exit "bad duration rejected" 1 "$GITLS" fetch --max-age=soon "$FETCH_REPO"
+
+# ── fetch: native (libgit2) vs git ────────────────────────────────────────────
+printf "\nfetch: native libgit2 fetch\n"
+# a git that fails everything but --version: only the native path can succeed with it first on PATH
+FAKEBIN="$WORK/fakebin"; mkdir -p "$FAKEBIN"
+printf '#!/bin/sh\n[ "$1" = --version ] && exec echo "git version 0"\necho "fake git: refusing" >&2\nexit 1\n' > "$FAKEBIN/git"
+chmod +x "$FAKEBIN/git"
+git -C "$FETCH_REPO" remote set-url origin "file://$BARE"
+printf 'third\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "third"
+git -C "$FETCH_SETUP" push -q origin HEAD
+check "file:// fetched in-process" "fetched 1" \
+    env PATH="$FAKEBIN:$PATH" "$GITLS" --no-color fetch "$FETCH_REPO"
+check "ref advanced" "$(git -C "$FETCH_SETUP" rev-parse HEAD)" \
+    git -C "$FETCH_REPO" rev-parse origin/HEAD
+printf 'native_fetch=false\n' > "$WORK/nonative.gitlsrc"
+check "native_fetch=false runs git" "fake git: refusing" \
+    env PATH="$FAKEBIN:$PATH" GITLS_CONFIG="$WORK/nonative.gitlsrc" \
+    "$GITLS" --no-color fetch "$FETCH_REPO"
+git -C "$FETCH_REPO" remote set-url origin "$WORK/no-such-origin.git"
+check "native failure falls back to git" "fake git: refusing" \
+    env PATH="$FAKEBIN:$PATH" "$GITLS" --no-color fetch "$FETCH_REPO"
+git -C "$FETCH_REPO" remote set-url origin "$BARE"
+
+# ── probe ─────────────────────────────────────────────────────────────────────
+printf "\nprobe\n"
+check "in sync after fetch" "in sync 1" "$GITLS" --no-color probe "$FETCH_REPO"
+printf 'fifth\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "fifth"
+git -C "$FETCH_SETUP" push -q origin HEAD
+tip=$(git -C "$FETCH_REPO" rev-parse refs/remotes/origin/HEAD)
+check "upstream change seen (git ls-remote)" "changed 1" \
+    env GITLS_CONFIG="$WORK/nonative.gitlsrc" "$GITLS" --no-color probe "$FETCH_REPO"
+git -C "$FETCH_REPO" remote set-url origin "file://$BARE"
+check "upstream change seen (in-process)" "↻ changed" \
+    env PATH="$FAKEBIN:$PATH" "$GITLS" --no-color probe "$FETCH_REPO"
+check "probe downloads nothing" "$tip" git -C "$FETCH_REPO" rev-parse refs/remotes/origin/HEAD
+check "probe without origin" "no remote 1" "$GITLS" --no-color probe "$WORK/fetch-noremote"
+git -C "$FETCH_REPO" remote set-url origin "$BARE"
+
+# ── fetch: --narrow ───────────────────────────────────────────────────────────
+printf "\nfetch: --narrow\n"
+other=$(git -C "$FETCH_REPO" rev-parse origin/other)
+printf 'narrow\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "narrow"
+git -C "$FETCH_SETUP" push -q origin HEAD HEAD:refs/heads/other
+git -C "$FETCH_SETUP" tag v-narrow
+git -C "$FETCH_SETUP" push -q origin v-narrow
+check "only the upstream counted" "fetched  1 ref updated," \
+    "$GITLS" --no-color fetch --narrow "$FETCH_REPO"
+check "other branch left alone" "$other" git -C "$FETCH_REPO" rev-parse origin/other
+check_exit "no tags" 1 git -C "$FETCH_REPO" rev-parse -q --verify refs/tags/v-narrow
+check "missing -s branch is not a fetch error (git)" "branch not found" \
+    env GITLS_CONFIG="$WORK/nonative.gitlsrc" \
+    "$GITLS" --no-color -v fetch --narrow -s no-such-branch "$FETCH_REPO"
+check "-s branch fetched and switched to" "switched" \
+    "$GITLS" --no-color -v fetch --narrow -s other "$FETCH_REPO"
+check "-s branch advanced" "$(git -C "$FETCH_SETUP" rev-parse HEAD)" \
+    git -C "$FETCH_REPO" rev-parse origin/other
+git -C "$FETCH_REPO" checkout -q -
+git -C "$FETCH_REPO" checkout -q -b never-pushed
+check "unpushed branch fetches everything (git)" "✓ fetched" \
+    env GITLS_CONFIG="$WORK/nonative.gitlsrc" "$GITLS" --no-color fetch --narrow "$FETCH_REPO"
+git -C "$FETCH_REPO" checkout -q -
+git -C "$FETCH_REPO" branch -q -D never-pushed
+
+# ── fetch: net_timeout / net_retries ──────────────────────────────────────────
+printf "\nfetch: net_timeout / net_retries\n"
+NET="$WORK/net"; mkdir -p "$NET"
+git clone -q "$BARE" "$NET/slow"
+git -C "$NET/slow" config remote.origin.uploadpack "sleep 20; git-upload-pack"
+printf 'net_timeout=1\nnative_fetch=false\n' > "$NET/timeout.gitlsrc"
+check "hung remote times out" "timed out after 1s" \
+    env GITLS_CONFIG="$NET/timeout.gitlsrc" "$GITLS" --no-color fetch "$NET/slow"
+# an upload-pack that drops the first connection only
+git clone -q "$BARE" "$NET/flaky"
+printf '#!/bin/sh\n[ -e "%s/dropped" ] && exec git-upload-pack "$@"\ntouch "%s/dropped"\necho "fatal: the remote end hung up unexpectedly" >&2\nexit 128\n' \
+    "$NET" "$NET" > "$NET/flaky-upload-pack"
+chmod +x "$NET/flaky-upload-pack"
+git -C "$NET/flaky" config remote.origin.uploadpack "$NET/flaky-upload-pack"
+check "transient failure retried" "up to date 1" \
+    env GITLS_CONFIG="$WORK/nonative.gitlsrc" "$GITLS" --no-color fetch "$NET/flaky"
+rm -f "$NET/dropped"
+check "no retry past net_timeout" "hung up unexpectedly" \
+    env GITLS_CONFIG="$NET/timeout.gitlsrc" "$GITLS" --no-color fetch "$NET/flaky"
+rm -f "$NET/dropped"
+# a connect timeout is the host breaker's business, not a retry's
+git clone -q "$BARE" "$NET/unreachable"
+printf '#!/bin/sh
+echo x >> "%s/tries"
+echo "ssh: connect to host git.invalid port 22: Connection timed out" >&2
+exit 128
+' \
+    "$NET" > "$NET/timeout-upload-pack"
+chmod +x "$NET/timeout-upload-pack"
+git -C "$NET/unreachable" config remote.origin.uploadpack "$NET/timeout-upload-pack"
+GITLS_CONFIG="$WORK/nonative.gitlsrc" "$GITLS" --no-color fetch "$NET/unreachable" >/dev/null 2>&1
+check_exit "connect timeout not retried" 0 test "$(wc -l < "$NET/tries")" -eq 1
+printf 'net_retries=0\nnative_fetch=false\n' > "$NET/noretry.gitlsrc"
+check "net_retries=0 gives up" "hung up unexpectedly" \
+    env GITLS_CONFIG="$NET/noretry.gitlsrc" "$GITLS" --no-color fetch "$NET/flaky"
+
+# ── fetch: shared_cache ───────────────────────────────────────────────────────
+printf "\nfetch: shared_cache\n"
+# three clones of one "network" upstream (rewritten to a local bare repo); the
+# pack-objects hook logs which repo served each fetch
+SHARED="$WORK/shared"; mkdir -p "$SHARED"
+git init --bare -q "$SHARED/up.git"
+git -C "$FETCH_SETUP" push -q "$SHARED/up.git" HEAD:refs/heads/master
+printf '#!/bin/sh\npwd >> "%s/served"\nexec "$@"\n' "$SHARED" > "$SHARED/hook"
+chmod +x "$SHARED/hook"
+printf '[url "%s/"]\n\tinsteadOf = https://gitls.invalid/\n[uploadpack]\n\tpackObjectsHook = %s/hook\n' \
+    "$SHARED" "$SHARED" > "$SHARED/gitconfig"
+for c in c1 c2 c3; do
+    GIT_CONFIG_GLOBAL="$SHARED/gitconfig" git clone -q https://gitls.invalid/up.git "$SHARED/tree/$c"
+done
+printf 'sixth\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "sixth"
+git -C "$FETCH_SETUP" push -q "$SHARED/up.git" HEAD:refs/heads/master
+rm -f "$SHARED/served"
+printf 'shared_cache=true\n' > "$SHARED/gitlsrc"
+check "all clones fetched" "fetched 3" \
+    env GIT_CONFIG_GLOBAL="$SHARED/gitconfig" GITLS_CONFIG="$SHARED/gitlsrc" \
+    "$GITLS" --no-color fetch "$SHARED/tree"
+check_exit "upstream served once" 0 test "$(grep -c /up.git "$SHARED/served")" -eq 1
+check "clone advanced" "$(git -C "$FETCH_SETUP" rev-parse HEAD)" \
+    git -C "$SHARED/tree/c2" rev-parse origin/master
+# the new mirror got the history from a clone, not from the upstream
+check "new mirror seeded from a clone" "/tree/c" cat "$SHARED/served"
+
+# ── fetch: transfer accounting ────────────────────────────────────────────────
+printf "\nfetch: transfer accounting\n"
+# 64 KiB that does not compress, in over fetch.unpackLimit (100) objects:
+# git only counts bytes for a fetch it keeps as a pack
+mkdir -p "$FETCH_SETUP/many"
+dd if=/dev/urandom of="$FETCH_SETUP/many/blob" bs=1024 count=64 2>/dev/null
+i=0
+while [ $i -lt 120 ]; do echo "$i" > "$FETCH_SETUP/many/$i"; i=$((i + 1)); done
+git -C "$FETCH_SETUP" add many
+git -C "$FETCH_SETUP" commit -q -m "many"
+git -C "$FETCH_SETUP" push -q "$SHARED/up.git" HEAD:refs/heads/master
+git -C "$FETCH_SETUP" push -q "$BARE" HEAD:refs/heads/master
+check "bytes received shown per repo" "KiB in" \
+    env GIT_CONFIG_GLOBAL="$SHARED/gitconfig" GITLS_CONFIG="$WORK/nonative.gitlsrc" \
+    "$GITLS" --no-color fetch "$SHARED/tree/c1"
+check "per-host totals" "gitls.invalid" \
+    env GIT_CONFIG_GLOBAL="$SHARED/gitconfig" GITLS_CONFIG="$WORK/nonative.gitlsrc" \
+    "$GITLS" --no-color fetch "$SHARED/tree/c2"
+check "--net-stats ranks the repos" "Network time:" \
+    env GIT_CONFIG_GLOBAL="$SHARED/gitconfig" GITLS_CONFIG="$WORK/nonative.gitlsrc" \
+    "$GITLS" --no-color --net-stats fetch "$SHARED/tree/c3"
+check "native fetch counts bytes too" "KiB in" \
+    "$GITLS" --no-color fetch "$FETCH_REPO"
+
+# ── fetch: host breaker ───────────────────────────────────────────────────────
+printf "\nfetch: host breaker\n"
+# three clones whose origin is a port nothing listens on
+DOWN="$WORK/down"; mkdir -p "$DOWN"
+for c in d1 d2 d3; do
+    git clone -q "$BARE" "$DOWN/tree/$c"
+    git -C "$DOWN/tree/$c" remote set-url origin https://127.0.0.1:1/dead.git
+done
+printf 'native_fetch=false\nnet_jobs=1\nnet_retries=0\nhost_fail_limit=2\nhost_cooldown=1h\n' \
+    > "$DOWN/gitlsrc"
+check "unreachable host fails" "errors 3" \
+    env GITLS_CONFIG="$DOWN/gitlsrc" "$GITLS" --no-color fetch "$DOWN/tree"
+check "failures kept across runs" "127.0.0.1" cat "$XDG_CACHE_HOME/gitls/hosts"
+check "all skipped on the next run" "host down 3" \
+    env GITLS_CONFIG="$DOWN/gitlsrc" "$GITLS" --no-color fetch "$DOWN/tree"
+check "pull skips them too" "host down 3" \
+    env GITLS_CONFIG="$DOWN/gitlsrc" "$GITLS" --no-color pull "$DOWN/tree"
+# move the last failure back past the cool-down
+backdate() {
+    sed 's/^\([0-9]*\) [0-9]* 127/\1 1 127/' "$XDG_CACHE_HOME/gitls/hosts" > "$DOWN/hosts" &&
+    mv "$DOWN/hosts" "$XDG_CACHE_HOME/gitls/hosts"
+}
+backdate
+check "one repo retries after the cool-down" "errors 1 · host down 2" \
+    env GITLS_CONFIG="$DOWN/gitlsrc" "$GITLS" --no-color fetch "$DOWN/tree"
+# the host comes back: the trial gets through and the rest follow
+backdate
+printf '[url "%s"]\n\tinsteadOf = https://127.0.0.1:1/dead.git\n' "$BARE" > "$DOWN/gitconfig"
+check "a reachable host closes the breaker" "up to date 3" \
+    env GIT_CONFIG_GLOBAL="$DOWN/gitconfig" GITLS_CONFIG="$DOWN/gitlsrc" \
+    "$GITLS" --no-color fetch "$DOWN/tree"
+check_exit "host forgotten once reached" 1 grep -q 127.0.0.1 "$XDG_CACHE_HOME/gitls/hosts"
+# the trial parks on the shared mirror with the other clones, then goes on
+printf '2 1 gitls.invalid\n' >> "$XDG_CACHE_HOME/gitls/hosts"
+printf 'seventh\n' >> "$FETCH_SETUP/README"
+git -C "$FETCH_SETUP" commit -q -am "seventh"
+git -C "$FETCH_SETUP" push -q "$SHARED/up.git" HEAD:refs/heads/master
+printf 'shared_cache=true\nhost_fail_limit=2\nhost_cooldown=1h\n' > "$DOWN/shared.gitlsrc"
+check "trial through the shared cache" "fetched 3" \
+    env GIT_CONFIG_GLOBAL="$SHARED/gitconfig" GITLS_CONFIG="$DOWN/shared.gitlsrc" \
+    timeout -s KILL 30 "$GITLS" --no-color fetch "$SHARED/tree"
+check_exit "trial reported" 1 grep -q gitls.invalid "$XDG_CACHE_HOME/gitls/hosts"
 
 # ── pull: no remote ───────────────────────────────────────────────────────────
 printf "\npull: no remote\n"
@@ -287,6 +504,31 @@ git -C "$PULL_SETUP" add README
 git -C "$PULL_SETUP" commit -q -m "remote commit"
 git -C "$PULL_SETUP" push -q origin HEAD
 check "fast-forward pulled" "pulled" "$GITLS" --no-color pull "$PULL_REPO"
+check "working tree updated" "remote change" cat "$PULL_REPO/README"
+check "branch moved by fast-forward" "pull: Fast-forward" \
+    git -C "$PULL_REPO" reflog -1 --format=%gs
+check "clean after pull" "1 clean" "$GITLS" --no-color "$PULL_REPO"
+# level with upstream (here: only ahead of it) → up to date, no checkout
+printf 'local only\n' > "$PULL_REPO/LOCAL"
+git -C "$PULL_REPO" add LOCAL
+git -C "$PULL_REPO" commit -q -m "local only"
+before=$(git -C "$PULL_REPO" reflog | wc -l)
+check "ahead only is up to date" "up to date 1" "$GITLS" --no-color pull "$PULL_REPO"
+if [ "$(git -C "$PULL_REPO" reflog | wc -l)" -eq "$before" ]; then
+    printf "  ok  up to date leaves HEAD alone\n"; passed=$((passed + 1))
+else
+    printf "FAIL  up to date leaves HEAD alone\n"; failed=$((failed + 1))
+fi
+# pull works without a usable git binary on a file:// remote (native fetch)
+git -C "$PULL_REPO" remote set-url origin "file://$BARE2"
+printf 'more\n' >> "$PULL_SETUP/README"
+git -C "$PULL_SETUP" commit -q -am "more"
+git -C "$PULL_SETUP" push -q origin HEAD
+git -C "$PULL_REPO" reset -q --hard HEAD~1
+check "pulled with no git" "pulled 1" \
+    env PATH="$FAKEBIN:$PATH" "$GITLS" --no-color pull "$PULL_REPO"
+check "no upstream" "no remote 1" sh -c \
+    "git -C '$PULL_REPO' branch -q --unset-upstream && '$GITLS' --no-color pull '$PULL_REPO'"
 
 # ── pull: not fast-forward ────────────────────────────────────────────────────
 printf "\npull: not fast-forward\n"
@@ -454,6 +696,209 @@ else
     failed=$((failed + 1))
 fi
 
+# ── linked worktrees ──────────────────────────────────────────────────────────
+printf "\nlinked worktrees\n"
+BARE_WT="$WORK/worktree-origin.git"
+git init --bare -q "$BARE_WT"
+WT_SETUP="$WORK/worktree-setup"
+git clone -q "$BARE_WT" "$WT_SETUP"
+git -C "$WT_SETUP" config user.email "test@gitls.test"
+git -C "$WT_SETUP" config user.name "Test"
+printf 'init\n' > "$WT_SETUP/README"
+git -C "$WT_SETUP" add README
+git -C "$WT_SETUP" commit -q -m "init"
+git -C "$WT_SETUP" push -q origin HEAD
+WT="$WORK/worktrees"
+git clone -q "$BARE_WT" "$WT/main-clone"
+git -C "$WT/main-clone" worktree add -q "$WT/wt-feature" -b feature 2>/dev/null
+check "linked worktree names its main" "wt-feature ↳main-clone" "$GITLS" --no-color "$WT"
+# a new upstream commit is fetched once for the clone and reported for both rows
+printf 'remote\n' >> "$WT_SETUP/README"
+git -C "$WT_SETUP" add README
+git -C "$WT_SETUP" commit -q -m "remote commit"
+git -C "$WT_SETUP" push -q origin HEAD
+check "worktrees share one fetch" "fetched 2" "$GITLS" --no-color fetch "$WT"
+check "main worktree behind after shared fetch" "↓1" "$GITLS" --no-color "$WT"
+
+# ── config: status_timeout ────────────────────────────────────────────────────
+printf "\nconfig: status_timeout\n"
+TO="$WORK/timeouttest"
+mkgit "$TO/stalled"
+mkgit "$TO/healthy"
+# an index that is a FIFO blocks libgit2's read forever, like a stalled mount
+rm -f "$TO/stalled/.git/index"
+mkfifo "$TO/stalled/.git/index"
+printf 'status_timeout=1\n' > "$CFG"
+out=$(GITLS_CONFIG="$CFG" "$GITLS" --no-color "$TO" 2>&1)
+if printf '%s' "$out" | grep -qF "timed out" && printf '%s' "$out" | grep -qF "healthy" \
+   && printf '%s' "$out" | grep -qF "1 timed out"; then
+    printf "  ok  stalled repo times out, table still printed\n"; passed=$((passed + 1))
+else
+    printf "FAIL  stalled repo times out, table still printed\n     got: %s\n" "$out"
+    failed=$((failed + 1))
+fi
+rm -f "$TO/stalled/.git/index"
+
+# ── config: prefetch_depth / job_order ────────────────────────────────────────
+printf "\nconfig: prefetch_depth / job_order\n"
+PF="$WORK/prefetchtest"
+for n in c a b; do mkgit "$PF/$n"; done
+printf 'x\n' > "$PF/b/dirty.txt"
+base=$("$GITLS" --no-color "$PF" 2>&1)
+printf 'prefetch_depth=0\n' > "$CFG"
+out=$(GITLS_CONFIG="$CFG" "$GITLS" --no-color "$PF" 2>&1)
+if [ "$out" = "$base" ]; then
+    printf "  ok  prefetch_depth=0 gives the same table\n"; passed=$((passed + 1))
+else
+    printf "FAIL  prefetch_depth=0 gives the same table\n     got: %s\n" "$out"
+    failed=$((failed + 1))
+fi
+printf 'job_order=disk\nprefetch_depth=1\n' > "$CFG"
+out=$(GITLS_CONFIG="$CFG" "$GITLS" --no-color "$PF" 2>&1)
+if [ "$out" = "$base" ]; then
+    printf "  ok  job_order=disk keeps scan order in output\n"; passed=$((passed + 1))
+else
+    printf "FAIL  job_order=disk keeps scan order in output\n     got: %s\n" "$out"
+    failed=$((failed + 1))
+fi
+# the default (longest-first) run above recorded every repo's timing
+TF="$XDG_CACHE_HOME/gitls/timings"
+check "timings cache records repos" "/prefetchtest/b" cat "$TF"
+# a history that makes c the slowest must not reorder the table
+awk '/\/prefetchtest\/c$/ { $1 = 9000 } { print }' "$TF" > "$TF.new" && mv "$TF.new" "$TF"
+out=$("$GITLS" --no-color "$PF" 2>&1)
+if [ "$out" = "$base" ]; then
+    printf "  ok  longest-first keeps scan order in output\n"; passed=$((passed + 1))
+else
+    printf "FAIL  longest-first keeps scan order in output\n     got: %s\n" "$out"
+    failed=$((failed + 1))
+fi
+
+# ── -j / --net-jobs ───────────────────────────────────────────────────────────
+printf "\n-j / --net-jobs\n"
+JD="$WORK/jobstest"; mkgit "$JD/one"; mkgit "$JD/two"
+check      "-j 1 lists repos"           "two"                "$GITLS" --no-color -j 1 "$JD"
+check      "-j rejects zero"            "between 1 and"      "$GITLS" -j 0 "$JD"
+check      "--net-jobs needs a value"   "requires a number"  "$GITLS" --net-jobs
+# the value of -j / --net-jobs is not taken for a directory or subcommand
+check      "--net-jobs then fetch"      "no remote"          "$GITLS" --no-color -v --net-jobs 2 fetch "$JD"
+check_exit "--jobs 3 exits 0"           0                    "$GITLS" --jobs 3 "$JD"
+
+# ── fetch cancellation ────────────────────────────────────────────────────────
+printf "\nfetch cancellation\n"
+CX="$WORK/canceltest"
+git init --bare -q "$CX/origin.git"
+mkgit "$CX/seed"
+git -C "$CX/seed" push -q "$CX/origin.git" HEAD:refs/heads/master
+git clone -q "$CX/origin.git" "$CX/tree/slow"
+# an upload-pack that stalls stands in for a hung server
+git -C "$CX/tree/slow" config remote.origin.uploadpack "sleep 5; git-upload-pack"
+"$GITLS" --no-color -v fetch "$CX/tree" > "$CX/out" 2>&1 &
+pid=$!
+sleep 1
+t0=$(date +%s)
+kill -INT "$pid"
+wait "$pid"; rc=$?
+t1=$(date +%s)
+check "SIGINT prints a partial summary" "cancelled 1" cat "$CX/out"
+check "cancelled repo is listed"        "· cancelled" cat "$CX/out"
+check "status table still printed"      "1 repo"      cat "$CX/out"
+if [ "$rc" -eq 130 ] && [ $((t1 - t0)) -lt 4 ]; then
+    printf "  ok  exits 130 without waiting for the child\n"; passed=$((passed + 1))
+else
+    printf "FAIL  exits 130 without waiting for the child  (exit %d, %ds)\n" \
+           "$rc" $((t1 - t0))
+    failed=$((failed + 1))
+fi
+
+# ── exec ──────────────────────────────────────────────────────────────────────
+printf "\nexec\n"
+ED="$WORK/exec"
+mkgit "$ED/a"; mkgit "$ED/b"; mkgit "$ED/c"
+printf 'change\n' >> "$ED/b/README"
+printf 'new\n' > "$ED/c/new.txt"
+check      "runs in every repo"   "in-c"  "$GITLS" exec --no-color "$ED" -- sh -c 'echo in-$(basename "$PWD")'
+check      "arguments kept whole" "a b|c|" "$GITLS" exec --no-color "$ED" -- printf '%s|' 'a b' c
+check      "failures counted"     "ok 2 · failed 1" \
+           "$GITLS" exec --no-color "$ED" -- sh -c 'test ! -e new.txt'
+check      "exit code shown"      "✗ exit 3" "$GITLS" exec --no-color "$ED" -- sh -c 'test -e new.txt || exit 3'
+check_exit "exit 1 if any failed" 1 "$GITLS" exec "$ED" -- sh -c 'test ! -e new.txt'
+check_exit "exit 0 if none did"   0 "$GITLS" exec "$ED" -- true
+check      "--where selects"      "ok 1 · not matched 2" "$GITLS" exec --no-color --where modified "$ED" -- true
+check      "--where list is ANDed" "ok 0 · not matched 3" \
+           "$GITLS" exec --no-color --where=modified,untracked "$ED" -- true
+check      "--where ! negates"    "ok 2 · not matched 1" "$GITLS" exec --no-color --where '!untracked' "$ED" -- true
+# output is printed per repo, never interleaved, even with all three at once
+if "$GITLS" exec --no-color -j 3 "$ED" -- sh -c 'n=$(basename "$PWD"); echo "one $n"; sleep 0.3; echo "two $n"' \
+        | grep -A1 "^    one " | grep -c "^    two " | grep -qx 3; then
+    printf "  ok  output grouped per repo\n"
+    passed=$((passed + 1))
+else
+    printf "FAIL  output grouped per repo\n"
+    failed=$((failed + 1))
+fi
+# more than EXEC_OUT_CAP: the start is kept as written, and the cut noted
+BIG='echo header; i=0; while [ $i -lt 3000 ]; do echo "error $i: something broke"; echo "    at line $i"; i=$((i+1)); done'
+check "long output keeps its start" "header" "$GITLS" exec --no-color --where modified "$ED" -- sh -c "$BIG"
+check "long output cut noted"   "output cut at 64.0 KiB" \
+      "$GITLS" exec --no-color --where modified "$ED" -- sh -c "$BIG"
+check "needs a command"         "requires a command" "$GITLS" exec "$ED"
+check "unknown --where"         "unknown --where condition" "$GITLS" exec --where nope "$ED" -- true
+check "--where only with exec"  "only applies to 'exec'" "$GITLS" --where dirty "$ED"
+check "-- only with exec"       "only run by 'exec'" "$GITLS" "$ED" -- true
+
+# ── --format=ndjson ───────────────────────────────────────────────────────────
+printf "\n--format=ndjson\n"
+ND="$WORK/ndjson"
+mkgit "$ND/a"; mkgit "$ND/b"; mkgit "$ND/c"
+printf 'change\n' >> "$ND/b/README"
+git -C "$ND/c" remote add origin "$ND/missing.git"
+check "one object per repo"     "3" sh -c '"$0" --format=ndjson "$1" | grep -c "^{\"type\":\"repo\""' "$GITLS" "$ND"
+check "summary object last"     '{"type":"summary","repos":3,"dirty":1,' \
+      sh -c '"$0" --format ndjson "$1" | tail -n 1' "$GITLS" "$ND"
+check "status fields"           '"name":"b","branch":"master","staged":0,"modified":1,' \
+      "$GITLS" --format=ndjson "$ND"
+check "--dirty leaves out clean" "1" sh -c '"$0" --format=ndjson --dirty "$1" | grep -c "\"type\":\"repo\""' "$GITLS" "$ND"
+check "fetch error string"      '"fetch":{"result":"error",' "$GITLS" fetch --format=ndjson "$ND"
+check "fetch error message"     '"error":"' "$GITLS" fetch --format=ndjson "$ND"
+check "fetch summary counts"    '"fetch":{"fetched":0,"up_to_date":0,"no_remote":2,"error":1,' \
+      "$GITLS" fetch --format=ndjson "$ND"
+check "exec result object"      '"exec":{"result":"ok","status":0,' "$GITLS" exec --format=ndjson "$ND" -- true
+check "exec output escaped"     '"output":"say \"b\""' \
+      "$GITLS" exec --format=ndjson --where modified "$ND" -- sh -c 'echo "say \"$(basename "$PWD")\""'
+check_exit "exec exit status kept" 1 "$GITLS" exec --format=ndjson "$ND" -- false
+check "exec output cut flagged" '"output_cut":true' \
+      "$GITLS" exec --format=ndjson --where modified "$ND" -- sh -c "$BIG"
+if "$GITLS" fetch --format=ndjson "$ND" 2>/dev/null | grep -v '^{.*}$' | grep -q .; then
+    printf "FAIL  nothing but objects on stdout\n"; failed=$((failed + 1))
+else
+    printf "  ok  nothing but objects on stdout\n"; passed=$((passed + 1))
+fi
+if command -v python3 >/dev/null 2>&1; then
+    printf 'x\377y\n' > "$ND/a/bin.txt"
+    check "every line parses" "ok 4" sh -c '"$0" exec --format=ndjson "$1" -- cat README bin.txt 2>/dev/null \
+        | python3 -c "import json,sys; print(\"ok\", sum(1 for l in sys.stdin if json.loads(l)))"' "$GITLS" "$ND"
+fi
+check "unknown format"          "requires 'table' or 'ndjson'" "$GITLS" --format=csv "$ND"
+check "not with watch"          "cannot be combined with --format=ndjson" "$GITLS" -w --format=ndjson "$ND"
+
+# ── --progressive ─────────────────────────────────────────────────────────────
+printf "\n--progressive\n"
+rows() { "$GITLS" --no-color "$@" | awk '/^  ─/{n++; next} n == 1 {print $1}'; }
+if [ "$(rows --progressive "$ND")" = "$(rows "$ND")" ]; then
+    printf "  ok  same rows, same order as the table\n"; passed=$((passed + 1))
+else
+    printf "FAIL  same rows, same order as the table\n"; failed=$((failed + 1))
+fi
+check "done order has every row" "a b c" echo $(rows --progressive=done "$ND" | sort)
+check "footer after the rows"   "3 repos" sh -c '"$0" --progressive "$1" | tail -n 1' "$GITLS" "$ND"
+check "--dirty leaves out clean" "b" echo $(rows --progressive --dirty "$ND")
+check "summary follows the table" "after" sh -c '"$0" --no-color --progressive fetch "$1" \
+      | awk "/3 repos/{t=NR} /Fetch results/{f=NR} END{print (t && f > t) ? \"after\" : \"before\"}"' "$GITLS" "$ND"
+check "widths kept for next run" "/ndjson" cat "$XDG_CACHE_HOME/gitls/widths"
+check "unknown order"           "takes 'scan' or 'done'" "$GITLS" --progressive=fast "$ND"
+check "not with exec"           "cannot be combined" "$GITLS" exec --progressive "$ND" -- true
+
 # ── watch mode guards ─────────────────────────────────────────────────────────
 printf "\nwatch mode guards\n"
 WD="$WORK/watchguard"; mkgit "$WD/repo"
@@ -3,9 +3,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <unistd.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include <time.h>
 
 #include "../gitools.h"
@@ -19,9 +22,29 @@ bool   opt_switch                = false;
 char   opt_switch_branch[256]    = "";
 bool   opt_fetch                 = false;
 bool   opt_pull                  = false;
+bool   opt_probe                 = false;
 bool   opt_watch                 = false;
 int    opt_watch_interval        = 3;
 bool   opt_dirty_only            = false;
+int    opt_status_timeout        = 0;
+int    opt_prefetch_depth        = 16;
+JobOrder opt_job_order           = ORDER_SCAN;   /* tests must not write the cache */
+int    opt_jobs                  = 0;
+int    opt_net_jobs              = 0;
+int    opt_host_jobs             = 0;
+bool   opt_native_fetch          = true;
+long   opt_max_age               = 0;
+bool   opt_shared_cache          = false;
+bool   opt_narrow                = false;
+long   opt_net_timeout           = 0;
+int    opt_net_retries           = 2;
+int    opt_host_fail_limit       = 3;
+long   opt_host_cooldown         = 600;
+bool   opt_net_stats             = false;
+bool   opt_exec                  = false;
+char **opt_exec_argv             = NULL;
+OutputFormat opt_format          = FMT_TABLE;
+Progressive opt_progressive      = PROG_OFF;
 char   opt_default_dir[PATH_MAX] = "";
 char **opt_extra_skip            = NULL;
 size_t opt_extra_skip_count      = 0;
@@ -48,7 +71,16 @@ static void test_utf8_width(void) {
     CHECK("equal ≡ (3-byte)",        utf8_width("\xe2\x89\xa1") == 1);
     CHECK("↑3 (symbol + digit)",     utf8_width("\xe2\x86\x91" "3") == 2);
     CHECK("↑3↓2 (diverged)",         utf8_width("\xe2\x86\x91" "3" "\xe2\x86\x93" "2") == 4);
-    CHECK("4-byte char",             utf8_width("\xf0\x9f\x98\x80") == 1);
+    CHECK("4-byte char",             utf8_width("\xf0\x90\x8d\x88") == 1);   /* Gothic hwair */
+    CHECK("emoji is wide",           utf8_width("\xf0\x9f\x98\x80") == 2);
+    CHECK("CJK is wide",             utf8_width("\xe6\x97\xa5\xe6\x9c\xac") == 4);      /* 日本 */
+    CHECK("Hangul and kana wide",    utf8_width("\xed\x95\x9c\xe3\x81\x8b") == 4);      /* 한か */
+    CHECK("fullwidth A is wide",     utf8_width("\xef\xbc\xa1") == 2);
+    CHECK("halfwidth kana is not",   utf8_width("\xef\xbd\xb1") == 1);
+    CHECK("combining mark is 0",     utf8_width("e\xcc\x81") == 1);                     /* é, decomposed */
+    CHECK("zero-width joiner is 0",  utf8_width("a\xe2\x80\x8d" "b") == 2);
+    CHECK("invalid byte is 1",       utf8_width("a\xff" "b") == 3);
+    CHECK("stray continuation is 1", utf8_width("\x80" "ab") == 3);
     CHECK("mixed ascii+utf8",        utf8_width("ok\xe2\x86\x91") == 3);
     /* truncated / incomplete sequences must not read past the null terminator */
     CHECK("truncated 3-byte seq",    utf8_width("\xe2\x86") == 0);
@@ -56,38 +88,444 @@ static void test_utf8_width(void) {
     CHECK("ascii before truncated",  utf8_width("ab\xe2\x86") == 2);
 }
 
+/* ── width kernels ──────────────────────────────────────────────────────────── */
+static void test_width_kernels(void) {
+    printf("\nwidth kernels\n");
+    int w;
+    CHECK("prefix stops before wide", utf8_byte_len_for_width("ab\xe6\x97\xa5" "c", 3, &w) == 2 && w == 2);
+    CHECK("prefix takes its marks",  utf8_byte_len_for_width("ae\xcc\x81" "b", 2, &w) == 4 && w == 2);
+    CHECK("skip a wide char",        utf8_skip_width("\xe6\x97\xa5" "ab", 1) == 3);
+    CHECK("skip takes its marks",    utf8_skip_width("e\xcc\x81" "b", 1) == 3);
+
+    /* lengths on both sides of every block size, non-ASCII at every offset */
+    static char buf[160];
+    bool same = true;
+    const WidthKernel kernels[] = { WIDTH_SWAR, WIDTH_SSE2, WIDTH_AVX2 };
+    int tried = 0;
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(*kernels); k++) {
+        if (!width_kernel_set(kernels[k])) continue;
+        tried++;
+        for (size_t len = 0; len < 100 && same; len++) {
+            for (size_t at = 0; at <= len && same; at++) {
+                memset(buf, 'x', len);
+                buf[len] = '\0';
+                int want = (int)len;
+                if (at + 3 <= len) {
+                    memcpy(buf + at, "\xe6\x97\xa5", 3);     /* 3 bytes, 2 columns */
+                    want = (int)len - 1;
+                }
+                if (utf8_width(buf) != want
+                        || utf8_byte_len_for_width(buf, want / 2, NULL) > len) same = false;
+            }
+        }
+    }
+    width_kernel_set(WIDTH_AUTO);
+    CHECK("every kernel agrees",     tried >= 1 && same);
+}
+
 /* ── relative_time ──────────────────────────────────────────────────────────── */
 static void test_relative_time(void) {
     printf("\nrelative_time\n");
     time_t now = time(NULL);
-    CHECK("zero = no commits",  strcmp(relative_time(0),              "no commits") == 0);
-    CHECK("30s = just now",     strcmp(relative_time(now - 30),       "just now")   == 0);
-    CHECK("5 min ago",          strcmp(relative_time(now - 300),      "5 min ago")  == 0);
-    CHECK("1 hour ago",         strcmp(relative_time(now - 3600),     "1 hour ago") == 0);
-    CHECK("3 hours ago",        strcmp(relative_time(now - 10800),    "3 hours ago") == 0);
-    CHECK("1 day ago",          strcmp(relative_time(now - 86400),    "1 day ago")  == 0);
-    CHECK("3 days ago",         strcmp(relative_time(now - 259200),   "3 days ago") == 0);
-    CHECK("1 month ago",        strcmp(relative_time(now - 2592000),  "1 mo ago")   == 0);
-    CHECK("2 months ago",       strcmp(relative_time(now - 5184000),  "2 mos ago")  == 0);
-    CHECK("1 year ago",         strcmp(relative_time(now - 31536000), "1 yr ago")   == 0);
+    char b[32];
+    CHECK("zero = no commits",  strcmp(relative_time(0,              b, sizeof(b)), "no commits") == 0);
+    CHECK("30s = just now",     strcmp(relative_time(now - 30,       b, sizeof(b)), "just now")   == 0);
+    CHECK("5 min ago",          strcmp(relative_time(now - 300,      b, sizeof(b)), "5 min ago")  == 0);
+    CHECK("1 hour ago",         strcmp(relative_time(now - 3600,     b, sizeof(b)), "1 hour ago") == 0);
+    CHECK("3 hours ago",        strcmp(relative_time(now - 10800,    b, sizeof(b)), "3 hours ago") == 0);
+    CHECK("1 day ago",          strcmp(relative_time(now - 86400,    b, sizeof(b)), "1 day ago")  == 0);
+    CHECK("3 days ago",         strcmp(relative_time(now - 259200,   b, sizeof(b)), "3 days ago") == 0);
+    CHECK("1 month ago",        strcmp(relative_time(now - 2592000,  b, sizeof(b)), "1 mo ago")   == 0);
+    CHECK("2 months ago",       strcmp(relative_time(now - 5184000,  b, sizeof(b)), "2 mos ago")  == 0);
+    CHECK("1 year ago",         strcmp(relative_time(now - 31536000, b, sizeof(b)), "1 yr ago")   == 0);
+    char b2[32];
+    relative_time(now - 300, b2, sizeof(b2));
+    CHECK("caller's buffer, not shared", strcmp(relative_time(0, b, sizeof(b)), "no commits") == 0
+                                         && strcmp(b2, "5 min ago") == 0);
 }
 
 /* ── ellipsize ──────────────────────────────────────────────────────────────── */
 static void test_ellipsize(void) {
     printf("\nellipsize\n");
-    CHECK("short string unchanged",  strcmp(ellipsize("abc", 10),  "abc")   == 0);
-    CHECK("exact fit unchanged",     strcmp(ellipsize("abcde", 5), "abcde") == 0);
+    char b[64];
+    CHECK("short string unchanged",  strcmp(ellipsize("abc", 10, b, sizeof(b)),  "abc")   == 0);
+    CHECK("exact fit unchanged",     strcmp(ellipsize("abcde", 5, b, sizeof(b)), "abcde") == 0);
     /* drops the front, keeps the tail, prefixes a 1-column ellipsis */
-    CHECK("long string truncated",   strcmp(ellipsize("abcdefghij", 5), "\xe2\x80\xa6ghij") == 0);
-    CHECK("truncated width fits",    utf8_width(ellipsize("abcdefghij", 5)) == 5);
-    CHECK("max_w < 2 returns full",  strcmp(ellipsize("abcdef", 1), "abcdef") == 0);
+    CHECK("long string truncated",   strcmp(ellipsize("abcdefghij", 5, b, sizeof(b)), "\xe2\x80\xa6ghij") == 0);
+    CHECK("truncated width fits",    utf8_width(ellipsize("abcdefghij", 5, b, sizeof(b))) == 5);
+    CHECK("max_w < 2 returns full",  strcmp(ellipsize("abcdef", 1, b, sizeof(b)), "abcdef") == 0);
+    CHECK("CJK cut by columns",      strcmp(ellipsize("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", 5, b, sizeof(b)),
+                                            "\xe2\x80\xa6\xe6\x9c\xac\xe8\xaa\x9e") == 0);
+}
+
+/* ── frame ──────────────────────────────────────────────────────────────────── */
+static void test_frame(void) {
+    printf("\nframe\n");
+    Frame f;
+    frame_init(&f, 0);
+    frame_puts(&f, "ab");
+    frame_printf(&f, "%d|", 42);
+    frame_pad(&f, 3);
+    frame_pad(&f, -1);
+    CHECK("appends in order",        f.len == 8 && memcmp(f.buf, "ab42|   ", 8) == 0);
+    static char big[200000];
+    memset(big, 'x', sizeof(big) - 1);
+    frame_printf(&f, "%s!", big);
+    CHECK("grows past its start",    f.len == 8 + sizeof(big) && f.buf[f.len - 1] == '!');
+
+    Frame g;
+    frame_init(&g, 0);
+    frame_puts(&g, "tail");
+    frame_append(&f, &g);
+    CHECK("append joins frames",     f.len == 12 + sizeof(big) && memcmp(f.buf + f.len - 4, "tail", 4) == 0);
+    frame_free(&g);
+
+    ColWidths w = { .name = 6, .branch = 6, .sync = 4, .time = 12 };
+    Repo r = { .path = "/r/api", .branch = "main", .has_remote = 1, .modified = 2 };
+    bool color = opt_no_color;
+    opt_no_color = true;
+    f.len = 0;
+    print_repo(&f, &r, &w);
+    opt_no_color = color;
+    CHECK("row rendered to frame",   f.len > 0 && strstr(f.buf, "  api     main    \xe2\x89\xa1") == f.buf
+                                     && f.buf[f.len - 1] == '\n');
+    /* wide branch names are padded and cut by columns, not code points */
+    opt_no_color = true;
+    f.len = 0;
+    r.branch = "\xe6\x97\xa5\xe6\x9c\xac";                             /* 日本, 4 columns */
+    print_repo(&f, &r, &w);
+    CHECK("wide branch padded",      strstr(f.buf, "  api     \xe6\x97\xa5\xe6\x9c\xac    \xe2\x89\xa1") == f.buf);
+    f.len = 0;
+    r.branch = "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e" "ab";           /* 日本語ab, 8 columns */
+    print_repo(&f, &r, &w);
+    opt_no_color = color;
+    CHECK("wide branch cut to fit",  strstr(f.buf, "  api     \xe6\x97\xa5\xe6\x9c\xac~   \xe2\x89\xa1") == f.buf);
+    frame_free(&f);
+}
+
+/* ── timings cache ──────────────────────────────────────────────────────────── */
+static void test_timings(void) {
+    printf("\ntimings\n");
+    char dir[] = "/tmp/gitls-unit-XXXXXX";
+    if (!mkdtemp(dir)) { CHECK("mkdtemp", false); return; }
+    setenv("XDG_CACHE_HOME", dir, 1);
+
+    CHECK("unknown repo is -1",       timings_get("/r/a", TIMING_LOCAL) == -1);
+    timings_put("/r/a", TIMING_LOCAL, 100);
+    timings_put("/r/a", TIMING_LOCAL, 300);
+    timings_put("/r/b", TIMING_NET,   40);
+    CHECK("moving average",           timings_get("/r/a", TIMING_LOCAL) == 200);
+    CHECK("phases kept apart",        timings_get("/r/a", TIMING_NET) == -1);
+    timings_save();
+    timings_free();
+    CHECK("reloaded after save",      timings_get("/r/a", TIMING_LOCAL) == 200
+                                      && timings_get("/r/b", TIMING_NET) == 40);
+    timings_free();
+
+    ColWidths w = { 0 };
+    CHECK("no widths yet",            !widths_get("/r", &w));
+    widths_put("/r",   &(ColWidths){ .branch = 12, .sync = 5, .time = 10 });
+    widths_put("/r/x", &(ColWidths){ .branch = 7,  .sync = 4, .time = 12 });
+    widths_put("/r",   &(ColWidths){ .branch = 9,  .sync = 4, .time = 11 });
+    CHECK("widths per directory",     widths_get("/r", &w) && w.branch == 9 && w.time == 11
+                                      && widths_get("/r/x", &w) && w.branch == 7);
+
+    char file[PATH_MAX];
+    snprintf(file, sizeof(file), "%s/gitls/widths", dir);
+    remove(file);
+    snprintf(file, sizeof(file), "%s/gitls/timings", dir);
+    remove(file);
+    snprintf(file, sizeof(file), "%s/gitls", dir);
+    rmdir(file);
+    rmdir(dir);
+    unsetenv("XDG_CACHE_HOME");
+}
+
+/* ── pool ───────────────────────────────────────────────────────────────────── */
+static _Atomic int pool_hits;
+static TaskGroup  *pool_group;
+
+/* each task submits two children until depth 0: 2^(d+1) - 1 tasks in all */
+static void pool_tree_task(void *arg) {
+    intptr_t d = (intptr_t)arg;
+    atomic_fetch_add(&pool_hits, 1);
+    if (d > 0) {
+        pool_submit(pool_group, pool_tree_task, (void *)(d - 1));
+        pool_submit(pool_group, pool_tree_task, (void *)(d - 1));
+    }
+}
+
+static void test_pool(void) {
+    printf("\npool\n");
+    TaskGroup g = { 0 };
+    pool_group = &g;
+
+    atomic_store(&pool_hits, 0);
+    pool_submit(&g, pool_tree_task, (void *)(intptr_t)9);
+    CHECK("inline mode runs nested tasks", atomic_load(&pool_hits) == 1023);
+
+    pool_start(4);
+    CHECK("pool started",                  pool_size() == 4);
+    atomic_store(&pool_hits, 0);
+    for (int k = 0; k < 8; k++)
+        pool_submit(&g, pool_tree_task, (void *)(intptr_t)9);
+    pool_wait(&g);
+    CHECK("nested tasks all ran",          atomic_load(&pool_hits) == 8 * 1023);
+    CHECK("group drained",                 atomic_load(&g.pending) == 0);
+    pool_compensate();
+    CHECK("compensate widens",             pool_size() == 4);
+    pool_release();
+    pool_stop();
+    CHECK("stopped pool runs inline",      pool_size() == 0);
+}
+
+static void test_remote_host(void) {
+    printf("\nremote_host\n");
+    char h[64];
+    CHECK("https with user and port",
+          remote_host("https://me@Git.Example.com:8443/x.git", h, sizeof(h))
+          && strcmp(h, "git.example.com") == 0);
+    CHECK("scp-like",
+          remote_host("git@github.com:org/repo.git", h, sizeof(h))
+          && strcmp(h, "github.com") == 0);
+    CHECK("ssh ipv6",
+          remote_host("ssh://[::1]:22/srv/r.git", h, sizeof(h)) && strcmp(h, "::1") == 0);
+    CHECK("file url is local",     !remote_host("file:///srv/r.git", h, sizeof(h)) && !h[0]);
+    CHECK("path is local",         !remote_host("/srv/r.git", h, sizeof(h)));
+    CHECK("relative colon path",   !remote_host("./a:b", h, sizeof(h)));
+}
+
+static void test_parse_duration(void) {
+    printf("\nparse_duration\n");
+    long s = -1;
+    CHECK("bare seconds",   parse_duration("90", &s) && s == 90);
+    CHECK("minutes",        parse_duration("10m", &s) && s == 600);
+    CHECK("days",           parse_duration("1d", &s) && s == 86400);
+    CHECK("zero disables",  parse_duration("0s", &s) && s == 0);
+    s = 7;
+    CHECK("bad unit",       !parse_duration("5w", &s) && s == 7);
+    CHECK("trailing junk",  !parse_duration("5mm", &s));
+    CHECK("negative",       !parse_duration("-1", &s));
+    CHECK("empty",          !parse_duration("", &s));
+}
+
+/* Children that report in the order they finish. */
+static char net_seen[8];
+static int  net_nseen;
+
+static void net_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)cut; (void)ms;
+    if (status == 0 && strcmp(out, (const char *)ctx) == 0)
+        net_seen[net_nseen++] = out[0];
+}
+
+static int net_status;
+
+static void net_status_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)ctx; (void)out; (void)cut; (void)ms;
+    net_status = status;
+}
+
+static char net_out[FETCH_OUT_CAP];
+static bool net_cut;
+
+static void net_out_done(void *ctx, int status, const char *out, bool cut, long ms) {
+    (void)ctx; (void)ms;
+    net_status = status;
+    net_cut    = cut;
+    snprintf(net_out, sizeof(net_out), "%s", out);
+}
+
+static void test_netexec(void) {
+    printf("\nnetexec\n");
+    NetExec *ex = netexec_new("/bin/sh", 4, 1);
+    CHECK("executor created", ex != NULL);
+    if (!ex) return;
+    const char *slow[] = { "sh", "-c", "sleep 0.1; echo a", NULL };
+    const char *fast[] = { "sh", "-c", "echo b", NULL };
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    net_nseen = 0;
+    for (int k = 0; k < 3; k++)
+        netexec_spawn(ex, "a.example", slow, 64, false, net_done, (void *)"a");
+    netexec_spawn(ex, "b.example", fast, 64, false, net_done, (void *)"b");
+    netexec_run(ex);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    long ms = (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000;
+    netexec_free(ex);
+    CHECK("all children reported",       net_nseen == 4);
+    CHECK("other host not queued behind", net_seen[0] == 'b');
+    CHECK("host cap serialises",         ms >= 300);
+
+    /* progress counters: only the last state of a '\r'-rewritten line stays */
+    ex = netexec_new("/bin/sh", 1, 0);
+    if (!ex) return;
+    const char *progress[] = { "sh", "-c",
+        "printf 'R: 10%% (1/9)\\rR: 100%% (9/9), done.\\r\\nok\\n'", NULL };
+    net_nseen = 0;
+    netexec_spawn(ex, "", progress, 64, true, net_done, (void *)"R: 100% (9/9), done.\nok");
+    netexec_run(ex);
+    netexec_free(ex);
+    CHECK("carriage return rewinds the line", net_nseen == 1);
+
+    /* more ref lines than fit: the failure at the end is what is kept */
+    ex = netexec_new("/bin/sh", 1, 0);
+    if (!ex) return;
+    const char *refs[] = { "sh", "-c",
+        "echo 'Receiving objects: 100% (3/3), 1.00 KiB | 1.00 MiB/s, done.';"
+        "i=0; while [ $i -lt 200 ]; do"
+        " echo \" * [new branch]      feature/$i -> origin/feature/$i\"; i=$((i+1)); done;"
+        "echo 'fatal: the remote end hung up unexpectedly' >&2; exit 128", NULL };
+    net_out[0] = '\0';
+    netexec_spawn(ex, "", refs, FETCH_OUT_CAP, true, net_out_done, NULL);
+    netexec_run(ex);
+    netexec_free(ex);
+    CHECK("tail kept past the cap",   net_cut && strstr(net_out, "hung up unexpectedly"));
+    CHECK("ref lines dropped first",  strstr(net_out, "Receiving objects") == net_out
+                                      && strstr(net_out, "feature/199") != NULL
+                                      && strstr(net_out, "feature/0 ") == NULL);
+
+    /* anything else is kept as written, the start of it */
+    ex = netexec_new("/bin/sh", 1, 0);
+    if (!ex) return;
+    const char *plain[] = { "sh", "-c",
+        "printf 'head\\r\\n'; i=0; while [ $i -lt 300 ]; do"
+        " echo \"error $i\"; echo '  context'; i=$((i+1)); done", NULL };
+    net_out[0] = '\0';
+    netexec_spawn(ex, "", plain, 256, false, net_out_done, NULL);
+    netexec_run(ex);
+    netexec_free(ex);
+    CHECK("plain output cut at the cap", net_cut && strlen(net_out) == 255);
+    CHECK("... keeping its start",       strncmp(net_out, "head\r\nerror 0\n  context\n", 24) == 0);
+
+    ex = netexec_new("/bin/sh", 1, 0);
+    if (!ex) return;
+    const char *small[] = { "sh", "-c", "echo fits", NULL };
+    netexec_spawn(ex, "", small, 256, false, net_out_done, NULL);
+    netexec_run(ex);
+    netexec_free(ex);
+    CHECK("not cut when it fits",        !net_cut && strcmp(net_out, "fits") == 0);
+
+    /* a child given less than the executor's timeout is stopped at that */
+    ex = netexec_new("/bin/sh", 1, 0);
+    if (!ex) return;
+    netexec_set_timeout(ex, 10000);
+    const char *hang[] = { "sh", "-c", "sleep 5", NULL };
+    net_status = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    netexec_spawn_within(ex, "", hang, 64, false, 200, net_status_done, NULL);
+    netexec_run(ex);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ms = (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000;
+    netexec_free(ex);
+    CHECK("own limit times the child out", net_status == NETEXEC_TIMEDOUT && ms < 3000);
+}
+
+static void test_git_transfer_stats(void) {
+    printf("\ngit_transfer_stats\n");
+    uint64_t bytes = 0;
+    size_t objects = 0;
+    CHECK("kept pack",
+          git_transfer_stats("remote: Total 126 (delta 0), reused 123 (delta 0)\n"
+                             "Receiving objects: 100% (126/126), 3.06 MiB | 9.00 MiB/s, done.\n"
+                             "From /srv/b\n", &bytes, &objects)
+          && objects == 126 && bytes == (uint64_t)(3.06 * 1048576));
+    bytes = objects = 0;
+    CHECK("cut short",
+          git_transfer_stats("Receiving objects:  45% (57/126), 512 bytes | 1 KiB/s\n"
+                             "fatal: early EOF", &bytes, &objects)
+          && objects == 57 && bytes == 512);
+    bytes = objects = 0;
+    CHECK("unpacked: objects only",
+          git_transfer_stats("remote: Total 3 (delta 1), reused 0 (delta 0)\n", &bytes, &objects)
+          && objects == 3 && bytes == 0);
+    CHECK("nothing to go on", !git_transfer_stats("fatal: repository not found", &bytes, &objects));
+}
+
+static void test_exec_where(void) {
+    printf("\nexec_where\n");
+    Repo clean = { .path = "/r/a", .branch = "main", .has_remote = 1 };
+    Repo dirty = { .path = "/r/b", .branch = "dev", .modified = 2, .behind = 1 };
+    CHECK("no condition: every repo", exec_where_match(&clean) && exec_where_match(&dirty));
+    CHECK("unknown condition", !exec_where_add("dirt"));
+    exec_where_free();
+    CHECK("modified", exec_where_add("modified")
+          && !exec_where_match(&clean) && exec_where_match(&dirty));
+    exec_where_free();
+    CHECK("list is ANDed", exec_where_add("behind,branch=dev")
+          && exec_where_match(&dirty) && !exec_where_match(&clean));
+    CHECK("repeated --where ANDs too", exec_where_add("upstream") && !exec_where_match(&dirty));
+    exec_where_free();
+    CHECK("! negates", exec_where_add("!dirty")
+          && exec_where_match(&clean) && !exec_where_match(&dirty));
+    exec_where_free();
+}
+
+static void test_utf8_seq(void) {
+    printf("\nutf8_seq\n");
+    CHECK("ascii",              utf8_seq((const unsigned char *)"a") == 1);
+    CHECK("two bytes",          utf8_seq((const unsigned char *)"\xc3\xa9") == 2);
+    CHECK("three bytes",        utf8_seq((const unsigned char *)"\xe6\x9c\x8d") == 3);
+    CHECK("four bytes",         utf8_seq((const unsigned char *)"\xf0\x9f\x98\x80") == 4);
+    CHECK("U+10FFFF",           utf8_seq((const unsigned char *)"\xf4\x8f\xbf\xbf") == 4);
+    CHECK("surrogate",          utf8_seq((const unsigned char *)"\xed\xa0\x80") == 0);
+    CHECK("overlong 3 bytes",   utf8_seq((const unsigned char *)"\xe0\x80\xaf") == 0);
+    CHECK("overlong 4 bytes",   utf8_seq((const unsigned char *)"\xf0\x8f\xbf\xbf") == 0);
+    CHECK("past U+10FFFF",      utf8_seq((const unsigned char *)"\xf4\x90\x80\x80") == 0);
+    CHECK("cut short",          utf8_seq((const unsigned char *)"\xe6\x9c") == 0);
+}
+
+static void test_arena(void) {
+    printf("\narena\n");
+    StrArena *a = arena_new();
+    char buf[] = "main";
+    const char *m = arena_intern(a, buf);
+    buf[0] = 'p';
+    CHECK("intern copies",               strcmp(m, "main") == 0);
+    CHECK("intern dedups",               arena_intern(a, "main") == m);
+    CHECK("distinct strings differ",     arena_intern(a, "master") != m);
+    char *p = arena_strdup(a, "/r/a");
+    CHECK("strdup copies",               strcmp(p, "/r/a") == 0 && arena_strdup(a, "/r/a") != p);
+
+    char name[32];
+    for (int i = 0; i < 1000; i++) {    /* past the table's first sizes */
+        snprintf(name, sizeof(name), "feature/%d", i);
+        arena_intern(a, name);
+    }
+    CHECK("still dedups after growth",   arena_intern(a, "main") == m
+                                         && strcmp(arena_intern(a, "feature/999"), "feature/999") == 0);
+    static char big[100000];            /* more than a chunk */
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    CHECK("oversized string",            strcmp(arena_strdup(a, big), big) == 0
+                                         && strcmp(arena_strdup(a, "after"), "after") == 0);
+
+    size_t held = arena_footprint(a);
+    arena_reset(a);
+    size_t kept = arena_footprint(a);
+    CHECK("reset frees oversized only",  kept < held - sizeof(big) && kept > sizeof(big) / 2);
+    const char *m2 = arena_intern(a, "main");
+    CHECK("reset forgets strings",       strcmp(m2, "main") == 0 && arena_intern(a, "main") == m2);
+    CHECK("reset reuses memory",         arena_footprint(a) == kept);
+    arena_free(a);
 }
 
 /* ── main ───────────────────────────────────────────────────────────────────── */
 int main(void) {
     test_utf8_width();
+    test_width_kernels();
     test_relative_time();
     test_ellipsize();
+    test_frame();
+    test_timings();
+    test_pool();
+    test_remote_host();
+    test_parse_duration();
+    test_netexec();
+    test_git_transfer_stats();
+    test_exec_where();
+    test_utf8_seq();
+    test_arena();
 
     printf("\n%d passed, %d failed\n", passed, failed);
     return failed ? 1 : 0;
@@ -219,6 +219,9 @@ def main():
         return 1
 
     work = tempfile.mkdtemp(prefix="gitls-pty-")
+    # keep the timings cache out of the real ~/.cache
+    cache = tempfile.mkdtemp(prefix="gitls-pty-cache-")
+    os.environ["XDG_CACHE_HOME"] = cache
     a = os.path.join(work, "a")
     b = os.path.join(work, "b")
     make_repo(a)
@@ -305,7 +308,29 @@ def main():
     check("exactly one header row after switch", len(headers) == 1)
     subprocess.run(["rm", "-rf", wide])
 
-    subprocess.run(["rm", "-rf", work])
+    # ── 6. 'c' cancels an in-flight fetch, watch mode stays up ──
+    slow = tempfile.mkdtemp(prefix="gitls-pty-slow-")
+    origin = os.path.join(slow, "origin.git")
+    git("init", "-q", "--bare", origin)
+    git("push", "-q", origin, "main", cwd=a)
+    repo = os.path.join(slow, "tree", "r")
+    git("clone", "-q", origin, repo)
+    # an upload-pack that stalls stands in for a hung server
+    git("config", "remote.origin.uploadpack", "sleep 5; git-upload-pack", cwd=repo)
+    w = Watcher(os.path.join(slow, "tree"))
+    w.drain(1.2)
+    w.send(b"f")
+    spin = w.drain(1.0)
+    check("fetch spinner offers cancel", "c cancel" in spin)
+    t0 = time.time()
+    w.send(b"c")
+    after = w.drain(1.5)
+    check("cancel key ends the fetch early", "fetch cancelled" in after and time.time() - t0 < 3)
+    tail, status = w.finish()
+    check("still quits cleanly after cancel", os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0)
+    subprocess.run(["rm", "-rf", slow])
+
+    subprocess.run(["rm", "-rf", work, cache])
     print(f"\n{passed} passed, {failed} failed")
     return 1 if failed else 0
 
@@ -7,6 +7,10 @@
  * The original terminal state is always restored on exit — including on
  * SIGINT / SIGTERM — via a signal handler that asks the loop to stop and an
  * atexit() fallback.
+ *
+ * While an f / p action runs, a small thread watches stdin so 'c' or Esc can
+ * cancel it (netexec_cancel) and leave the table as far as it got; 'q' and
+ * the stop signals cancel it too, then quit.
  */
 
 #include <stdio.h>
@@ -16,6 +20,8 @@
 #include <errno.h>
 #include <time.h>
 #include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <unistd.h>
 #include <termios.h>
 
@@ -34,6 +40,9 @@ static struct termios       g_orig_termios;
 static int                  g_termios_saved = 0;
 static volatile sig_atomic_t g_watch_stop   = 0;
 
+/* every screen update is rendered here and written at once; kept across ticks */
+static Frame                g_frame;
+
 static void write_seq(const char *s) {
     /* write() is async-signal-safe, so this is callable from restore_terminal */
     ssize_t r = write(STDOUT_FILENO, s, strlen(s));
@@ -53,6 +62,7 @@ static void restore_terminal(void) {
 static void on_signal(int sig) {
     (void)sig;
     g_watch_stop = 1;
+    netexec_cancel();        /* an in-flight fetch/pull ends early */
 }
 
 /* Put stdin into cbreak/raw mode: no canonical line buffering, no echo. */
@@ -114,6 +124,23 @@ static WatchEvent wait_for_event(int interval_sec, char *key_out) {
     }
 }
 
+/* ── Cancel key during fetch / pull ─────────────────────────────────────────── */
+static _Atomic bool g_keys_done = false;
+
+static void *cancel_key_thread(void *arg) {
+    (void)arg;
+    while (!atomic_load(&g_keys_done)) {
+        struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, 100) <= 0 || !(pfd.revents & POLLIN)) continue;
+        char c;
+        if (read(STDIN_FILENO, &c, 1) <= 0) continue;
+        if (c == 'q' || c == 'Q') g_watch_stop = 1;
+        if (c == 'c' || c == 'C' || c == 27 /* Esc */ || c == 3 || c == 'q' || c == 'Q')
+            netexec_cancel();
+    }
+    return NULL;
+}
+
 /* ── Branch picker ─────────────────────────────────────────────────────────── */
 #define PICK_VISIBLE 8     /* max branch rows shown at once */
 
@@ -162,29 +189,29 @@ static bool ci_contains(const char *hay, const char *needle) {
 
 /* Draw the picker block at the current cursor position; return the number of
  * lines printed so the caller can move the cursor back to the anchor. */
-static int draw_picker(const char *buf, const char **filt, size_t nfilt,
+static int draw_picker(Frame *f, const char *buf, const char **filt, size_t nfilt,
                        size_t sel, size_t off) {
     int lines = 0;
-    printf("\n");                                                          lines++;
-    printf("  %sswitch all clean repos to:%s %s%s%s\xe2\x96\x8f\n",
-           C(COL_BOLD), C(COL_RESET), C(COL_CYAN), buf, C(COL_RESET));     lines++;
-    printf("  %s\xe2\x86\x91/\xe2\x86\x93 navigate \xc2\xb7 Tab/Enter select \xc2\xb7 "
-           "Esc cancel%s\n", C(COL_DIM), C(COL_RESET));                    lines++;
+    frame_puts(f, "\n");                                                            lines++;
+    frame_printf(f, "  %sswitch all clean repos to:%s %s%s%s\xe2\x96\x8f\n",
+                    C(COL_BOLD), C(COL_RESET), C(COL_CYAN), buf, C(COL_RESET));     lines++;
+    frame_printf(f, "  %s\xe2\x86\x91/\xe2\x86\x93 navigate \xc2\xb7 Tab/Enter select \xc2\xb7 "
+                    "Esc cancel%s\n", C(COL_DIM), C(COL_RESET));                    lines++;
 
     if (nfilt == 0) {
-        printf("  %s(no matching branches \xe2\x80\x94 type a name, Enter to use it)%s\n",
-               C(COL_DIM), C(COL_RESET));                                  lines++;
+        frame_printf(f, "  %s(no matching branches \xe2\x80\x94 type a name, Enter to use it)%s\n",
+                        C(COL_DIM), C(COL_RESET));                                  lines++;
     } else {
         for (size_t i = off; i < nfilt && i < off + PICK_VISIBLE; i++) {
             if (i == sel)
-                printf("  %s\xe2\x9d\xb1 %s%s\n", C(COL_GREEN), filt[i], C(COL_RESET));
+                frame_printf(f, "  %s\xe2\x9d\xb1 %s%s\n", C(COL_GREEN), filt[i], C(COL_RESET));
             else
-                printf("    %s%s%s\n", C(COL_DIM), filt[i], C(COL_RESET));
+                frame_printf(f, "    %s%s%s\n", C(COL_DIM), filt[i], C(COL_RESET));
             lines++;
         }
         if (nfilt > off + PICK_VISIBLE) {
-            printf("  %s(%zu more)%s\n",
-                   C(COL_DIM), nfilt - (off + PICK_VISIBLE), C(COL_RESET));
+            frame_printf(f, "  %s(%zu more)%s\n",
+                            C(COL_DIM), nfilt - (off + PICK_VISIBLE), C(COL_RESET));
             lines++;
         }
     }
@@ -216,11 +243,11 @@ static bool read_branch(char *out, size_t n) {
 
         /* redraw in place at the anchor (the line below the footer): clear the
          * picker region, draw it, then move the cursor back up to the anchor */
-        printf("\r" CLEAR_TO_END);
-        int lines = draw_picker(buf, filt, nfilt, sel, off);
-        if (lines > 0) printf("\033[%dA", lines);
-        printf("\r");
-        fflush(stdout);
+        frame_puts(&g_frame, "\r" CLEAR_TO_END);
+        int lines = draw_picker(&g_frame, buf, filt, nfilt, sel, off);
+        if (lines > 0) frame_printf(&g_frame, "\033[%dA", lines);
+        frame_puts(&g_frame, "\r");
+        frame_flush(&g_frame);
 
         if (g_watch_stop) return false;
 
@@ -264,18 +291,19 @@ static bool read_branch(char *out, size_t n) {
 }
 
 /* ── Footer ─────────────────────────────────────────────────────────────────── */
-static void print_footer(const char *abs_dir, int interval_sec, const char *note) {
-    printf("%s\n", EOL());   /* blank separator line (cleared) */
-    printf("  %sf%s fetch · %sp%s pull · %ss%s switch · %sr%s refresh · %sq%s quit%s\n",
-           C(COL_BOLD), C(COL_RESET), C(COL_BOLD), C(COL_RESET),
-           C(COL_BOLD), C(COL_RESET), C(COL_BOLD), C(COL_RESET),
-           C(COL_BOLD), C(COL_RESET), EOL());
+static void print_footer(Frame *f, const char *abs_dir, int interval_sec, const char *note) {
+    frame_printf(f, "%s\n", EOL());   /* blank separator line (cleared) */
+    frame_printf(f, "  %sf%s fetch · %sp%s pull · %ss%s switch · %sr%s refresh · %sq%s quit%s\n",
+                    C(COL_BOLD), C(COL_RESET), C(COL_BOLD), C(COL_RESET),
+                    C(COL_BOLD), C(COL_RESET), C(COL_BOLD), C(COL_RESET),
+                    C(COL_BOLD), C(COL_RESET), EOL());
     int tw = term_width();
-    const char *dir = (tw > 0) ? ellipsize(abs_dir, tw - 18) : abs_dir;
-    printf("  %sinterval %ds · %s", C(COL_DIM), interval_sec, dir);
+    char dir_buf[PATH_MAX + 8];
+    const char *dir = (tw > 0) ? ellipsize(abs_dir, tw - 18, dir_buf, sizeof(dir_buf)) : abs_dir;
+    frame_printf(f, "  %sinterval %ds · %s", C(COL_DIM), interval_sec, dir);
     if (note && note[0])
-        printf(" · %s", note);
-    printf("%s%s\n", C(COL_RESET), EOL());
+        frame_printf(f, " · %s", note);
+    frame_printf(f, "%s%s\n", C(COL_RESET), EOL());
 }
 
 /* ── Public entry point ────────────────────────────────────────────────────── */
@@ -291,6 +319,7 @@ void run_watch(const char *abs_dir) {
     write_seq(ALT_SCREEN_ON);
     write_seq(CURSOR_HIDE);
     enter_raw_mode();
+    frame_init(&g_frame, 0);
 
     /* pending action applied on the next scan: 0 = plain refresh, else a key */
     int  action = 0;
@@ -321,37 +350,66 @@ void run_watch(const char *abs_dir) {
             const char *verb = action == 'f' ? "Fetching"
                              : action == 'p' ? "Pulling"
                              :                 "Switching";
-            printf("\r" CLEAR_TO_END);                            /* clear any picker */
-            printf("  %s%s…%s", C(COL_DIM), verb, C(COL_RESET));  /* no-color fallback */
-            fflush(stdout);
+            frame_puts(&g_frame, "\r" CLEAR_TO_END);                           /* clear any picker */
+            frame_printf(&g_frame, "  %s%s…%s", C(COL_DIM), verb, C(COL_RESET)); /* no-color fallback */
+            frame_flush(&g_frame);
 
             if (action == 's')
                 snprintf(spinmsg, sizeof(spinmsg), "%s%s%s to %s%s%s",
                          C(COL_BOLD), verb, C(COL_RESET),
                          C(COL_CYAN), branch, C(COL_RESET));
             else
-                snprintf(spinmsg, sizeof(spinmsg), "%s%s%s all repos",
-                         C(COL_BOLD), verb, C(COL_RESET));
+                snprintf(spinmsg, sizeof(spinmsg), "%s%s%s all repos  %sc cancel%s",
+                         C(COL_BOLD), verb, C(COL_RESET), C(COL_DIM), C(COL_RESET));
             spinner_start(spinmsg);   /* overwrites the fallback line via '\r' */
             spinning = true;
         }
 
+        /* only the network actions can be cancelled from the keyboard */
+        pthread_t keys;
+        bool watching_keys = false;
+        if (action == 'f' || action == 'p') {
+            netexec_cancel_reset();
+            atomic_store(&g_keys_done, false);
+            watching_keys = pthread_create(&keys, NULL, cancel_key_thread, NULL) == 0;
+        }
+
         find_repos(abs_dir, 0);
         process_all_repos(abs_dir);
+        if (watching_keys) {
+            atomic_store(&g_keys_done, true);
+            pthread_join(keys, NULL);
+        }
         if (spinning) spinner_stop();
+        if ((action == 'f' || action == 'p') && netexec_cancelled()) {
+            snprintf(note, sizeof(note), "%s cancelled", action == 'f' ? "fetch" : "pull");
+            netexec_cancel_reset();
+        } else if (action == 'f' || action == 'p') {
+            size_t fresh = 0, down = 0;  /* not fetched: say so, or `f` looks broken */
+            for (size_t i = 0; i < g_repo_count; i++) {
+                fresh += g_repos[i].fetch_result == FR_FRESH;
+                down  += g_repos[i].fetch_result == FR_HOST_DOWN;
+            }
+            size_t len = strlen(note);
+            if (fresh) snprintf(note + len, sizeof(note) - len, " (%zu fresh)", fresh);
+            len = strlen(note);
+            if (down) snprintf(note + len, sizeof(note) - len, " (%zu host down)", down);
+        }
 
         ColWidths w = compute_col_widths();
 
         /* redraw in place: home, draw (each line cleared to its end via EOL so
          * a narrower frame leaves no stale columns), then clear leftover rows */
         int tw = term_width();
-        printf(CURSOR_HOME);
-        printf("%sScanned:%s %s%s\n%s\n", C(COL_BOLD), C(COL_RESET),
-               tw > 0 ? ellipsize(abs_dir, tw - 10) : abs_dir, EOL(), EOL());
-        print_status_table(&w, opt_dirty_only);
-        print_footer(abs_dir, opt_watch_interval, note);
-        printf(CLEAR_TO_END);
-        fflush(stdout);
+        char dir_buf[PATH_MAX + 8];
+        frame_puts(&g_frame, CURSOR_HOME);
+        frame_printf(&g_frame, "%sScanned:%s %s%s\n%s\n", C(COL_BOLD), C(COL_RESET),
+                     tw > 0 ? ellipsize(abs_dir, tw - 10, dir_buf, sizeof(dir_buf)) : abs_dir,
+                     EOL(), EOL());
+        print_status_table(&g_frame, &w, opt_dirty_only);
+        print_footer(&g_frame, abs_dir, opt_watch_interval, note);
+        frame_puts(&g_frame, CLEAR_TO_END);
+        frame_flush(&g_frame);
 
         /* clear one-shot action state so it does not repeat on the next tick */
         opt_fetch = opt_pull = opt_switch = false;
@@ -389,6 +447,8 @@ void run_watch(const char *abs_dir) {
     }
 
     free_repo_collection();
+    drop_status_cache();
     free_recent_branches();
+    frame_free(&g_frame);
     restore_terminal();
 }
@@ -0,0 +1,395 @@
+/*
+ * width.c – display width of UTF-8 strings
+ *
+ * Every cell of the table is measured before it is printed, and paths run to
+ * a hundred bytes, so the common case -- plain ASCII, one column a byte -- is
+ * skipped over 32 bytes at a time with AVX2 or 16 with SSE2 (8 with a word
+ * test elsewhere). Anything else is decoded and looked up:
+ *
+ *   2 columns  East Asian Wide and Fullwidth (CJK, kana, Hangul syllables,
+ *              fullwidth forms, emoji) -- EastAsianWidth.txt W and F
+ *   0 columns  combining marks (Mn, Me), format characters (Cf) such as
+ *              zero-width space and joiner, Hangul medial vowels and finals
+ *   1 column   everything else
+ *
+ * which is what terminals do; counting code points, as before, put a CJK
+ * branch name one column per character short and broke the table's
+ * alignment. The tables are Unicode 14's, with the unassigned code points
+ * between two ranges of a kind folded into them.
+ *
+ * An invalid byte is one column, as a terminal shows U+FFFD for it; a
+ * sequence cut off by the end of the string is none.
+ *
+ * The kernel is picked once, by CPU; width_kernel_set() forces one, for the
+ * tests and benchmarks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "gitools.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define WIDTH_X86 1
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    uint32_t lo, hi;
+} Range;
+
+/* Mn, Me and Cf; Hangul Jamo medial vowels and finals (U+1160..U+11FF,
+ * U+D7B0..U+D7FF) join the preceding initial into one syllable */
+static const Range ZERO[] = {
+    { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF },
+    { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0600, 0x0605 },
+    { 0x0610, 0x061A }, { 0x061C, 0x061C }, { 0x064B, 0x065F }, { 0x0670, 0x0670 },
+    { 0x06D6, 0x06DD }, { 0x06DF, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED },
+    { 0x070F, 0x070F }, { 0x0711, 0x0711 }, { 0x0730, 0x074A }, { 0x07A6, 0x07B0 },
+    { 0x07EB, 0x07F3 }, { 0x07FD, 0x07FD }, { 0x0816, 0x0819 }, { 0x081B, 0x0823 },
+    { 0x0825, 0x0827 }, { 0x0829, 0x082D }, { 0x0859, 0x085B }, { 0x0890, 0x089F },
+    { 0x08CA, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C }, { 0x0941, 0x0948 },
+    { 0x094D, 0x094D }, { 0x0951, 0x0957 }, { 0x0962, 0x0963 }, { 0x0981, 0x0981 },
+    { 0x09BC, 0x09BC }, { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 },
+    { 0x09FE, 0x0A02 }, { 0x0A3C, 0x0A3C }, { 0x0A41, 0x0A51 }, { 0x0A70, 0x0A71 },
+    { 0x0A75, 0x0A75 }, { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC }, { 0x0AC1, 0x0AC8 },
+    { 0x0ACD, 0x0ACD }, { 0x0AE2, 0x0AE3 }, { 0x0AFA, 0x0B01 }, { 0x0B3C, 0x0B3C },
+    { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B56 }, { 0x0B62, 0x0B63 },
+    { 0x0B82, 0x0B82 }, { 0x0BC0, 0x0BC0 }, { 0x0BCD, 0x0BCD }, { 0x0C00, 0x0C00 },
+    { 0x0C04, 0x0C04 }, { 0x0C3C, 0x0C3C }, { 0x0C3E, 0x0C40 }, { 0x0C46, 0x0C56 },
+    { 0x0C62, 0x0C63 }, { 0x0C81, 0x0C81 }, { 0x0CBC, 0x0CBC }, { 0x0CBF, 0x0CBF },
+    { 0x0CC6, 0x0CC6 }, { 0x0CCC, 0x0CCD }, { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 },
+    { 0x0D3B, 0x0D3C }, { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D }, { 0x0D62, 0x0D63 },
+    { 0x0D81, 0x0D81 }, { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD6 }, { 0x0E31, 0x0E31 },
+    { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E }, { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC },
+    { 0x0EC8, 0x0ECD }, { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 }, { 0x0F37, 0x0F37 },
+    { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E }, { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 },
+    { 0x0F8D, 0x0FBC }, { 0x0FC6, 0x0FC6 }, { 0x102D, 0x1030 }, { 0x1032, 0x1037 },
+    { 0x1039, 0x103A }, { 0x103D, 0x103E }, { 0x1058, 0x1059 }, { 0x105E, 0x1060 },
+    { 0x1071, 0x1074 }, { 0x1082, 0x1082 }, { 0x1085, 0x1086 }, { 0x108D, 0x108D },
+    { 0x109D, 0x109D }, { 0x1160, 0x11FF }, { 0x135D, 0x135F }, { 0x1712, 0x1714 },
+    { 0x1732, 0x1733 }, { 0x1752, 0x1753 }, { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 },
+    { 0x17B7, 0x17BD }, { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 }, { 0x17DD, 0x17DD },
+    { 0x180B, 0x180F }, { 0x1885, 0x1886 }, { 0x18A9, 0x18A9 }, { 0x1920, 0x1922 },
+    { 0x1927, 0x1928 }, { 0x1932, 0x1932 }, { 0x1939, 0x193B }, { 0x1A17, 0x1A18 },
+    { 0x1A1B, 0x1A1B }, { 0x1A56, 0x1A56 }, { 0x1A58, 0x1A60 }, { 0x1A62, 0x1A62 },
+    { 0x1A65, 0x1A6C }, { 0x1A73, 0x1A7F }, { 0x1AB0, 0x1B03 }, { 0x1B34, 0x1B34 },
+    { 0x1B36, 0x1B3A }, { 0x1B3C, 0x1B3C }, { 0x1B42, 0x1B42 }, { 0x1B6B, 0x1B73 },
+    { 0x1B80, 0x1B81 }, { 0x1BA2, 0x1BA5 }, { 0x1BA8, 0x1BA9 }, { 0x1BAB, 0x1BAD },
+    { 0x1BE6, 0x1BE6 }, { 0x1BE8, 0x1BE9 }, { 0x1BED, 0x1BED }, { 0x1BEF, 0x1BF1 },
+    { 0x1C2C, 0x1C33 }, { 0x1C36, 0x1C37 }, { 0x1CD0, 0x1CD2 }, { 0x1CD4, 0x1CE0 },
+    { 0x1CE2, 0x1CE8 }, { 0x1CED, 0x1CED }, { 0x1CF4, 0x1CF4 }, { 0x1CF8, 0x1CF9 },
+    { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F }, { 0x202A, 0x202E }, { 0x2060, 0x206F },
+    { 0x20D0, 0x20F0 }, { 0x2CEF, 0x2CF1 }, { 0x2D7F, 0x2D7F }, { 0x2DE0, 0x2DFF },
+    { 0x302A, 0x302D }, { 0x3099, 0x309A }, { 0xA66F, 0xA672 }, { 0xA674, 0xA67D },
+    { 0xA69E, 0xA69F }, { 0xA6F0, 0xA6F1 }, { 0xA802, 0xA802 }, { 0xA806, 0xA806 },
+    { 0xA80B, 0xA80B }, { 0xA825, 0xA826 }, { 0xA82C, 0xA82C }, { 0xA8C4, 0xA8C5 },
+    { 0xA8E0, 0xA8F1 }, { 0xA8FF, 0xA8FF }, { 0xA926, 0xA92D }, { 0xA947, 0xA951 },
+    { 0xA980, 0xA982 }, { 0xA9B3, 0xA9B3 }, { 0xA9B6, 0xA9B9 }, { 0xA9BC, 0xA9BD },
+    { 0xA9E5, 0xA9E5 }, { 0xAA29, 0xAA2E }, { 0xAA31, 0xAA32 }, { 0xAA35, 0xAA36 },
+    { 0xAA43, 0xAA43 }, { 0xAA4C, 0xAA4C }, { 0xAA7C, 0xAA7C }, { 0xAAB0, 0xAAB0 },
+    { 0xAAB2, 0xAAB4 }, { 0xAAB7, 0xAAB8 }, { 0xAABE, 0xAABF }, { 0xAAC1, 0xAAC1 },
+    { 0xAAEC, 0xAAED }, { 0xAAF6, 0xAAF6 }, { 0xABE5, 0xABE5 }, { 0xABE8, 0xABE8 },
+    { 0xABED, 0xABED }, { 0xD7B0, 0xD7FF }, { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F },
+    { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF }, { 0xFFF9, 0xFFFB }, { 0x101FD, 0x101FD },
+    { 0x102E0, 0x102E0 }, { 0x10376, 0x1037A }, { 0x10A01, 0x10A0F },
+    { 0x10A38, 0x10A3F }, { 0x10AE5, 0x10AE6 }, { 0x10D24, 0x10D27 },
+    { 0x10EAB, 0x10EAC }, { 0x10F46, 0x10F50 }, { 0x10F82, 0x10F85 },
+    { 0x11001, 0x11001 }, { 0x11038, 0x11046 }, { 0x11070, 0x11070 },
+    { 0x11073, 0x11074 }, { 0x1107F, 0x11081 }, { 0x110B3, 0x110B6 },
+    { 0x110B9, 0x110BA }, { 0x110BD, 0x110BD }, { 0x110C2, 0x110CD },
+    { 0x11100, 0x11102 }, { 0x11127, 0x1112B }, { 0x1112D, 0x11134 },
+    { 0x11173, 0x11173 }, { 0x11180, 0x11181 }, { 0x111B6, 0x111BE },
+    { 0x111C9, 0x111CC }, { 0x111CF, 0x111CF }, { 0x1122F, 0x11231 },
+    { 0x11234, 0x11234 }, { 0x11236, 0x11237 }, { 0x1123E, 0x1123E },
+    { 0x112DF, 0x112DF }, { 0x112E3, 0x112EA }, { 0x11300, 0x11301 },
+    { 0x1133B, 0x1133C }, { 0x11340, 0x11340 }, { 0x11366, 0x11374 },
+    { 0x11438, 0x1143F }, { 0x11442, 0x11444 }, { 0x11446, 0x11446 },
+    { 0x1145E, 0x1145E }, { 0x114B3, 0x114B8 }, { 0x114BA, 0x114BA },
+    { 0x114BF, 0x114C0 }, { 0x114C2, 0x114C3 }, { 0x115B2, 0x115B5 },
+    { 0x115BC, 0x115BD }, { 0x115BF, 0x115C0 }, { 0x115DC, 0x115DD },
+    { 0x11633, 0x1163A }, { 0x1163D, 0x1163D }, { 0x1163F, 0x11640 },
+    { 0x116AB, 0x116AB }, { 0x116AD, 0x116AD }, { 0x116B0, 0x116B5 },
+    { 0x116B7, 0x116B7 }, { 0x1171D, 0x1171F }, { 0x11722, 0x11725 },
+    { 0x11727, 0x1172B }, { 0x1182F, 0x11837 }, { 0x11839, 0x1183A },
+    { 0x1193B, 0x1193C }, { 0x1193E, 0x1193E }, { 0x11943, 0x11943 },
+    { 0x119D4, 0x119DB }, { 0x119E0, 0x119E0 }, { 0x11A01, 0x11A0A },
+    { 0x11A33, 0x11A38 }, { 0x11A3B, 0x11A3E }, { 0x11A47, 0x11A47 },
+    { 0x11A51, 0x11A56 }, { 0x11A59, 0x11A5B }, { 0x11A8A, 0x11A96 },
+    { 0x11A98, 0x11A99 }, { 0x11C30, 0x11C3D }, { 0x11C3F, 0x11C3F },
+    { 0x11C92, 0x11CA7 }, { 0x11CAA, 0x11CB0 }, { 0x11CB2, 0x11CB3 },
+    { 0x11CB5, 0x11CB6 }, { 0x11D31, 0x11D45 }, { 0x11D47, 0x11D47 },
+    { 0x11D90, 0x11D91 }, { 0x11D95, 0x11D95 }, { 0x11D97, 0x11D97 },
+    { 0x11EF3, 0x11EF4 }, { 0x13430, 0x13438 }, { 0x16AF0, 0x16AF4 },
+    { 0x16B30, 0x16B36 }, { 0x16F4F, 0x16F4F }, { 0x16F8F, 0x16F92 },
+    { 0x16FE4, 0x16FE4 }, { 0x1BC9D, 0x1BC9E }, { 0x1BCA0, 0x1CF46 },
+    { 0x1D167, 0x1D169 }, { 0x1D173, 0x1D182 }, { 0x1D185, 0x1D18B },
+    { 0x1D1AA, 0x1D1AD }, { 0x1D242, 0x1D244 }, { 0x1DA00, 0x1DA36 },
+    { 0x1DA3B, 0x1DA6C }, { 0x1DA75, 0x1DA75 }, { 0x1DA84, 0x1DA84 },
+    { 0x1DA9B, 0x1DAAF }, { 0x1E000, 0x1E02A }, { 0x1E130, 0x1E136 },
+    { 0x1E2AE, 0x1E2AE }, { 0x1E2EC, 0x1E2EF }, { 0x1E8D0, 0x1E8D6 },
+    { 0x1E944, 0x1E94A }, { 0xE0001, 0xE01EF },
+};
+
+/* East Asian Wide (W) and Fullwidth (F) */
+static const Range WIDE[] = {
+    { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC },
+    { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 },
+    { 0x2648, 0x2653 }, { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+    { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 }, { 0x26CE, 0x26CE },
+    { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+    { 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+    { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 },
+    { 0x2757, 0x2757 }, { 0x2795, 0x2797 }, { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF },
+    { 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x3029 },
+    { 0x302E, 0x303E }, { 0x3041, 0x3096 }, { 0x309B, 0x3247 }, { 0x3250, 0x4DBF },
+    { 0x4E00, 0xA4C6 }, { 0xA960, 0xA97C }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAD9 },
+    { 0xFE10, 0xFE19 }, { 0xFE30, 0xFE6B }, { 0xFF01, 0xFF60 }, { 0xFFE0, 0xFFE6 },
+    { 0x16FE0, 0x16FE3 }, { 0x16FF0, 0x1B2FB }, { 0x1F004, 0x1F004 },
+    { 0x1F0CF, 0x1F0CF }, { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A },
+    { 0x1F200, 0x1F320 }, { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C },
+    { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA }, { 0x1F3CF, 0x1F3D3 },
+    { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E },
+    { 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D },
+    { 0x1F54B, 0x1F54E }, { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A },
+    { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 }, { 0x1F5FB, 0x1F64F },
+    { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 },
+    { 0x1F6D5, 0x1F6DF }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC },
+    { 0x1F7E0, 0x1F7F0 }, { 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 },
+    { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAF6 }, { 0x20000, 0x3FFFD },
+};
+
+#define NRANGES(t) (sizeof(t) / sizeof(*(t)))
+
+static bool in_table(uint32_t cp, const Range *t, size_t n) {
+    if (cp < t[0].lo || cp > t[n - 1].hi) return false;
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if      (cp > t[mid].hi) lo = mid + 1;
+        else if (cp < t[mid].lo) hi = mid;
+        else return true;
+    }
+    return false;
+}
+
+/* Columns of one code point. */
+static int cp_width(uint32_t cp) {
+    if (cp < 0x300) return 1;                   /* Latin, before the first mark */
+    if (cp <= 0x36F) return 0;                  /* combining diacritics */
+    /* the blocks East Asian names are written in, without searching */
+    if ((cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7A3)
+            || (cp >= 0x3041 && cp <= 0x3096) || (cp >= 0x30A1 && cp <= 0x30FA)) return 2;
+    if (in_table(cp, ZERO, NRANGES(ZERO))) return 0;
+    if (in_table(cp, WIDE, NRANGES(WIDE))) return 2;
+    return 1;
+}
+
+/*
+ * Decode the character at p (n > 0 bytes left, p[0] >= 0x80). Returns its
+ * length, or 0 if the string ends inside it; an invalid byte decodes as a
+ * 1-byte U+FFFD.
+ */
+static size_t decode(const unsigned char *p, size_t n, uint32_t *cp) {
+    size_t len;
+    uint32_t c;
+    if      (p[0] >= 0xC2 && p[0] <= 0xDF) { len = 2; c = p[0] & 0x1F; }
+    else if (p[0] >= 0xE0 && p[0] <= 0xEF) { len = 3; c = p[0] & 0x0F; }
+    else if (p[0] >= 0xF0 && p[0] <= 0xF4) { len = 4; c = p[0] & 0x07; }
+    else { *cp = 0xFFFD; return 1; }
+    for (size_t k = 1; k < len; k++) {
+        if (k >= n) return 0;
+        if ((p[k] & 0xC0) != 0x80) { *cp = 0xFFFD; return 1; }
+        c = (c << 6) | (p[k] & 0x3F);
+    }
+    *cp = c;
+    return len;
+}
+
+/* ── ASCII run kernels ─────────────────────────────────────────────────────── */
+/* Each returns how many of the n bytes at p are ASCII before the first that
+ * is not. The last block is loaded overlapping the one before it rather than
+ * finished a byte at a time; the bytes it repeats are known to be ASCII. */
+static size_t ascii_run_swar(const unsigned char *p, size_t n) {
+    if (n < 8) {
+        size_t i = 0;
+        while (i < n && p[i] < 0x80) i++;
+        return i;
+    }
+    for (size_t i = 0;; i += 8) {
+        if (i + 8 > n) i = n - 8;
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        if (v & 0x8080808080808080ULL) {
+            while (p[i] < 0x80) i++;
+            return i;
+        }
+        if (i + 8 == n) return n;
+    }
+}
+
+#ifdef WIDTH_X86
+static size_t ascii_run_sse2(const unsigned char *p, size_t n) {
+    if (n < 16) return ascii_run_swar(p, n);
+    for (size_t i = 0;; i += 16) {
+        if (i + 16 > n) i = n - 16;
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(p + i)));
+        if (m) return i + (size_t)__builtin_ctz(m);
+        if (i + 16 == n) return n;
+    }
+}
+
+__attribute__((target("avx2")))
+static size_t ascii_run_avx2(const unsigned char *p, size_t n) {
+    if (n < 32) return ascii_run_sse2(p, n);
+    for (size_t i = 0;; i += 32) {
+        if (i + 32 > n) i = n - 32;
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(p + i)));
+        if (m) return i + (size_t)__builtin_ctz(m);
+        if (i + 32 == n) return n;
+    }
+}
+#endif
+
+typedef size_t (*AsciiRun)(const unsigned char *, size_t);
+
+static size_t ascii_run_first(const unsigned char *p, size_t n);
+
+/* read on every measure, so atomic rather than behind pthread_once */
+static _Atomic(AsciiRun) g_run    = ascii_run_first;
+static WidthKernel       g_kernel = WIDTH_SWAR;
+static pthread_once_t    g_picked = PTHREAD_ONCE_INIT;
+
+static void pick_kernel(void) {
+    AsciiRun run = ascii_run_swar;
+    g_kernel = WIDTH_SWAR;
+#ifdef WIDTH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        run      = ascii_run_avx2;
+        g_kernel = WIDTH_AVX2;
+    } else {
+        run      = ascii_run_sse2;
+        g_kernel = WIDTH_SSE2;
+    }
+#endif
+    atomic_store_explicit(&g_run, run, memory_order_relaxed);
+}
+
+/* The first measure picks the kernel. */
+static size_t ascii_run_first(const unsigned char *p, size_t n) {
+    pthread_once(&g_picked, pick_kernel);
+    return atomic_load_explicit(&g_run, memory_order_relaxed)(p, n);
+}
+
+/* Use kernel k from now on (WIDTH_AUTO: the best this CPU has). False if
+ * this build or CPU lacks it. Not while other threads are measuring. */
+bool width_kernel_set(WidthKernel k) {
+    pthread_once(&g_picked, pick_kernel);
+    AsciiRun run;
+    switch (k) {
+        case WIDTH_AUTO:
+            pick_kernel();
+            return true;
+        case WIDTH_SWAR:
+            run = ascii_run_swar;
+            break;
+#ifdef WIDTH_X86
+        case WIDTH_SSE2:
+            run = ascii_run_sse2;
+            break;
+        case WIDTH_AVX2:
+            if (!__builtin_cpu_supports("avx2")) return false;
+            run = ascii_run_avx2;
+            break;
+#endif
+        default:
+            return false;
+    }
+    atomic_store_explicit(&g_run, run, memory_order_relaxed);
+    g_kernel = k;
+    return true;
+}
+
+WidthKernel width_kernel(void) {
+    pthread_once(&g_picked, pick_kernel);
+    return g_kernel;
+}
+
+/* ── Measuring ─────────────────────────────────────────────────────────────── */
+/*
+ * Width of the longest prefix of the n bytes at s that is at most max_w
+ * columns wide; its length goes to *used. Zero-width characters right after
+ * it are part of it.
+ */
+static int measure(const unsigned char *s, size_t n, int max_w, size_t *used) {
+    AsciiRun ascii_run = atomic_load_explicit(&g_run, memory_order_relaxed);
+    size_t i = 0;
+    int w = 0;
+    while (i < n) {
+        if (s[i] < 0x80) {
+            size_t room = (size_t)(max_w - w);
+            size_t lim = n - i < room ? n - i : room;
+            if (lim == 0) break;
+            size_t run = 0;
+            if (lim >= 16)                      /* a kernel call pays off from here */
+                run = ascii_run(s + i, lim);
+            else
+                while (run < lim && s[i + run] < 0x80) run++;
+            i += run;
+            w += (int)run;
+            continue;
+        }
+        uint32_t cp;
+        size_t len = decode(s + i, n - i, &cp);
+        if (len == 0) {                         /* cut off: counts for nothing */
+            i = n;
+            break;
+        }
+        int cw = cp_width(cp);
+        if (w + cw > max_w) break;
+        w += cw;
+        i += len;
+    }
+    *used = i;
+    return w;
+}
+
+int utf8_width(const char *s) {
+    const unsigned char *p = (const unsigned char *)s;
+    size_t n = strlen(s);
+    size_t run = atomic_load_explicit(&g_run, memory_order_relaxed)(p, n);
+    if (run == n) return (int)n;                /* the usual case: all ASCII */
+    size_t used;
+    return (int)run + measure(p + run, n - run, INT_MAX, &used);
+}
+
+/* Byte length of the longest prefix of s at most max_w columns wide; its
+ * width goes to *width unless NULL. */
+size_t utf8_byte_len_for_width(const char *s, int max_w, int *width) {
+    size_t used = 0;
+    int w = max_w < 0 ? 0 : measure((const unsigned char *)s, strlen(s), max_w, &used);
+    if (width) *width = w;
+    return used;
+}
+
+/* Byte length of the shortest prefix of s at least cols wide, and the
+ * zero-width characters after it: what to drop to take cols off the front. */
+size_t utf8_skip_width(const char *s, int cols) {
+    if (cols <= 0) return 0;
+    const unsigned char *p = (const unsigned char *)s;
+    size_t n = strlen(s), used;
+    measure(p, n, cols - 1, &used);
+    if (used >= n) return n;
+    uint32_t cp;
+    size_t len = p[used] < 0x80 ? 1 : decode(p + used, n - used, &cp);
+    if (len == 0) return n;
+    used += len;
+    size_t marks;
+    measure(p + used, n - used, 0, &marks);
+    return used + marks;
+}